@@ -0,0 +1,1261 @@
+/*****************************************************************************\
+*                                                                             *
+*  FILENAME:     bench_times.c                                                *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  DESCRIPTION:  benchmark of time functions                                  *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  COPYRIGHT:    (c) 2026 Dipl.-Ing. Klaus Lux (Aachen, Germany)              *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  ORIGIN:       https://github.com/klux21/limitless_times                    *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+* Civil Usage Public License, Version 1.2, June 2026                          *
+*                                                                             *
+* Redistribution and use in source and binary forms, with or without          *
+* modification, are permitted provided that the following conditions are met: *
+*                                                                             *
+* 1. Redistributions of source code must retain the above copyright           *
+*    notice, this list of conditions, the explanation of terms                *
+*    and the following disclaimer.                                            *
+*                                                                             *
+* 2. Redistributions in binary form must reproduce the above copyright        *
+*    notice, this list of conditions and the following disclaimer in the      *
+*    documentation or other materials provided with the distribution.         *
+*                                                                             *
+* 3. All modified files must carry prominent notices stating that the         *
+*    files have been changed.                                                 *
+*                                                                             *
+* 4. The source code and binary forms and any derivative works are not        *
+*    stored or executed in systems or devices which are designed or           *
+*    intended to harm, to kill or to forcibly immobilize people.              *
+*                                                                             *
+* 5. The source code and binary forms and any derivative works are not        *
+*    stored or executed in systems or devices which are intended to           *
+*    monitor, to track, to change or to control the behavior, the             *
+*    constitution, the location or the communication of any people or         *
+*    their property without the explicit and prior agreement of those         *
+*    people except those devices and systems are solely designed for          *
+*    saving or protecting peoples life or health.                             *
+*                                                                             *
+* 6. The source code and binary forms and any derivative works are not        *
+*    stored or executed in any systems or devices that are intended           *
+*    for the production of any of the systems or devices that                 *
+*    have been stated before except the ones for saving or protecting         *
+*    peoples life or health only.                                             *
+*                                                                             *
+* The term 'systems' in all clauses shall include all types and combinations  *
+* of physical, virtualized or simulated hardware and software and any kind    *
+* of data storage.                                                            *
+*                                                                             *
+* The term 'devices' shall include any kind of local or non-local control     *
+* system of the stated devices as part of that device as well. Any assembly   *
+* of more than one device is one and the same device regarding this license.  *
+*                                                                             *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" *
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE   *
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE  *
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE   *
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR         *
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF        *
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    *
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     *
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)     *
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE  *
+* POSSIBILITY OF SUCH DAMAGE.                                                 *
+*                                                                             *
+\*****************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h> /* memset */
+#include <errno.h>
+#include <inttypes.h>
+#include <stddef.h>
+#include <time.h>      /* struct tm */
+#include <sys/types.h>
+
+#ifdef _WIN32
+#include <winsock2.h>  /* required for timeval struct */
+#include <WS2tcpip.h>  /* for IPv6 related stuff */
+#include <windows.h>
+#include <winbase.h>
+
+#pragma warning(disable : 4204)
+#endif /* _WIN32 */
+
+#if defined (__linux__) && !defined (BENCH_NO_PERF)
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#define BENCH_PERF 1 /* hardware counters are read by perf_event_open */
+#endif
+
+#include <time_api.h>
+#include <tz_value.h>
+
+
+#define BENCH_SAMPLES  0x4000  /* number of timestamps of every distribution */
+#define BENCH_ROUNDS   4       /* loops over the samples of a single measurement */
+#define BENCH_PASSES   61      /* passes over all functions, the median of the measurements is reported */
+#define BENCH_REF_BOUNDS 512   /* bounds of the binary search of the reference work */
+#define BENCH_REF_CYCLE  ((int64_t) 146097 * 86400) /* seconds of a 400 year epoch */
+
+
+/* ------------------------------------------------------------------------- *\
+   The year distributions of the timestamps that are fed into the functions.
+   The branches in the century and leap year cascades of the conversions
+   depend a lot on the input and a single fixed date hides that.
+\* ------------------------------------------------------------------------- */
+
+typedef struct BENCH_DIST_S BENCH_DIST;
+struct BENCH_DIST_S
+{
+   const char * name;       /* name of the distribution in the report */
+   int32_t      first_year; /* first year of the uniform distributed timestamps */
+   int32_t      last_year;  /* last year of the uniform distributed timestamps */
+   int          sorted;     /* nonzero for ascending timestamps instead of shuffled ones */
+};
+
+static const BENCH_DIST bench_dists[] =
+{
+   { "current_era",     2000,   2050, 0 },
+   { "uniform_1900",    1900,   2100, 0 },
+   { "sorted_1900",     1900,   2100, 1 },
+   { "deep_history", -20500, -19500, 0 },
+   { "far_future",    19500,  20500, 0 },
+   { NULL,                0,      0, 0 }
+};
+
+
+static time64_t       bench_time[BENCH_SAMPLES];  /* input of new_gmtime_r and localtime_of_zone */
+static struct tm      bench_utc[BENCH_SAMPLES];   /* input of new_timegm */
+static struct tm      bench_local[BENCH_SAMPLES]; /* input of mktime_of_zone */
+static time64_t       bench_result_time[BENCH_SAMPLES]; /* output of the array functions */
+static uint8_t        bench_err[BENCH_SAMPLES / 8];      /* error bits of the array functions */
+static int32_t        bench_col_year[BENCH_SAMPLES];     /* columns of localtime_columns_of_zone */
+static int8_t         bench_col_mon[BENCH_SAMPLES];
+static int8_t         bench_col_mday[BENCH_SAMPLES];
+static int8_t         bench_col_hour[BENCH_SAMPLES];
+static int8_t         bench_col_min[BENCH_SAMPLES];
+static int8_t         bench_col_sec[BENCH_SAMPLES];
+static TIME_DIFF      bench_diff[BENCH_SAMPLES];         /* output of diff_time_array_of_zone */
+static TIME_ZONE_INFO bench_zone;                 /* time zone of localtime_of_zone and mktime_of_zone */
+static TIME_ZONE_INFO bench_zones[256];            /* registry of localtime_columns_of_zone_ids with copies of bench_zone */
+static uint16_t       bench_zone_id[BENCH_SAMPLES]; /* random zone ids of the registry */
+static char           bench_text[BENCH_SAMPLES * 24]; /* UTC times of the layout YYYY-MM-DDThh:mm:ss.fffZ */
+static int32_t        bench_nsec[BENCH_SAMPLES];  /* nanoseconds of parse_times_of_layout */
+static char           bench_syslog[BENCH_SAMPLES * 16]; /* local times of the syslog format "Oct 17 04:01:02" */
+static char           bench_zoned[BENCH_SAMPLES * 64];  /* UTC times with RFC 9557 zone suffixes */
+static const char *   bench_zone_names[4] = { "Europe/Paris", "America/New_York", "Asia/Tokyo", "Australia/Sydney" }; /* zones of bench_zoned */
+static volatile int64_t bench_sink;               /* keeps the compiler from dropping the results */
+static struct tm      bench_ref_tm[BENCH_SAMPLES]; /* output of run_reference */
+static int64_t        bench_ref_bound[BENCH_REF_BOUNDS]; /* searched bounds of run_reference */
+
+
+/* ------------------------------------------------------------------------- *\
+   bench_random is a tiny xorshift generator that gives us the same samples
+   in every run and in every system.
+\* ------------------------------------------------------------------------- */
+
+static uint64_t bench_seed = 0x2545f4914f6cdd1dull;
+
+static uint64_t bench_random()
+{
+   bench_seed ^= bench_seed >> 12;
+   bench_seed ^= bench_seed << 25;
+   bench_seed ^= bench_seed >> 27;
+   return (bench_seed * 0x2545f4914f6cdd1dull);
+} /* uint64_t bench_random() */
+
+
+/* ------------------------------------------------------------------------- *\
+   compare_time64 is the compare function of qsort for sorted distributions
+\* ------------------------------------------------------------------------- */
+
+static int compare_time64(const void * pa, const void * pb)
+{
+   time64_t a = *(const time64_t *) pa;
+   time64_t b = *(const time64_t *) pb;
+
+   return ((a > b) - (a < b));
+} /* int compare_time64(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   init_samples fills the sample arrays with uniform distributed timestamps
+   of the years of the given distribution and the related UTC and local
+   broken-down times. The samples of a distribution are the same in every
+   pass over the functions.
+\* ------------------------------------------------------------------------- */
+
+static int init_samples(const BENCH_DIST * pd)
+{
+   int       bRet = 0;
+   struct tm stm;
+   time64_t  first;
+   uint64_t  span;
+   size_t    i;
+
+   bench_seed = 0x2545f4914f6cdd1dull + (uint64_t) (int64_t) pd->first_year;
+
+   memset(&stm, 0, sizeof(stm));
+   stm.tm_mday = 1;
+   stm.tm_year = pd->first_year - 1900;
+   first = new_timegm(&stm);
+   stm.tm_year = pd->last_year + 1 - 1900;
+   span  = (uint64_t) (new_timegm(&stm) - first);
+
+   for(i = 0; i < BENCH_SAMPLES; ++i)
+      bench_time[i] = first + (time64_t) (bench_random() % span);
+
+   if(pd->sorted)
+      qsort(bench_time, BENCH_SAMPLES, sizeof(bench_time[0]), compare_time64);
+
+   for(i = 0; i < BENCH_SAMPLES; ++i)
+   {
+      if(!new_gmtime_r(bench_time[i], &bench_utc[i]) || !localtime_of_zone(bench_time[i], &bench_local[i], &bench_zone))
+      {
+         fprintf(stderr, "Initialization of the samples of '%s' has failed for time %lld!\n", pd->name, (long long) bench_time[i]);
+         goto Exit;
+      }
+
+      bench_local[i].tm_isdst = -1; /* let mktime_of_zone evaluate the daylight saving rules */
+   }
+
+   for(i = 0; i < BENCH_SAMPLES; ++i)
+   { /* the years of the text are folded into 0 .. 9999 */
+      char buf[80];
+
+      sprintf(buf, "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ", ((bench_utc[i].tm_year + 1900) % 10000 + 10000) % 10000,
+              bench_utc[i].tm_mon + 1, bench_utc[i].tm_mday, bench_utc[i].tm_hour, bench_utc[i].tm_min, bench_utc[i].tm_sec, (int) (i % 1000));
+      memcpy(bench_text + (i * 24), buf, 24);
+
+      strftime(buf, sizeof(buf), "%b %d %H:%M:%S", &bench_local[i]);
+      memcpy(bench_syslog + (i * 16), buf, 16);
+
+      format_time_of_zone_ns(bench_time[i] % 9000000000 * 1000000000, 3, buf, sizeof(buf), NULL);
+      sprintf(bench_zoned + (i * 64), "%s[%s]", buf, bench_zone_names[i % 4]);
+   }
+
+   bRet = 1;
+   Exit:;
+   return (bRet);
+} /* int init_samples(const BENCH_DIST * pd) */
+
+
+/* ------------------------------------------------------------------------- *\
+   run_reference is the reference work of the regression gate. It is a
+   frozen plain conversion of the samples into broken-down times with a
+   binary search in a table of 512 bounds as the zone lookups have it.
+   It doesn't call the time API, so its speed depends on the state of the
+   machine at the time of the measurement only. The cost of every function
+   is taken relative to it, and since it loads, branches and stores like
+   the time API, the load of a shared machine slows down both alike.
+\* ------------------------------------------------------------------------- */
+
+static int64_t run_reference()
+{
+   int64_t sum = 0;
+   size_t  i;
+
+   for(i = 0; i < BENCH_SAMPLES; ++i)
+   {
+      struct tm * ptm  = &bench_ref_tm[i];
+      int64_t     days = bench_time[i] / 86400;
+      int64_t     secs = bench_time[i] % 86400;
+      int64_t     era, doe, yoe, doy, mp;
+      int64_t     key  = bench_time[i] % BENCH_REF_CYCLE; /* time in the 400 year epoch */
+      size_t      lo   = 0;
+      size_t      hi   = BENCH_REF_BOUNDS;
+
+      if(key < 0)
+         key += BENCH_REF_CYCLE;
+
+      while(lo < hi)
+      {
+         size_t mid = (lo + hi) / 2;
+
+         if(bench_ref_bound[mid] <= key)
+            lo = mid + 1;
+         else
+            hi = mid;
+      }
+
+      if(secs < 0)
+      {
+         secs += 86400;
+         --days;
+      }
+
+      days += 719468; /* days since 0000-03-01 */
+      era   = ((days >= 0) ? days : days - 146096) / 146097;
+      doe   = days - era * 146097;
+      yoe   = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+      doy   = doe - (365 * yoe + yoe / 4 - yoe / 100);
+      mp    = (5 * doy + 2) / 153;
+
+      ptm->tm_mday  = (int) (doy - (153 * mp + 2) / 5 + 1);
+      ptm->tm_mon   = (int) ((mp < 10) ? mp + 2 : mp - 10);
+      ptm->tm_year  = (int) (yoe + era * 400 + (ptm->tm_mon <= 1) - 1900);
+      ptm->tm_hour  = (int) (secs / 3600);
+      ptm->tm_min   = (int) (secs / 60 % 60);
+      ptm->tm_sec   = (int) (secs % 60);
+      ptm->tm_isdst = (int) (lo & 1);
+
+      sum += ptm->tm_mday + ptm->tm_isdst;
+   }
+
+   return (sum);
+} /* int64_t run_reference() */
+
+
+/* ------------------------------------------------------------------------- *\
+   The measured functions. Every one loops once over all samples and
+   returns some checksum of the results.
+\* ------------------------------------------------------------------------- */
+
+static int64_t run_new_gmtime_r()
+{
+   int64_t   sum = 0;
+   struct tm stm;
+   size_t    i;
+
+   for(i = 0; i < BENCH_SAMPLES; ++i)
+   {
+      new_gmtime_r(bench_time[i], &stm);
+      sum += stm.tm_mday;
+   }
+   return (sum);
+} /* int64_t run_new_gmtime_r() */
+
+
+static int64_t run_new_timegm()
+{
+   int64_t sum = 0;
+   size_t  i;
+
+   for(i = 0; i < BENCH_SAMPLES; ++i)
+      sum += new_timegm(&bench_utc[i]);
+
+   return (sum);
+} /* int64_t run_new_timegm() */
+
+
+static int64_t run_localtime_of_zone()
+{
+   int64_t   sum = 0;
+   struct tm stm;
+   size_t    i;
+
+   for(i = 0; i < BENCH_SAMPLES; ++i)
+   {
+      localtime_of_zone(bench_time[i], &stm, &bench_zone);
+      sum += stm.tm_hour;
+   }
+   return (sum);
+} /* int64_t run_localtime_of_zone() */
+
+
+static int64_t run_mktime_of_zone()
+{
+   int64_t sum = 0;
+   size_t  i;
+
+   for(i = 0; i < BENCH_SAMPLES; ++i)
+      sum += mktime_of_zone(&bench_local[i], &bench_zone);
+
+   return (sum);
+} /* int64_t run_mktime_of_zone() */
+
+
+static int64_t run_new_timegm_array()
+{
+   return ((int64_t) new_timegm_array(bench_utc, bench_result_time, bench_err, BENCH_SAMPLES) + bench_result_time[BENCH_SAMPLES - 1]);
+} /* int64_t run_new_timegm_array() */
+
+
+static int64_t run_mktime_of_zone_array()
+{
+   return ((int64_t) mktime_of_zone_array(bench_local, bench_result_time, bench_err, BENCH_SAMPLES, &bench_zone) + bench_result_time[BENCH_SAMPLES - 1]);
+} /* int64_t run_mktime_of_zone_array() */
+
+
+static int64_t run_localtime_columns()
+{
+   TIME_COLUMNS cols;
+
+   memset(&cols, 0, sizeof(cols));
+   cols.year = bench_col_year;
+   cols.mon  = bench_col_mon;
+   cols.mday = bench_col_mday;
+   cols.hour = bench_col_hour;
+   cols.min  = bench_col_min;
+   cols.sec  = bench_col_sec;
+
+   return ((int64_t) localtime_columns_of_zone(bench_time, BENCH_SAMPLES, &cols, bench_err, &bench_zone) + bench_col_mday[BENCH_SAMPLES - 1]);
+} /* int64_t run_localtime_columns() */
+
+
+static int64_t run_trunc_day_array()
+{
+   return ((int64_t) trunc_time_array_of_zone(bench_time, bench_result_time, BENCH_SAMPLES, TIME_UNIT_DAY, &bench_zone) + bench_result_time[BENCH_SAMPLES - 1]);
+} /* int64_t run_trunc_day_array() */
+
+
+static int64_t run_day_boundaries()
+{
+   TIME_BOUNDARIES tb;
+
+   init_time_boundaries(&tb, bench_time[0], bench_time[0] + (time64_t) 86400 * 2 * BENCH_SAMPLES, TIME_UNIT_DAY, &bench_zone);
+
+   return ((int64_t) get_time_boundaries(&tb, bench_result_time, BENCH_SAMPLES) + bench_result_time[BENCH_SAMPLES - 1]);
+} /* int64_t run_day_boundaries() */
+
+
+static int64_t run_utc_offset_of_zone()
+{
+   int64_t sum = 0;
+   int32_t isdst;
+   size_t  i;
+
+   for(i = 0; i < BENCH_SAMPLES; ++i)
+      sum += utc_offset_of_zone(bench_time[i], &bench_zone, &isdst, NULL, NULL) + isdst;
+
+   return (sum);
+} /* int64_t run_utc_offset_of_zone() */
+
+
+static int64_t run_add_month_array()
+{
+   return ((int64_t) add_time_array_of_zone(bench_time, bench_result_time, bench_err, BENCH_SAMPLES, 0, 1, 0, TIME_LOCAL_COMPATIBLE, &bench_zone) + bench_result_time[BENCH_SAMPLES - 1]);
+} /* int64_t run_add_month_array() */
+
+
+static int64_t run_diff_time_array()
+{
+   diff_time_array_of_zone(bench_time, bench_time + 1, bench_diff, BENCH_SAMPLES - 1, TIME_UNIT_YEAR, &bench_zone);
+
+   return (bench_diff[BENCH_SAMPLES - 2].days);
+} /* int64_t run_diff_time_array() */
+
+
+static int64_t run_format_time_ns()
+{
+   char    buf[TIME_FORMAT_NS_SIZE];
+   int64_t sum = 0;
+   size_t  i;
+
+   /* the times of the distributions beyond the years 1677 until 2262 are folded into that range */
+   for(i = 0; i < BENCH_SAMPLES; ++i)
+      sum += (int64_t) format_time_of_zone_ns(bench_time[i] % 9000000000 * 1000000000 + (int64_t) i, 9, buf, sizeof(buf), &bench_zone) + buf[18];
+
+   return (sum);
+} /* int64_t run_format_time_ns() */
+
+
+static int64_t run_localtime_of_8_zones()
+{
+   const TIME_ZONE_INFO * pzones[8];
+   struct tm              tm[8];
+   int64_t                sum = 0;
+   size_t                 i;
+
+   for(i = 0; i < 8; ++i)
+      pzones[i] = &bench_zone;
+
+   for(i = 0; i < BENCH_SAMPLES; ++i)
+   {
+      localtime_of_zones(bench_time[i], pzones, 8, tm, NULL, NULL, NULL);
+      sum += tm[7].tm_hour;
+   }
+
+   return (sum);
+} /* int64_t run_localtime_of_8_zones() */
+
+
+static int64_t run_convert_time_of_zone()
+{
+   struct tm tm;
+   int64_t   sum = 0;
+   size_t    i;
+
+   for(i = 0; i < BENCH_SAMPLES; ++i)
+   {
+      sum += convert_time_of_zone(&bench_local[i], &bench_zone, TIME_LOCAL_COMPATIBLE, &tm, &bench_zone, NULL);
+      sum += tm.tm_hour;
+   }
+
+   return (sum);
+} /* int64_t run_convert_time_of_zone() */
+
+
+static int64_t run_zone_ids_columns()
+{
+   TIME_COLUMNS cols;
+
+   memset(&cols, 0, sizeof(cols));
+   cols.year = bench_col_year;
+   cols.mon  = bench_col_mon;
+   cols.mday = bench_col_mday;
+   cols.hour = bench_col_hour;
+   cols.min  = bench_col_min;
+   cols.sec  = bench_col_sec;
+
+   return ((int64_t) localtime_columns_of_zone_ids(bench_time, bench_zone_id, BENCH_SAMPLES, bench_zones, 256, &cols, bench_err) + bench_col_mday[BENCH_SAMPLES - 1]);
+} /* int64_t run_zone_ids_columns() */
+
+
+static int64_t run_parse_layout()
+{
+   return ((int64_t) parse_times_of_layout("YYYY-MM-DDThh:mm:ss.fffZ", bench_text, 24, BENCH_SAMPLES, bench_result_time, bench_nsec, bench_err)
+           + bench_result_time[BENCH_SAMPLES - 1]);
+} /* int64_t run_parse_layout() */
+
+
+static int64_t run_http_date()
+{
+   char     buf[TIME_HTTP_DATE_SIZE];
+   time64_t t;
+   int64_t  sum = 0;
+   size_t   i;
+
+   /* the times are folded into the years 1685 until 2255 as the ones of format_time_ns */
+   for(i = 0; i < BENCH_SAMPLES; ++i)
+   {
+      format_http_date(bench_time[i] % 9000000000, buf, sizeof(buf));
+      sum += (int64_t) parse_http_date(buf, sizeof(buf) - 1, &t) + t;
+   }
+
+   return (sum);
+} /* int64_t run_http_date() */
+
+
+static int64_t run_syslog_time()
+{
+   time64_t t;
+   int64_t  sum = 0;
+   size_t   i;
+
+   /* the samples are their own reference times */
+   for(i = 0; i < BENCH_SAMPLES; ++i)
+      sum += (int64_t) parse_syslog_time(bench_syslog + (i * 16), 15, bench_time[i], &t, NULL, &bench_zone) + t;
+
+   return (sum);
+} /* int64_t run_syslog_time() */
+
+
+static int64_t run_zoned_time()
+{
+   TIME_ZONE_CACHE * pcache = create_time_zone_cache(0, pc_find_TZ);
+   int64_t           ns;
+   int64_t           sum = 0;
+   size_t            i;
+
+   for(i = 0; i < BENCH_SAMPLES; ++i)
+      sum += (int64_t) parse_zoned_time_ns(bench_zoned + (i * 64), 64, &ns, NULL, pcache, NULL) + ns;
+
+   destroy_time_zone_cache(pcache);
+   return (sum);
+} /* int64_t run_zoned_time() */
+
+
+static int64_t run_week_date_array()
+{
+   return ((int64_t) week_date_array_of_zone(bench_time, BENCH_SAMPLES, bench_col_year, bench_col_mon, bench_col_mday, bench_err, &bench_zone) + bench_col_mon[BENCH_SAMPLES - 1]);
+} /* int64_t run_week_date_array() */
+
+
+/* ------------------------------------------------------------------------- *\
+   Optional hardware performance counters around the measured functions.
+   If perf events are not supported by the system, the kernel or the
+   permissions of the process then the counters are just not reported.
+\* ------------------------------------------------------------------------- */
+
+#define BENCH_CYCLES        0
+#define BENCH_INSTRUCTIONS  1
+#define BENCH_BRANCH_MISSES 2
+#define BENCH_L1D_MISSES    3
+#define BENCH_COUNTERS      4
+
+#ifdef BENCH_PERF
+
+static int bench_perf_fd[BENCH_COUNTERS] = { -1, -1, -1, -1 }; /* file descriptors of the counters or -1 if unavailable */
+
+/* ------------------------------------------------------------------------- *\
+   open_counter opens a single counter of user space events of this thread.
+   It returns -1 if the counter is unavailable.
+\* ------------------------------------------------------------------------- */
+
+static int open_counter(uint32_t type, uint64_t config)
+{
+   struct perf_event_attr pea;
+
+   memset(&pea, 0, sizeof(pea));
+   pea.type           = type;
+   pea.size           = sizeof(pea);
+   pea.config         = config;
+   pea.disabled       = 1;
+   pea.exclude_kernel = 1;
+   pea.exclude_hv     = 1;
+   pea.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+   return ((int) syscall(__NR_perf_event_open, &pea, 0 /* this process */, -1 /* any cpu */, -1 /* no group */, 0));
+} /* int open_counter(uint32_t type, uint64_t config) */
+
+
+/* ------------------------------------------------------------------------- *\
+   init_counters opens all counters and returns the number of the available
+   ones.
+\* ------------------------------------------------------------------------- */
+
+static int init_counters()
+{
+   int num = 0;
+   int i;
+
+   bench_perf_fd[BENCH_CYCLES]        = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+   bench_perf_fd[BENCH_INSTRUCTIONS]  = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+   bench_perf_fd[BENCH_BRANCH_MISSES] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+   bench_perf_fd[BENCH_L1D_MISSES]    = open_counter(PERF_TYPE_HW_CACHE,   PERF_COUNT_HW_CACHE_L1D
+                                                                        | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                                                                        | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+   for(i = 0; i < BENCH_COUNTERS; ++i)
+   {
+      if(bench_perf_fd[i] != -1)
+         ++num;
+   }
+
+   return (num);
+} /* int init_counters() */
+
+
+/* ------------------------------------------------------------------------- *\
+   start_counters resets and enables all available counters
+\* ------------------------------------------------------------------------- */
+
+static void start_counters()
+{
+   int i;
+
+   for(i = 0; i < BENCH_COUNTERS; ++i)
+   {
+      if(bench_perf_fd[i] != -1)
+      {
+         ioctl(bench_perf_fd[i], PERF_EVENT_IOC_RESET, 0);
+         ioctl(bench_perf_fd[i], PERF_EVENT_IOC_ENABLE, 0);
+      }
+   }
+} /* void start_counters() */
+
+
+/* ------------------------------------------------------------------------- *\
+   stop_counters disables all counters and stores their values or -1 for
+   the unavailable ones in pval. The values are scaled if the kernel had to
+   multiplex the counters.
+\* ------------------------------------------------------------------------- */
+
+static void stop_counters(double * pval)
+{
+   int i;
+
+   for(i = 0; i < BENCH_COUNTERS; ++i)
+   {
+      if(bench_perf_fd[i] != -1)
+         ioctl(bench_perf_fd[i], PERF_EVENT_IOC_DISABLE, 0);
+   }
+
+   for(i = 0; i < BENCH_COUNTERS; ++i)
+   {
+      uint64_t data[3]; /* value, time enabled and time running */
+
+      pval[i] = -1.0;
+
+      if((bench_perf_fd[i] != -1) && (read(bench_perf_fd[i], data, sizeof(data)) == (ssize_t) sizeof(data)) && data[2])
+         pval[i] = (double) data[0] * ((double) data[1] / (double) data[2]);
+   }
+} /* void stop_counters(double * pval) */
+
+#else
+
+static int  init_counters()              { return (0); }
+static void start_counters()             {}
+static void stop_counters(double * pval) { int i; for(i = 0; i < BENCH_COUNTERS; ++i) pval[i] = -1.0; }
+
+#endif /* BENCH_PERF */
+
+
+typedef struct BENCH_FUNC_S BENCH_FUNC;
+struct BENCH_FUNC_S
+{
+   const char * name;          /* name of the function in the report */
+   int64_t   (* pfn_run)();    /* runs the function for all samples */
+};
+
+static const BENCH_FUNC bench_funcs[] =
+{
+   { "new_gmtime_r",         run_new_gmtime_r         },
+   { "new_timegm",           run_new_timegm           },
+   { "localtime_of_zone",    run_localtime_of_zone    },
+   { "mktime_of_zone",       run_mktime_of_zone       },
+   { "new_timegm_array",     run_new_timegm_array     },
+   { "mktime_of_zone_array", run_mktime_of_zone_array },
+   { "localtime_columns",    run_localtime_columns    },
+   { "trunc_day_array",      run_trunc_day_array      },
+   { "day_boundaries",       run_day_boundaries       },
+   { "utc_offset_of_zone",   run_utc_offset_of_zone   },
+   { "add_month_array",      run_add_month_array      },
+   { "diff_time_array",      run_diff_time_array      },
+   { "format_time_ns",       run_format_time_ns       },
+   { "localtime_of_8_zones", run_localtime_of_8_zones },
+   { "convert_time_of_zone", run_convert_time_of_zone },
+   { "zone_ids_columns",     run_zone_ids_columns     },
+   { "parse_layout",         run_parse_layout         },
+   { "http_date",            run_http_date            },
+   { "syslog_time",          run_syslog_time          },
+   { "zoned_time",           run_zoned_time           },
+   { "week_date_array",      run_week_date_array      },
+   { NULL,                   NULL                     }
+};
+
+
+/* ------------------------------------------------------------------------- *\
+   The result of a function are its measurements of all passes and their
+   medians. The speed of a shared machine changes in phases that can last
+   for seconds, so a function is measured once in each pass over all
+   functions and not several times in a row. The regression gate compares
+   the relative costs, since the load of the machine slows down the
+   function and the reference work that is measured around it alike.
+\* ------------------------------------------------------------------------- */
+
+typedef struct BENCH_RESULT_S BENCH_RESULT;
+struct BENCH_RESULT_S
+{
+   double ns[BENCH_PASSES];  /* time of a call in nanoseconds of each pass */
+   double rel[BENCH_PASSES]; /* time of the function divided by the one of the reference work of each pass */
+   double ns_median;         /* median time of a call in nanoseconds */
+   double rel_median;        /* median relative cost */
+};
+
+
+/* ------------------------------------------------------------------------- *\
+   compare_double is the compare function of qsort for the medians
+\* ------------------------------------------------------------------------- */
+
+static int compare_double(const void * pa, const void * pb)
+{
+   double a = *(const double *) pa;
+   double b = *(const double *) pb;
+
+   return ((a > b) - (a < b));
+} /* int compare_double(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   time_rounds returns the time of BENCH_ROUNDS loops of a run function
+   over all samples in nanoseconds.
+\* ------------------------------------------------------------------------- */
+
+static int64_t time_rounds(int64_t (* pfn_run)())
+{
+   int64_t t0 = unix_time_ns();
+   int     round;
+
+   for(round = 0; round < BENCH_ROUNDS; ++round)
+      bench_sink += pfn_run();
+
+   return (unix_time_ns() - t0);
+} /* int64_t time_rounds(int64_t (* pfn_run)()) */
+
+
+/* ------------------------------------------------------------------------- *\
+   measure measures a function once for the pass and stores the time of a
+   call and the cost relative to the mean of the reference measurements
+   before and after it in presult. pref contains the time of the reference
+   work before the function and gets the one after it.
+\* ------------------------------------------------------------------------- */
+
+static void measure(const BENCH_FUNC * pf, BENCH_RESULT * presult, int pass, int64_t * pref)
+{
+   int64_t t         = time_rounds(pf->pfn_run);
+   int64_t ref_after = time_rounds(run_reference);
+   int64_t ref       = *pref + ref_after;
+
+   presult->ns[pass]  = (double) t / ((double) BENCH_SAMPLES * BENCH_ROUNDS);
+   presult->rel[pass] = (ref > 0) ? (2.0 * (double) t) / (double) ref : 0.0;
+   *pref              = ref_after;
+} /* void measure(const BENCH_FUNC * pf, BENCH_RESULT * presult, int pass, int64_t * pref) */
+
+
+/* ------------------------------------------------------------------------- *\
+   get_medians stores the medians of the measurements of all passes
+\* ------------------------------------------------------------------------- */
+
+static void get_medians(BENCH_RESULT * presult)
+{
+   double values[BENCH_PASSES];
+
+   memcpy(values, presult->ns, sizeof(values));
+   qsort(values, BENCH_PASSES, sizeof(values[0]), compare_double);
+   presult->ns_median = values[BENCH_PASSES / 2];
+
+   memcpy(values, presult->rel, sizeof(values));
+   qsort(values, BENCH_PASSES, sizeof(values[0]), compare_double);
+   presult->rel_median = values[BENCH_PASSES / 2];
+} /* void get_medians(BENCH_RESULT * presult) */
+
+
+/* ------------------------------------------------------------------------- *\
+   count_events runs a function once more with enabled hardware counters and
+   stores the events per call or -1 for the unavailable counters in pval.
+   This is done in a separate run for not disturbing the time measurement.
+\* ------------------------------------------------------------------------- */
+
+static void count_events(const BENCH_FUNC * pf, double * pval)
+{
+   int round;
+   int i;
+
+   start_counters();
+   for(round = 0; round < BENCH_ROUNDS; ++round)
+      bench_sink += pf->pfn_run();
+   stop_counters(pval);
+
+   for(i = 0; i < BENCH_COUNTERS; ++i)
+   {
+      if(pval[i] >= 0.0)
+         pval[i] /= (double) BENCH_SAMPLES * BENCH_ROUNDS;
+   }
+} /* void count_events(const BENCH_FUNC * pf, double * pval) */
+
+
+/* ------------------------------------------------------------------------- *\
+   print_events prints the instructions per cycle and the misses per call
+\* ------------------------------------------------------------------------- */
+
+static void print_events(const double * pval)
+{
+   if((pval[BENCH_CYCLES] > 0.0) && (pval[BENCH_INSTRUCTIONS] >= 0.0))
+      fprintf(stdout, " %8.2f", pval[BENCH_INSTRUCTIONS] / pval[BENCH_CYCLES]);
+   else
+      fprintf(stdout, " %8s", "n/a");
+
+   if(pval[BENCH_BRANCH_MISSES] >= 0.0)
+      fprintf(stdout, " %10.4f", pval[BENCH_BRANCH_MISSES]);
+   else
+      fprintf(stdout, " %10s", "n/a");
+
+   if(pval[BENCH_L1D_MISSES] >= 0.0)
+      fprintf(stdout, " %10.4f", pval[BENCH_L1D_MISSES]);
+   else
+      fprintf(stdout, " %10s", "n/a");
+} /* void print_events(const double * pval) */
+
+
+/* ------------------------------------------------------------------------- *\
+   The performance regression gate compares the measured relative costs with
+   the ones of a baseline file. Every line of that file contains the
+   distribution, the function, the median time of a call in nanoseconds for
+   information and the median relative cost. Lines that start with a '#'
+   are comments.
+\* ------------------------------------------------------------------------- */
+
+#define BENCH_NUM_DISTS (sizeof(bench_dists) / sizeof(bench_dists[0]))
+#define BENCH_NUM_FUNCS (sizeof(bench_funcs) / sizeof(bench_funcs[0]))
+
+static BENCH_RESULT bench_result[BENCH_NUM_DISTS][BENCH_NUM_FUNCS]; /* measured results of the functions */
+
+
+/* ------------------------------------------------------------------------- *\
+   write_baseline stores the measured results in a baseline file and returns
+   nonzero in success case.
+\* ------------------------------------------------------------------------- */
+
+static int write_baseline(const char * path, const char * pTZ)
+{
+   int    bRet = 0;
+   FILE * pf   = fopen(path, "w");
+   size_t d;
+   size_t f;
+
+   if(!pf)
+   {
+      fprintf(stderr, "Baseline file '%s' can't be created! (%s)\n", path, strerror(errno));
+      goto Exit;
+   }
+
+   fprintf(pf, "# baseline of bench_times (TZ=%s)\n", pTZ);
+   fprintf(pf, "# distribution function ns/call relative\n");
+
+   for(d = 0; bench_dists[d].name; ++d)
+   {
+      for(f = 0; bench_funcs[f].name; ++f)
+         fprintf(pf, "%s %s %.3f %.4f\n", bench_dists[d].name, bench_funcs[f].name, bench_result[d][f].ns_median, bench_result[d][f].rel_median);
+   }
+
+   bRet = !ferror(pf);
+
+   if(fclose(pf))
+      bRet = 0;
+
+   if(!bRet)
+      fprintf(stderr, "Writing of the baseline file '%s' has failed!\n", path);
+   else
+      fprintf(stdout, "Baseline file '%s' updated.\n", path);
+
+   Exit:;
+   return (bRet);
+} /* int write_baseline(const char * path, const char * pTZ) */
+
+
+/* ------------------------------------------------------------------------- *\
+   add_baseline appends the measured results of the functions that are
+   missing in a baseline file and keeps the existing rows. It returns
+   nonzero in success case.
+\* ------------------------------------------------------------------------- */
+
+static int add_baseline(const char * path)
+{
+   static char present[BENCH_NUM_DISTS][BENCH_NUM_FUNCS]; /* nonzero for the rows of the file */
+
+   int    bRet  = 0;
+   int    added = 0;
+   FILE * pf    = fopen(path, "r");
+   char   line[256];
+   size_t d;
+   size_t f;
+
+   if(!pf)
+   {
+      fprintf(stderr, "Baseline file '%s' can't be opened! (%s)\n", path, strerror(errno));
+      goto Exit;
+   }
+
+   while(fgets(line, sizeof(line), pf))
+   {
+      char dist[64];
+      char func[64];
+
+      if((*line == '#') || (sscanf(line, "%63s %63s", dist, func) != 2))
+         continue; /* comment or empty line */
+
+      for(d = 0; bench_dists[d].name && strcmp(bench_dists[d].name, dist); ++d) {};
+      for(f = 0; bench_funcs[f].name && strcmp(bench_funcs[f].name, func); ++f) {};
+
+      if(bench_dists[d].name && bench_funcs[f].name)
+         present[d][f] = 1;
+   }
+
+   fclose(pf);
+
+   pf = fopen(path, "a");
+   if(!pf)
+   {
+      fprintf(stderr, "Baseline file '%s' can't be opened for appending! (%s)\n", path, strerror(errno));
+      goto Exit;
+   }
+
+   for(d = 0; bench_dists[d].name; ++d)
+   {
+      for(f = 0; bench_funcs[f].name; ++f)
+      {
+         if(!present[d][f])
+         {
+            fprintf(pf, "%s %s %.3f %.4f\n", bench_dists[d].name, bench_funcs[f].name, bench_result[d][f].ns_median, bench_result[d][f].rel_median);
+            ++added;
+         }
+      }
+   }
+
+   bRet = !ferror(pf);
+
+   if(fclose(pf))
+      bRet = 0;
+
+   if(!bRet)
+      fprintf(stderr, "Writing of the baseline file '%s' has failed!\n", path);
+   else
+      fprintf(stdout, "%d rows added to the baseline file '%s'.\n", added, path);
+
+   Exit:;
+   return (bRet);
+} /* int add_baseline(const char * path) */
+
+
+/* ------------------------------------------------------------------------- *\
+   check_baseline compares the measured relative costs with the ones of a
+   baseline file and returns zero if any function became more expensive
+   than the threshold in percent permits or if a measured function has no
+   row in the baseline, since it wouldn't be gated at all otherwise. The
+   rows of new benchmarks are added with the option -add.
+\* ------------------------------------------------------------------------- */
+
+static int check_baseline(const char * path, double threshold)
+{
+   static char present[BENCH_NUM_DISTS][BENCH_NUM_FUNCS]; /* nonzero for the rows of the file */
+
+   int    bRet    = 0;
+   int    regress = 0;
+   int    checked = 0;
+   int    missing = 0;
+   FILE * pf      = fopen(path, "r");
+   char   line[256];
+   size_t d;
+   size_t f;
+
+   if(!pf)
+   {
+      fprintf(stderr, "Baseline file '%s' can't be opened! (%s)\n", path, strerror(errno));
+      goto Exit;
+   }
+
+   fprintf(stdout, "Comparison with baseline '%s' (threshold %.1f%%)\n", path, threshold);
+
+   while(fgets(line, sizeof(line), pf))
+   {
+      char   dist[64];
+      char   func[64];
+      double base_ns;
+      double base;
+      double rel;
+
+      if((*line == '#') || (sscanf(line, "%63s %63s %lf %lf", dist, func, &base_ns, &base) != 4))
+         continue; /* comment, empty line or line without a relative cost */
+
+      for(d = 0; bench_dists[d].name && strcmp(bench_dists[d].name, dist); ++d) {};
+      for(f = 0; bench_funcs[f].name && strcmp(bench_funcs[f].name, func); ++f) {};
+
+      if(!bench_dists[d].name || !bench_funcs[f].name || (base <= 0.0))
+      {
+         fprintf(stdout, "%-14s %-22s ignored\n", dist, func);
+         continue; /* not measured any more */
+      }
+
+      ++checked;
+      present[d][f] = 1;
+      rel = bench_result[d][f].rel_median;
+
+      if(rel > base * (1.0 + threshold / 100.0))
+      {
+         ++regress;
+         fprintf(stdout, "%-14s %-22s %10.4f > %10.4f (%+.1f%%) REGRESSION\n", dist, func,
+                 rel, base, (rel / base - 1.0) * 100.0);
+      }
+      else
+      {
+         fprintf(stdout, "%-14s %-22s %10.4f   %10.4f (%+.1f%%)\n", dist, func,
+                 rel, base, (rel / base - 1.0) * 100.0);
+      }
+   }
+
+   fclose(pf);
+
+   for(d = 0; bench_dists[d].name; ++d)
+   {
+      for(f = 0; bench_funcs[f].name; ++f)
+      {
+         if(!present[d][f])
+         {
+            ++missing;
+            fprintf(stdout, "%-14s %-22s %10.4f   %10s MISSING\n", bench_dists[d].name, bench_funcs[f].name, bench_result[d][f].rel_median, "");
+         }
+      }
+   }
+
+   if(!checked)
+   {
+      fprintf(stderr, "Baseline file '%s' doesn't contain any usable values!\n", path);
+      goto Exit;
+   }
+
+   if(regress)
+   {
+      fprintf(stderr, "\n%d of %d measurements regressed by more than %.1f%%!\n", regress, checked, threshold);
+      goto Exit;
+   }
+
+   if(missing)
+   {
+      fprintf(stderr, "\n%d measurements have no row in the baseline, add them with the option -add!\n", missing);
+      goto Exit;
+   }
+
+   fprintf(stdout, "\nPerformance regression gate passed! (%d measurements)\n", checked);
+
+   bRet = 1;
+   Exit:;
+   return (bRet);
+} /* int check_baseline(const char * path, double threshold) */
+
+
+/* ------------------------------------------------------------------------- *\
+   main function
+
+   bench_times [-noperf] [-baseline <file> [-update | -add] [-threshold <percent>]] [zone]
+\* ------------------------------------------------------------------------- */
+int main(int argc, char * argv[])
+{
+   int                iRet = 1;
+   const char *       pTZ  = pc_find_TZ("Paris");
+   const BENCH_DIST * pd;
+   const BENCH_FUNC * pf;
+   int                use_perf = 1;
+   int                counters = 0;
+   const char *       baseline = NULL;  /* optional baseline file of the regression gate */
+   int                update   = 0;     /* 1 for writing the baseline and 2 for adding the missing rows instead of checking it */
+   double             threshold = 25.0; /* permitted slowdown against the baseline in percent */
+   size_t             d;
+   size_t             f;
+   int                pass;
+   int                i;
+
+   for(i = 1; i < argc; ++i)
+   {
+      if(!strcmp(argv[i], "-noperf"))
+      {
+         use_perf = 0; /* don't read any hardware counters */
+      }
+      else if(!strcmp(argv[i], "-baseline") && (i + 1 < argc))
+      {
+         baseline = argv[++i];
+      }
+      else if(!strcmp(argv[i], "-update"))
+      {
+         update = 1;
+      }
+      else if(!strcmp(argv[i], "-add"))
+      {
+         update = 2;
+      }
+      else if(!strcmp(argv[i], "-threshold") && (i + 1 < argc))
+      {
+         threshold = atof(argv[++i]);
+         if(threshold < 0.0)
+         {
+            fprintf(stderr, "Invalid threshold '%s'!\n", argv[i]);
+            goto Exit;
+         }
+      }
+      else
+      { /* the time zone is given either as a location or as TZ value */
+         pTZ = pc_find_TZ(argv[i]);
+         if(!pTZ)
+            pTZ = argv[i];
+      }
+   }
+
+   if(update && !baseline)
+   {
+      fprintf(stderr, "Options -update and -add require a baseline file!\n");
+      goto Exit;
+   }
+
+   for(i = 0; i < BENCH_REF_BOUNDS; ++i) /* the bounds divide the 400 year epoch evenly */
+      bench_ref_bound[i] = (int64_t) i * (BENCH_REF_CYCLE / BENCH_REF_BOUNDS);
+
+   if(!pTZ || !read_TZ(&bench_zone, pTZ))
+   {
+      fprintf(stderr, "read_TZ (\"%s\") has failed!\n", pTZ ? pTZ : "<NULL>");
+      goto Exit;
+   }
+
+   for(i = 0; i < BENCH_SAMPLES; ++i)
+   {
+      bench_zones[i % 256] = bench_zone;
+      bench_zone_id[i]     = (uint16_t) (bench_random() % 256);
+   }
+
+   if(use_perf)
+      counters = init_counters();
+
+   fprintf(stdout, "TZ=%s (%d samples, median of %d passes)\n", pTZ, BENCH_SAMPLES, BENCH_PASSES);
+
+   if(!use_perf)
+      fprintf(stdout, "Hardware counters are disabled.\n\n");
+   else if(!counters)
+      fprintf(stdout, "Hardware counters are unavailable in this system.\n\n");
+   else
+      fprintf(stdout, "%d of %d hardware counters are available.\n\n", counters, BENCH_COUNTERS);
+
+   fprintf(stdout, "%-14s %-22s %12s %12s %10s", "distribution", "function", "ns/call", "Mcalls/s", "relative");
+   if(counters)
+      fprintf(stdout, " %8s %10s %10s", "IPC", "br-miss", "L1D-miss");
+   fprintf(stdout, "\n");
+
+   for(pass = 0; pass < BENCH_PASSES; ++pass)
+   {
+      for(d = 0; bench_dists[d].name; ++d)
+      {
+         int64_t ref;
+
+         if(!init_samples(&bench_dists[d]))
+            goto Exit;
+
+         ref = time_rounds(run_reference);
+
+         for(f = 0; bench_funcs[f].name; ++f)
+            measure(&bench_funcs[f], &bench_result[d][f], pass, &ref);
+      }
+   }
+
+   for(d = 0; bench_dists[d].name; ++d)
+   {
+      pd = &bench_dists[d];
+
+      if(counters && !init_samples(pd))
+         goto Exit;
+
+      for(f = 0; bench_funcs[f].name; ++f)
+      {
+         BENCH_RESULT * pr = &bench_result[d][f];
+
+         pf = &bench_funcs[f];
+         get_medians(pr);
+         fprintf(stdout, "%-14s %-22s %12.3f %12.2f %10.4f", pd->name, pf->name, pr->ns_median,
+                 (pr->ns_median > 0.0) ? 1000.0 / pr->ns_median : 0.0, pr->rel_median);
+
+         if(counters)
+         {
+            double events[BENCH_COUNTERS];
+            count_events(pf, events);
+            print_events(events);
+         }
+         fprintf(stdout, "\n");
+      }
+      fprintf(stdout, "\n");
+   }
+
+   if(baseline)
+   {
+      if(update == 2)
+      {
+         if(!add_baseline(baseline))
+            goto Exit;
+      }
+      else if(update)
+      {
+         if(!write_baseline(baseline, pTZ))
+            goto Exit;
+      }
+      else if(!check_baseline(baseline, threshold))
+      {
+         goto Exit;
+      }
+   }
+
+   iRet = 0;
+   Exit:;
+
+   return(iRet);
+}/* main() */
+
+/* ========================================================================= *\
+   E N D   O F   F I L E
+\* ========================================================================= */
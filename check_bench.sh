@@ -0,0 +1,24 @@
+#!/bin/sh
+# Performance regression gate: compares the benchmark results with bench_baseline.txt.
+# The gate compares the median cost of every function relative to a reference work
+# that is measured in the same run, since the plain times of a shared machine are
+# varying by far more than any sensible threshold.
+# BENCH_THRESHOLD sets the permitted slowdown in percent (default 25).
+# Measured functions without a row in the baseline fail the gate as well.
+# BENCH_CPU pins the benchmark to that CPU if taskset is available.
+#
+# Baseline update policy:
+# - A commit that adds a benchmark adds the rows of that benchmark only with
+#   "./check_bench.sh -add" and keeps all the other rows unchanged.
+# - A commit that changes the speed of a function on purpose updates the rows
+#   of that function only and names the change in its message.
+# - "./check_bench.sh -update" re-records the whole baseline. That is a commit of
+#   its own with a reason, e.g. another machine, compiler or measurement method.
+rm -f ./_bench_times
+cc -Wall -O3 -o _bench_times -I . -I zones bench_times.c time_api.c zones/tz_value.c
+pin=
+if [ -n "$BENCH_CPU" ] && command -v taskset > /dev/null 2>&1; then
+   pin="taskset -c $BENCH_CPU"
+fi
+$pin ./_bench_times -noperf -baseline bench_baseline.txt -threshold "${BENCH_THRESHOLD:-25}" "$@"
+exit $?
@@ -0,0 +1,5 @@
+#!/bin/sh
+rm -f ./_bench_times
+cc -Wall -O3 -o _bench_times -I . -I zones bench_times.c time_api.c zones/tz_value.c
+./_bench_times "$@"
+exit $?
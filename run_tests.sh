@@ -1,5 +1,38 @@
 #!/bin/sh
 rm -f ./_test_times
 cc -Wall -O3 -o _test_times -I . -I zones test_times.c time_api.c zones/tz_value.c
-./_test_times
-exit $?
+./_test_times || exit $?
+
+# the worker threads of a time pool and the scalar checks of parse_times_of_layout
+rm -f ./_test_times
+cc -Wall -O3 -DTIME_API_ENABLE_THREADS -DTIME_API_NO_SSE2 -pthread -o _test_times -I . -I zones test_times.c time_api.c zones/tz_value.c
+./_test_times || exit $?
+
+# the USDT probes if the sys/sdt.h of SystemTap is installed
+if echo '#include <sys/sdt.h>' | cc -E -x c - > /dev/null 2>&1; then
+   rm -f ./_test_times
+   cc -Wall -O3 -DTIME_API_ENABLE_USDT -o _test_times -I . -I zones test_times.c time_api.c zones/tz_value.c || exit $?
+   if command -v readelf > /dev/null 2>&1; then
+      for probe in tz_reload tz_parse_fail lock error; do
+         if ! readelf -n _test_times | grep -q "Name: $probe\$"; then
+            echo "USDT probe $probe is missing!"
+            exit 1
+         fi
+      done
+   fi
+   ./_test_times || exit $?
+else
+   echo "sys/sdt.h is not installed, the USDT probes are not tested."
+fi
+
+# the command-line tool tz_convert
+rm -f ./_tz_convert
+cc -Wall -O3 -o _tz_convert -I . -I zones tz_convert.c time_api.c zones/tz_value.c || exit $?
+result=`printf 'a 1711846800 b\nx 2024-03-31T01:59:59.5-01 y\nts=1711846800123 n\n2024-10-27 02:30:00\n' | ./_tz_convert -zone Paris -from Paris`
+expected=`printf 'a 2024-03-31T03:00:00+02:00 b\nx 2024-03-31T04:59:59.5+02:00 y\nts=2024-03-31T03:00:00.123+02:00 n\n2024-10-27T02:30:00+02:00\n'`
+if [ "$result" != "$expected" ]; then
+   echo "Test of tz_convert has failed!"
+   exit 1
+fi
+echo "Test of tz_convert passed!"
+exit 0
@@ -78,6 +78,7 @@
 #include <errno.h>
 #include <inttypes.h>
 #include <stddef.h>
+#include <limits.h>    /* INT_MAX */
 #include <time.h>      /* struct tm and localtime_r */
 #include <sys/types.h>
 
@@ -911,6 +912,2864 @@ Exit:;
 
 
 
+/* ------------------------------------------------------------------------- *\
+   Time zones of the tests of the zone related functions. The rules of those
+   cover the northern and southern hemisphere, odd offsets and the negative
+   daylight saving of Dublin.
+\* ------------------------------------------------------------------------- */
+
+static const char * test_zones[] = { "Paris", "New_York", "Sydney", "Santiago", "Lord_Howe", "Dublin", "UTC", NULL };
+
+
+/* ------------------------------------------------------------------------- *\
+   test_random is a tiny xorshift generator for reproducible test data
+\* ------------------------------------------------------------------------- */
+
+static uint64_t test_seed = 0x9e3779b97f4a7c15ull;
+
+static uint64_t test_random()
+{
+   test_seed ^= test_seed >> 12;
+   test_seed ^= test_seed << 25;
+   test_seed ^= test_seed >> 27;
+   return (test_seed * 0x2545f4914f6cdd1dull);
+} /* uint64_t test_random() */
+
+
+/* ------------------------------------------------------------------------- *\
+   random_tm fills a struct tm with a random date of the years 20000 BC
+   until 20000 AD. About every 8th struct contains an invalid member.
+\* ------------------------------------------------------------------------- */
+
+static void random_tm(struct tm * ptm)
+{
+   memset(ptm, 0, sizeof(*ptm));
+   ptm->tm_year  = (int) (test_random() % 40001) - 20000 - 1900;
+   ptm->tm_mon   = (int) (test_random() % 12);
+   ptm->tm_mday  = (int) (test_random() % 31) + 1;
+   ptm->tm_hour  = (int) (test_random() % 24);
+   ptm->tm_min   = (int) (test_random() % 60);
+   ptm->tm_sec   = (int) (test_random() % 61);
+   ptm->tm_isdst = (int) (test_random() % 3) - 1;
+
+   switch(test_random() % 64)
+   {
+      case 0: ptm->tm_mon  = -1;      break;
+      case 1: ptm->tm_mon  = 12;      break;
+      case 2: ptm->tm_mday = 0;       break;
+      case 3: ptm->tm_hour = 24;      break;
+      case 4: ptm->tm_min  = -1;      break;
+      case 5: ptm->tm_sec  = 61;      break;
+      case 6: ptm->tm_mday = 0x7fffffff; break;
+      case 7: ptm->tm_hour = -0x7fffffff - 1; break;
+      default: break;
+   }
+} /* void random_tm(struct tm * ptm) */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_tm_arrays compares the results of new_timegm_array and
+   mktime_of_zone_array with the ones of new_timegm and mktime_of_zone.
+\* ------------------------------------------------------------------------- */
+
+#define TEST_ARRAY_SIZE 20001
+
+int test_tm_arrays()
+{
+   int             bRet = 0;
+   static struct tm stm[TEST_ARRAY_SIZE];
+   static time64_t  tt[TEST_ARRAY_SIZE];
+   static uint8_t   err[(TEST_ARRAY_SIZE + 7) / 8];
+   TIME_ZONE_INFO  tzi;
+   const char **   ppz;
+   size_t          errors;
+   size_t          i;
+
+   for(i = 0; i < TEST_ARRAY_SIZE; ++i)
+      random_tm(&stm[i]);
+
+   for(ppz = test_zones; ; ++ppz)
+   {
+      size_t bad = 0;
+
+      if(*ppz)
+      {
+         if(!read_TZ(&tzi, pc_find_TZ(*ppz)))
+         {
+            fprintf(stderr, "read_TZ of %s has failed!\n", *ppz);
+            goto Exit;
+         }
+         errors = mktime_of_zone_array(stm, tt, err, TEST_ARRAY_SIZE, &tzi);
+      }
+      else
+      {
+         errors = new_timegm_array(stm, tt, err, TEST_ARRAY_SIZE);
+      }
+
+      for(i = 0; i < TEST_ARRAY_SIZE; ++i)
+      {
+         time64_t t;
+         int      failed;
+
+         errno = 0;
+         t = *ppz ? mktime_of_zone(&stm[i], &tzi) : new_timegm(&stm[i]);
+         failed = (errno != 0);
+         bad += failed;
+
+         if((t != tt[i]) || (failed != ((err[i / 8] >> (i % 8)) & 1)))
+         {
+            fprintf(stderr, "Array conversion of %.4d/%.2d/%.2d %.2d:%.2d:%.2d (dst=%d) differs in %s! (%lld %d != %lld %d)\n",
+                    stm[i].tm_year + 1900, stm[i].tm_mon + 1, stm[i].tm_mday, stm[i].tm_hour, stm[i].tm_min, stm[i].tm_sec, stm[i].tm_isdst,
+                    *ppz ? *ppz : "UTC", (long long) tt[i], (err[i / 8] >> (i % 8)) & 1, (long long) t, failed);
+            goto Exit;
+         }
+      }
+
+      if(bad != errors)
+      {
+         fprintf(stderr, "Array conversion returned %lu instead of %lu errors!\n", (unsigned long) errors, (unsigned long) bad);
+         goto Exit;
+      }
+
+      if(!*ppz)
+         break;
+   }
+
+   errno = 0;
+   bRet = 1;
+   Exit:;
+
+   if(!bRet)
+      fprintf(stderr, "Test of new_timegm_array and mktime_of_zone_array has failed!\n\n");
+   else
+      fprintf(stdout, "Test of new_timegm_array and mktime_of_zone_array passed!\n\n");
+   return(bRet);
+} /* int test_tm_arrays() */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_time_columns compares the results of localtime_columns_of_zone and
+   mktime_columns_of_zone with the ones of localtime_of_zone, new_gmtime_r
+   and mktime_of_zone.
+\* ------------------------------------------------------------------------- */
+
+int test_time_columns()
+{
+   int              bRet = 0;
+   static time64_t  tt[TEST_ARRAY_SIZE];
+   static time64_t  tr[TEST_ARRAY_SIZE];
+   static int32_t   year[TEST_ARRAY_SIZE];
+   static int8_t    mon[TEST_ARRAY_SIZE];
+   static int8_t    mday[TEST_ARRAY_SIZE];
+   static int8_t    hour[TEST_ARRAY_SIZE];
+   static int8_t    min[TEST_ARRAY_SIZE];
+   static int8_t    sec[TEST_ARRAY_SIZE];
+   static int8_t    wday[TEST_ARRAY_SIZE];
+   static int16_t   yday[TEST_ARRAY_SIZE];
+   static int8_t    isdst[TEST_ARRAY_SIZE];
+   static int32_t   gmtoff[TEST_ARRAY_SIZE];
+   static uint8_t   err[(TEST_ARRAY_SIZE + 7) / 8];
+   TIME_COLUMNS     cols;
+   TIME_COLUMNS     part;
+   TIME_ZONE_INFO   tzi;
+   const char **    ppz;
+   size_t           i;
+
+   cols.year = year;   cols.mon  = mon;  cols.mday = mday; cols.hour  = hour;  cols.min    = min;
+   cols.sec  = sec;    cols.wday = wday; cols.yday = yday; cols.isdst = isdst; cols.gmtoff = gmtoff;
+
+   for(i = 0; i < TEST_ARRAY_SIZE; ++i)
+   { /* random times of the years 20000 BC until 20000 AD and a few around 1970 */
+      if(i & 1)
+         tt[i] = (time64_t) (test_random() % ((uint64_t) 86400 * 365 * 40000)) - (time64_t) 86400 * 365 * 20000;
+      else
+         tt[i] = (time64_t) (test_random() % ((uint64_t) 86400 * 365 * 2)) - (time64_t) 86400 * 365;
+   }
+
+   for(ppz = test_zones; ; ++ppz)
+   {
+      if(*ppz && !read_TZ(&tzi, pc_find_TZ(*ppz)))
+      {
+         fprintf(stderr, "read_TZ of %s has failed!\n", *ppz);
+         goto Exit;
+      }
+
+      if(localtime_columns_of_zone(tt, TEST_ARRAY_SIZE, &cols, err, *ppz ? &tzi : NULL))
+      {
+         fprintf(stderr, "localtime_columns_of_zone reported unexpected errors!\n");
+         goto Exit;
+      }
+
+      for(i = 0; i < TEST_ARRAY_SIZE; ++i)
+      {
+         struct tm stm;
+
+         if(*ppz)
+            localtime_of_zone(tt[i], &stm, &tzi);
+         else
+            new_gmtime_r(tt[i], &stm);
+
+         if(   (stm.tm_year  != year[i])
+            || (stm.tm_mon   != mon[i])
+            || (stm.tm_mday  != mday[i])
+            || (stm.tm_hour  != hour[i])
+            || (stm.tm_min   != min[i])
+            || (stm.tm_sec   != sec[i])
+            || (stm.tm_wday  != wday[i])
+            || (stm.tm_yday  != yday[i])
+            || (stm.tm_isdst != isdst[i])
+#if defined __TM_ZONE || (defined (_POSIX_VERSION) && (_POSIX_VERSION  >= 202405))
+            || (stm.tm_gmtoff != gmtoff[i])
+#endif
+            )
+         {
+            fprintf(stderr, "localtime_columns_of_zone differs in %s for time %lld! (%.4d/%.2d/%.2d %.2d:%.2d:%.2d (yd=%d dst=%d wd=%d) != %.4d/%.2d/%.2d %.2d:%.2d:%.2d (yd=%d dst=%d wd=%d))\n",
+                    *ppz ? *ppz : "UTC", (long long) tt[i],
+                    year[i] + 1900, mon[i] + 1, mday[i], hour[i], min[i], sec[i], yday[i], isdst[i], wday[i],
+                    stm.tm_year + 1900, stm.tm_mon + 1, stm.tm_mday, stm.tm_hour, stm.tm_min, stm.tm_sec, stm.tm_yday, stm.tm_isdst, stm.tm_wday);
+            goto Exit;
+         }
+      }
+
+      /* the columns of the local times need to return the original times if the isdst flag is given */
+      if(mktime_columns_of_zone(&cols, TEST_ARRAY_SIZE, tr, err, *ppz ? &tzi : NULL) || memcmp(tt, tr, sizeof(tt)))
+      {
+         fprintf(stderr, "mktime_columns_of_zone didn't return the original times in %s!\n", *ppz ? *ppz : "UTC");
+         goto Exit;
+      }
+
+      /* random fields with the required columns only */
+      for(i = 0; i < TEST_ARRAY_SIZE; ++i)
+      {
+         struct tm stm;
+
+         random_tm(&stm);
+         year[i] = stm.tm_year;
+         mon[i]  = (int8_t) stm.tm_mon;
+         mday[i] = (int8_t) stm.tm_mday;
+      }
+
+      memset(&part, 0, sizeof(part));
+      part.year = year;
+      part.mon  = mon;
+      part.mday = mday;
+
+      mktime_columns_of_zone(&part, TEST_ARRAY_SIZE, tr, err, *ppz ? &tzi : NULL);
+
+      for(i = 0; i < TEST_ARRAY_SIZE; ++i)
+      {
+         struct tm stm;
+         time64_t  t;
+         int       failed;
+
+         memset(&stm, 0, sizeof(stm));
+         stm.tm_year  = year[i];
+         stm.tm_mon   = mon[i];
+         stm.tm_mday  = mday[i];
+         stm.tm_isdst = -1;
+
+         errno = 0;
+         t = *ppz ? mktime_of_zone(&stm, &tzi) : new_timegm(&stm);
+         failed = (errno != 0);
+
+         if((t != tr[i]) || (failed != ((err[i / 8] >> (i % 8)) & 1)))
+         {
+            fprintf(stderr, "mktime_columns_of_zone differs in %s for %.4d/%.2d/%.2d! (%lld != %lld)\n",
+                    *ppz ? *ppz : "UTC", year[i] + 1900, mon[i] + 1, mday[i], (long long) tr[i], (long long) t);
+            goto Exit;
+         }
+      }
+
+      if(!*ppz)
+         break;
+   }
+
+   errno = 0;
+   bRet = 1;
+   Exit:;
+
+   if(!bRet)
+      fprintf(stderr, "Test of localtime_columns_of_zone and mktime_columns_of_zone has failed!\n\n");
+   else
+      fprintf(stdout, "Test of localtime_columns_of_zone and mktime_columns_of_zone passed!\n\n");
+   return(bRet);
+} /* int test_time_columns() */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_localtime converts a time into the local time of a zone or into UTC
+   if ptzi is NULL.
+\* ------------------------------------------------------------------------- */
+
+static struct tm * test_localtime(time64_t t, struct tm * ptm, const TIME_ZONE_INFO * ptzi)
+{
+   return (ptzi ? localtime_of_zone(t, ptm, ptzi) : new_gmtime_r(t, ptm));
+} /* struct tm * test_localtime(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_period_begin returns the local begin of the period of a unit that
+   contains a local broken-down time in seconds since 1/1/1970 local time.
+\* ------------------------------------------------------------------------- */
+
+static int64_t test_period_begin(const struct tm * ptm, int unit)
+{
+   struct tm stm = *ptm;
+   int64_t   week_day = 0;
+
+   switch(unit)
+   {
+      case TIME_UNIT_YEAR:    stm.tm_mon  = 0;                      /* no break */
+      case TIME_UNIT_QUARTER: stm.tm_mon -= stm.tm_mon % 3;         /* no break */
+      case TIME_UNIT_MONTH:   stm.tm_mday = 1;                      /* no break */
+      case TIME_UNIT_DAY:     stm.tm_hour = 0;                      /* no break */
+      case TIME_UNIT_HOUR:    stm.tm_min  = 0;                      /* no break */
+      case TIME_UNIT_MINUTE:  stm.tm_sec  = 0;                      break;
+      case TIME_UNIT_WEEK:    stm.tm_hour = stm.tm_min = stm.tm_sec = 0;
+                              week_day = (stm.tm_wday + 6) % 7;     break;
+      default:                                                      break;
+   }
+
+   stm.tm_isdst = 0;
+   return (new_timegm(&stm) - (week_day * 86400));
+} /* int64_t test_period_begin(const struct tm * ptm, int unit) */
+
+
+/* ------------------------------------------------------------------------- *\
+   check_trunc_times checks the results of trunc_time_of_zone with the help
+   of localtime_of_zone. The result needs to be in the same local period as
+   the time, it needs to be the local begin of the period or a daylight
+   saving change into the period and no later time up to the truncated time
+   may have the local begin of the period. trunc_time_array_of_zone needs to
+   return the same results.
+\* ------------------------------------------------------------------------- */
+
+static int check_trunc_times(const time64_t * tt, time64_t * tr, size_t count, const TIME_ZONE_INFO * pz, const char * name)
+{
+   size_t i;
+   int    unit;
+
+   for(unit = TIME_UNIT_SECOND; unit <= TIME_UNIT_YEAR; ++unit)
+   {
+      if(!trunc_time_array_of_zone(tt, tr, count, unit, pz))
+      {
+         fprintf(stderr, "trunc_time_array_of_zone has failed!\n");
+         return (0);
+      }
+
+      for(i = 0; i < count; ++i)
+      {
+         struct tm stm;
+         time64_t  t = tt[i];
+         time64_t  r = trunc_time_of_zone(t, unit, pz);
+         int64_t   begin;
+         int64_t   local;
+         int64_t   before;
+         int       offset;
+         int       failed = (r != tr[i]) || (r > t);
+
+         test_localtime(t, &stm, pz);
+         begin = test_period_begin(&stm, unit);
+
+         test_localtime(r, &stm, pz);
+         failed |= (test_period_begin(&stm, unit) != begin);
+         stm.tm_isdst = 0;
+         local = new_timegm(&stm);
+
+         test_localtime(r - 1, &stm, pz);
+         before = test_period_begin(&stm, unit);
+
+         failed |= (local != begin) && (before == begin); /* neither the local begin nor a change into the period */
+
+         for(offset = 0; pz && (offset < 2); ++offset)
+         { /* a later time with the local begin of the period */
+            time64_t t2 = begin + (offset ? pz->daylight.bias : pz->standard.bias);
+
+            if((t2 > r) && (t2 <= t))
+            {
+               test_localtime(t2, &stm, pz);
+               stm.tm_isdst = 0;
+               failed |= (new_timegm(&stm) == begin);
+            }
+         }
+
+         if(failed)
+         {
+            fprintf(stderr, "trunc_time_of_zone of unit %d has failed in %s for time %lld! (%lld, %lld)\n",
+                    unit, name, (long long) t, (long long) r, (long long) tr[i]);
+            return (0);
+         }
+      }
+   }
+
+   return (1);
+} /* int check_trunc_times(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_trunc_time checks trunc_time_of_zone and trunc_time_array_of_zone
+   for random times and a sweep through two years with all their daylight
+   saving changes in the test zones and in a zone that skips the half hour
+   from 1:30 until 2:30 and with it the begin of an hour.
+\* ------------------------------------------------------------------------- */
+
+int test_trunc_time()
+{
+   int              bRet = 0;
+   static time64_t  tt[TEST_ARRAY_SIZE];
+   static time64_t  tr[TEST_ARRAY_SIZE];
+   TIME_ZONE_INFO   tzi;
+   const char **    ppz;
+   size_t           i;
+
+   for(i = 0; i < TEST_ARRAY_SIZE; ++i)
+   {
+      if(i & 1) /* random times of the years 2000 BC until 4000 AD */
+         tt[i] = (time64_t) (test_random() % ((uint64_t) 86400 * 365 * 6000)) - (time64_t) 86400 * 365 * 3970;
+      else      /* 2024 and 2025 in steps of a bit less than an hour */
+         tt[i] = (time64_t) 1704067200 + (time64_t) (i / 2) * 3457;
+   }
+
+   for(ppz = test_zones; ; ++ppz)
+   {
+      if(*ppz && !read_TZ(&tzi, pc_find_TZ(*ppz)))
+      {
+         fprintf(stderr, "read_TZ of %s has failed!\n", *ppz);
+         goto Exit;
+      }
+
+      if(!check_trunc_times(tt, tr, TEST_ARRAY_SIZE, *ppz ? &tzi : NULL, *ppz ? *ppz : "UTC"))
+         goto Exit;
+
+      if(!*ppz)
+         break;
+   }
+
+   for(i = 0; i < TEST_ARRAY_SIZE; ++i)
+   { /* the days around the changes at 3/31/2024 and 10/27/2024 in steps of 23 seconds */
+      if(i & 1)
+         tt[i] = (time64_t) 1711756800 + (time64_t) (i / 2) * 23;
+      else
+         tt[i] = (time64_t) 1729900800 + (time64_t) (i / 2) * 23;
+   }
+
+   if(   !read_TZ(&tzi, "<+0130>-1:30<+0230>-2:30,M3.5.0/1:30,M10.5.0/2:30")
+      || !check_trunc_times(tt, tr, TEST_ARRAY_SIZE, &tzi, "<+0130>"))
+      goto Exit;
+
+   errno = 0;
+   if((trunc_time_of_zone(0, TIME_UNIT_YEAR + 1, NULL) != -1) || (errno != EINVAL))
+   {
+      fprintf(stderr, "trunc_time_of_zone accepted an invalid unit!\n");
+      goto Exit;
+   }
+
+   errno = 0;
+   bRet = 1;
+   Exit:;
+
+   if(!bRet)
+      fprintf(stderr, "Test of trunc_time_of_zone and trunc_time_array_of_zone has failed!\n\n");
+   else
+      fprintf(stdout, "Test of trunc_time_of_zone and trunc_time_array_of_zone passed!\n\n");
+   return(bRet);
+} /* int test_trunc_time() */
+
+
+/* ------------------------------------------------------------------------- *\
+   check_time_boundaries checks the boundaries of an iterator for a range
+   in a zone. Every boundary needs to be the truncated time of itself and
+   the truncated time of the time before the following boundary and of a
+   random time in between. The first boundary needs to be the first one
+   at or after the begin of the range.
+\* ------------------------------------------------------------------------- */
+
+static int check_time_boundaries(time64_t begin, time64_t end, int unit, const TIME_ZONE_INFO * pz, const char * name)
+{
+   TIME_BOUNDARIES tb;
+   time64_t        tt[64];
+   time64_t        prev  = trunc_time_of_zone(begin, unit, pz);
+   int             first = 1;
+   size_t          count;
+   size_t          i;
+
+   if(!init_time_boundaries(&tb, begin, end, unit, pz))
+   {
+      fprintf(stderr, "init_time_boundaries has failed!\n");
+      return (0);
+   }
+
+   while((count = get_time_boundaries(&tb, tt, sizeof(tt) / sizeof(tt[0]))) > 0)
+   {
+      for(i = 0; i < count; ++i)
+      {
+         time64_t t      = tt[i];
+         int      failed = (t < begin) || (t >= end) || (trunc_time_of_zone(t, unit, pz) != t);
+
+         if(first && (prev == begin))
+            failed |= (t != begin);
+         else
+            failed |= (t <= prev)
+                   || (trunc_time_of_zone(t - 1, unit, pz) != prev)
+                   || (trunc_time_of_zone(prev + (time64_t) (test_random() % (uint64_t) (t - prev)), unit, pz) != prev);
+
+         if(failed)
+         {
+            fprintf(stderr, "The boundary %lld of unit %d after %lld is wrong in %s!\n", (long long) t, unit, (long long) prev, name);
+            return (0);
+         }
+
+         prev  = t;
+         first = 0;
+      }
+
+      if(count < sizeof(tt) / sizeof(tt[0]))
+         break;
+   }
+
+   if(trunc_time_of_zone(end - 1, unit, pz) != prev)
+   {
+      fprintf(stderr, "The boundaries of unit %d in %s ended at %lld!\n", unit, name, (long long) prev);
+      return (0);
+   }
+
+   if(next_time_boundary(&tb, tt))
+   {
+      fprintf(stderr, "next_time_boundary returned a boundary after the end of the range!\n");
+      return (0);
+   }
+
+   return (1);
+} /* int check_time_boundaries(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_time_boundaries checks the iterator of local calendar boundaries
+   for all units in the test zones during 2024 and 2025 and in the years
+   around 1000 BC and 3000 AD. Minutes are checked for two months of 2024.
+\* ------------------------------------------------------------------------- */
+
+int test_time_boundaries()
+{
+   int             bRet = 0;
+   TIME_ZONE_INFO  tzi;
+   const char **   ppz;
+   int             unit;
+
+   for(ppz = test_zones; ; ++ppz)
+   {
+      const TIME_ZONE_INFO * pz   = *ppz ? &tzi : NULL;
+      const char *           name = *ppz ? *ppz : "UTC";
+
+      if(*ppz && !read_TZ(&tzi, pc_find_TZ(*ppz)))
+      {
+         fprintf(stderr, "read_TZ of %s has failed!\n", *ppz);
+         goto Exit;
+      }
+
+      if(   !check_time_boundaries((time64_t) 1709251200, (time64_t) 1714521600, TIME_UNIT_MINUTE, pz, name)  /* March and April 2024 */
+         || !check_time_boundaries((time64_t) 1727740800, (time64_t) 1733011200, TIME_UNIT_MINUTE, pz, name)) /* October and November 2024 */
+         goto Exit;
+
+      for(unit = TIME_UNIT_HOUR; unit <= TIME_UNIT_YEAR; ++unit)
+      {
+         if(   !check_time_boundaries((time64_t) 1704067200 + 12345,         (time64_t) 1767225600 - 4321, unit, pz, name)
+            || !check_time_boundaries((time64_t) -93692592000LL + 777,       (time64_t) -93629433600LL,    unit, pz, name)
+            || !check_time_boundaries((time64_t) 32503680000LL - 86400 * 40, (time64_t) 32566752000LL,     unit, pz, name))
+            goto Exit;
+      }
+
+      if(!*ppz)
+         break;
+   }
+
+   if(   !read_TZ(&tzi, "<+0130>-1:30<+0230>-2:30,M3.5.0/1:30,M10.5.0/2:30")
+      || !check_time_boundaries((time64_t) 1711756800, (time64_t) 1712016000, TIME_UNIT_MINUTE, &tzi, "<+0130>")
+      || !check_time_boundaries((time64_t) 1704067200, (time64_t) 1767225600, TIME_UNIT_HOUR,   &tzi, "<+0130>"))
+      goto Exit;
+
+   errno = 0;
+   bRet = 1;
+   Exit:;
+
+   if(!bRet)
+      fprintf(stderr, "Test of the iteration of local calendar boundaries has failed!\n\n");
+   else
+      fprintf(stdout, "Test of the iteration of local calendar boundaries passed!\n\n");
+   return(bRet);
+} /* int test_time_boundaries() */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_gmtoff returns the offset of the local time of a zone to UTC with
+   the help of localtime_of_zone and stores the daylight saving flag.
+\* ------------------------------------------------------------------------- */
+
+static int32_t test_gmtoff(time64_t t, const TIME_ZONE_INFO * ptzi, int * pisdst)
+{
+   struct tm stm;
+
+   localtime_of_zone(t, &stm, ptzi);
+   *pisdst = stm.tm_isdst;
+   stm.tm_isdst = 0;
+   return ((int32_t) (new_timegm(&stm) - t));
+} /* int32_t test_gmtoff(time64_t t, const TIME_ZONE_INFO * ptzi, int * pisdst) */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_transitions walks through the daylight saving changes of the test
+   zones from 1900 until 2200 with next_transition and back with
+   prev_transition. Every change needs to be one according to
+   localtime_of_zone, each year needs to have two of them and random times
+   between two changes need to have the offset after the first one.
+\* ------------------------------------------------------------------------- */
+
+int test_transitions()
+{
+   int                  bRet = 0;
+   TIME_ZONE_INFO       tzi;
+   TIME_ZONE_TRANSITION tr;
+   TIME_ZONE_TRANSITION tp;
+   const char **        ppz;
+
+   for(ppz = test_zones; *ppz; ++ppz)
+   {
+      time64_t t     = (time64_t) -2208988800LL; /* 1/1/1900 */
+      time64_t end   = (time64_t) 7258118400LL;  /* 1/1/2200 */
+      int      count = 0;
+
+      if(!read_TZ(&tzi, pc_find_TZ(*ppz)))
+      {
+         fprintf(stderr, "read_TZ of %s has failed!\n", *ppz);
+         goto Exit;
+      }
+
+      if(tzi.type < 2)
+      {
+         if(next_transition(t, &tr, &tzi) || prev_transition(t, &tr, &tzi))
+         {
+            fprintf(stderr, "%s has no daylight saving but a transition!\n", *ppz);
+            goto Exit;
+         }
+         continue;
+      }
+
+      while(next_transition(t, &tr, &tzi) && (tr.time < end))
+      {
+         int      isdst_before;
+         int      isdst_after;
+         int32_t  before = test_gmtoff(tr.time - 1, &tzi, &isdst_before);
+         int32_t  after  = test_gmtoff(tr.time,     &tzi, &isdst_after);
+         time64_t t2     = t + (time64_t) (test_random() % (uint64_t) (tr.time - t));
+
+         if(   (tr.time <= t)
+            || (before != tr.gmtoff_before) || (after != tr.gmtoff_after) || (before == after)
+            || (isdst_before != tr.isdst_before) || (isdst_after != tr.isdst_after)
+            || strcmp(tr.zone_before, isdst_before ? tzi.daylight.zone_name : tzi.standard.zone_name)
+            || strcmp(tr.zone_after,  isdst_after  ? tzi.daylight.zone_name : tzi.standard.zone_name)
+            || (test_gmtoff(t2, &tzi, &isdst_after) != before)
+            || !prev_transition(tr.time, &tp, &tzi) || (tp.time != tr.time)
+            || !prev_transition(t2, &tp, &tzi) || ((count > 0) && (tp.time != t)))
+         {
+            fprintf(stderr, "The transition at %lld in %s is wrong!\n", (long long) tr.time, *ppz);
+            goto Exit;
+         }
+
+         t = tr.time;
+         ++count;
+      }
+
+      if(count != 2 * 300)
+      {
+         fprintf(stderr, "%s has %d transitions in 300 years!\n", *ppz, count);
+         goto Exit;
+      }
+   }
+
+   errno = 0;
+   if(next_transition(0, NULL, &tzi) || (errno != EINVAL))
+   {
+      fprintf(stderr, "next_transition accepted a NULL pointer!\n");
+      goto Exit;
+   }
+
+   errno = 0;
+   bRet = 1;
+   Exit:;
+
+   if(!bRet)
+      fprintf(stderr, "Test of next_transition and prev_transition has failed!\n\n");
+   else
+      fprintf(stdout, "Test of next_transition and prev_transition passed!\n\n");
+   return(bRet);
+} /* int test_transitions() */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_utc_offset compares the offsets and flags of utc_offset_of_zone with
+   the ones of localtime_of_zone for random times. The interval needs to
+   contain the time and its first and last time need to have the same
+   offset and flag.
+\* ------------------------------------------------------------------------- */
+
+int test_utc_offset()
+{
+   int            bRet = 0;
+   TIME_ZONE_INFO tzi;
+   const char **  ppz;
+   int            i;
+
+   for(ppz = test_zones; ; ++ppz)
+   {
+      const TIME_ZONE_INFO * pz = *ppz ? &tzi : NULL;
+
+      if(*ppz && !read_TZ(&tzi, pc_find_TZ(*ppz)))
+      {
+         fprintf(stderr, "read_TZ of %s has failed!\n", *ppz);
+         goto Exit;
+      }
+
+      for(i = 0; i < 10000; ++i)
+      {
+         time64_t t = (time64_t) (test_random() % ((uint64_t) 86400 * 365 * 6000)) - (time64_t) 86400 * 365 * 3970;
+         time64_t begin;
+         time64_t end;
+         int32_t  isdst;
+         int32_t  isdst2;
+         int      isdst_tm = 0;
+         int32_t  offset   = utc_offset_of_zone(t, pz, &isdst, &begin, &end);
+         int      failed   = (begin > t) || (end <= t);
+
+         if(pz)
+         {
+            failed |= (offset != test_gmtoff(t, pz, &isdst_tm)) || (isdst != isdst_tm)
+                   || (utc_offset_of_zone(begin,   pz, &isdst2, NULL, NULL) != offset) || (isdst2 != isdst)
+                   || (utc_offset_of_zone(end - 1, pz, &isdst2, NULL, NULL) != offset) || (isdst2 != isdst);
+         }
+         else
+         {
+            failed |= (offset != 0) || (isdst != 0);
+         }
+
+         if(failed)
+         {
+            fprintf(stderr, "utc_offset_of_zone is wrong in %s for time %lld!\n", *ppz ? *ppz : "UTC", (long long) t);
+            goto Exit;
+         }
+      }
+
+      if(!*ppz)
+         break;
+   }
+
+   errno = 0;
+   bRet = 1;
+   Exit:;
+
+   if(!bRet)
+      fprintf(stderr, "Test of utc_offset_of_zone has failed!\n\n");
+   else
+      fprintf(stdout, "Test of utc_offset_of_zone passed!\n\n");
+   return(bRet);
+} /* int test_utc_offset() */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_add_local_time is the reference of the calendar arithmetic. It adds
+   to the fields of the local time, clamps the day of the month and looks
+   for the UTC times of the result with mktime_of_zone with and without the
+   daylight saving flag. Those that return the same local time are valid.
+\* ------------------------------------------------------------------------- */
+
+static time64_t test_add_local_time(time64_t t, int years, int months, int days, int policy, const TIME_ZONE_INFO * ptzi)
+{
+   static const int days_of_month[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+   struct tm stm;
+   struct tm stm2;
+   time64_t  tt[2];
+   int       valid[2];
+   int       year;
+   int       last_mday;
+   int       i;
+
+   test_localtime(t, &stm, ptzi);
+
+   months    += stm.tm_mon + (years * 12);
+   stm.tm_year += months / 12;
+   stm.tm_mon   = months % 12;
+   if(stm.tm_mon < 0)
+   {
+      stm.tm_mon += 12;
+      --stm.tm_year;
+   }
+
+   year      = stm.tm_year + 1900;
+   last_mday = days_of_month[stm.tm_mon] + ((stm.tm_mon == 1) && ((year % 4 == 0) && ((year % 100 != 0) || (year % 400 == 0))));
+   if(stm.tm_mday > last_mday)
+      stm.tm_mday = last_mday;
+
+   stm.tm_isdst = 0;
+   tt[0] = new_timegm(&stm) + (time64_t) days * 86400; /* local time of the result */
+   test_localtime(tt[0], &stm, NULL);
+
+   for(i = 0; i < 2; ++i)
+   {
+      stm.tm_isdst = i;
+      tt[i]        = ptzi ? mktime_of_zone(&stm, ptzi) : new_timegm(&stm);
+      test_localtime(tt[i], &stm2, ptzi);
+      valid[i]     = (stm2.tm_mday == stm.tm_mday) && (stm2.tm_hour == stm.tm_hour) && (stm2.tm_min == stm.tm_min) && (stm2.tm_sec == stm.tm_sec);
+   }
+
+   if((valid[0] != valid[1]) || (valid[0] && (tt[0] == tt[1])))
+      return (valid[0] ? tt[0] : tt[1]);
+
+   if(policy == TIME_LOCAL_REJECT)
+      return (-1);
+
+   if((policy == TIME_LOCAL_EARLIER) || ((policy == TIME_LOCAL_COMPATIBLE) && valid[0]))
+      return ((tt[0] < tt[1]) ? tt[0] : tt[1]);
+
+   return ((tt[0] > tt[1]) ? tt[0] : tt[1]);
+} /* time64_t test_add_local_time(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_add_time compares add_time_of_zone and add_time_array_of_zone with
+   the reference for random times and a sweep through 2024 in steps of a
+   bit less than an hour, and checks the clamping of the end of months and
+   the policies at the begin of the daylight saving in New York.
+\* ------------------------------------------------------------------------- */
+
+int test_add_time()
+{
+   static const int steps[][3] = { { 0, 1, 0 }, { 0, 0, 1 }, { 1, 0, 0 }, { 0, -1, 0 }, { 0, 0, -1 }, { 0, 13, -40 }, { -3, 5, 400 } };
+
+   int             bRet = 0;
+   static time64_t tt[TEST_ARRAY_SIZE];
+   static time64_t tr[TEST_ARRAY_SIZE];
+   static uint8_t  err[(TEST_ARRAY_SIZE + 7) / 8];
+   TIME_ZONE_INFO  tzi;
+   const char **   ppz;
+   size_t          i;
+   size_t          s;
+   int             policy;
+
+   for(i = 0; i < TEST_ARRAY_SIZE; ++i)
+   {
+      if(i & 1) /* random times of the years 1000 BC until 3000 AD */
+         tt[i] = (time64_t) (test_random() % ((uint64_t) 86400 * 365 * 4000)) - (time64_t) 86400 * 365 * 2970;
+      else      /* 2024 in steps of a bit less than an hour */
+         tt[i] = (time64_t) 1704067200 + (time64_t) (i / 2) * 3157;
+   }
+
+   for(ppz = test_zones; ; ++ppz)
+   {
+      const TIME_ZONE_INFO * pz = *ppz ? &tzi : NULL;
+
+      if(*ppz && !read_TZ(&tzi, pc_find_TZ(*ppz)))
+      {
+         fprintf(stderr, "read_TZ of %s has failed!\n", *ppz);
+         goto Exit;
+      }
+
+      for(s = 0; s < sizeof(steps) / sizeof(steps[0]); ++s)
+      {
+         for(policy = TIME_LOCAL_COMPATIBLE; policy <= TIME_LOCAL_REJECT; ++policy)
+         {
+            size_t errors = add_time_array_of_zone(tt, tr, err, TEST_ARRAY_SIZE, steps[s][0], steps[s][1], steps[s][2], policy, pz);
+            size_t bad    = 0;
+
+            for(i = 0; i < TEST_ARRAY_SIZE; ++i)
+            {
+               time64_t t = add_time_of_zone(tt[i], steps[s][0], steps[s][1], steps[s][2], policy, pz);
+               time64_t r = test_add_local_time(tt[i], steps[s][0], steps[s][1], steps[s][2], policy, pz);
+
+               bad += (r == -1);
+
+               if((t != r) || (tr[i] != r) || (((err[i / 8] >> (i % 8)) & 1) != (r == -1)))
+               {
+                  fprintf(stderr, "add_time_of_zone(%d, %d, %d) with policy %d differs in %s for time %lld! (%lld, %lld != %lld)\n",
+                          steps[s][0], steps[s][1], steps[s][2], policy, *ppz ? *ppz : "UTC", (long long) tt[i], (long long) t, (long long) tr[i], (long long) r);
+                  goto Exit;
+               }
+            }
+
+            if(errors != bad)
+            {
+               fprintf(stderr, "add_time_array_of_zone returned %u errors instead of %u!\n", (unsigned) errors, (unsigned) bad);
+               goto Exit;
+            }
+         }
+      }
+
+      if(!*ppz)
+         break;
+   }
+
+   /* 1/31/2024 12:00 plus one month is 2/29/2024 and plus 13 months 2/28/2025 */
+   if(   (add_time_of_zone((time64_t) 1706702400, 0, 1, 0, TIME_LOCAL_COMPATIBLE, NULL) != (time64_t) 1709208000)
+      || (add_time_of_zone((time64_t) 1706702400, 1, 1, 0, TIME_LOCAL_COMPATIBLE, NULL) != (time64_t) 1740744000))
+   {
+      fprintf(stderr, "add_time_of_zone doesn't clamp the end of the month!\n");
+      goto Exit;
+   }
+
+   /* 3/9/2024 2:30 EST plus one day is skipped in New York */
+   errno = 0;
+   if(   !read_TZ(&tzi, pc_find_TZ("New_York"))
+      || (add_time_of_zone((time64_t) 1709969400, 0, 0, 1, TIME_LOCAL_COMPATIBLE, &tzi) != (time64_t) 1710055800)  /* 3:30 EDT */
+      || (add_time_of_zone((time64_t) 1709969400, 0, 0, 1, TIME_LOCAL_EARLIER,    &tzi) != (time64_t) 1710052200)  /* 1:30 EST */
+      || (errno != 0)
+      || (add_time_of_zone((time64_t) 1709969400, 0, 0, 1, TIME_LOCAL_REJECT,     &tzi) != -1) || (errno != ERANGE))
+   {
+      fprintf(stderr, "add_time_of_zone doesn't apply the policies for skipped times!\n");
+      goto Exit;
+   }
+
+   errno = 0;
+   bRet = 1;
+   Exit:;
+
+   if(!bRet)
+      fprintf(stderr, "Test of add_time_of_zone and add_time_array_of_zone has failed!\n\n");
+   else
+      fprintf(stdout, "Test of add_time_of_zone and add_time_array_of_zone passed!\n\n");
+   return(bRet);
+} /* int test_add_time() */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_diff_local_time is the reference of the calendar difference of two
+   times t1 <= t2. It searches the largest number of months and then of
+   days that add_time_of_zone adds to t1 without passing t2 by counting
+   them up one by one, so it doesn't depend on the local times at all.
+\* ------------------------------------------------------------------------- */
+
+static void test_diff_local_time(time64_t t1, time64_t t2, int largest_unit, TIME_DIFF * pdiff, const TIME_ZONE_INFO * ptzi)
+{
+   time64_t t      = t1;
+   int64_t  months = 0;
+   int64_t  days   = 0;
+   int64_t  rest;
+
+   memset(pdiff, 0, sizeof(*pdiff));
+
+   if(largest_unit >= TIME_UNIT_MONTH)
+   {
+      while(add_time_of_zone(t1, 0, (int32_t) months + 1, 0, TIME_LOCAL_COMPATIBLE, ptzi) <= t2)
+         ++months;
+   }
+
+   if(largest_unit >= TIME_UNIT_DAY)
+   {
+      while(add_time_of_zone(t1, 0, (int32_t) months, (int32_t) days + 1, TIME_LOCAL_COMPATIBLE, ptzi) <= t2)
+         ++days;
+
+      if(months || days)
+         t = add_time_of_zone(t1, 0, (int32_t) months, (int32_t) days, TIME_LOCAL_COMPATIBLE, ptzi);
+   }
+
+   rest = t2 - t;
+
+   if(largest_unit == TIME_UNIT_YEAR)
+   {
+      pdiff->years = months / 12;
+      months %= 12;
+   }
+
+   pdiff->months = months;
+   pdiff->days   = days;
+
+   if(largest_unit >= TIME_UNIT_HOUR)
+   {
+      pdiff->hours = rest / 3600;
+      rest %= 3600;
+   }
+
+   if(largest_unit >= TIME_UNIT_MINUTE)
+   {
+      pdiff->minutes = rest / 60;
+      rest %= 60;
+   }
+
+   pdiff->seconds = rest;
+} /* void test_diff_local_time(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_diff_time compares diff_time_of_zone and diff_time_array_of_zone with
+   the reference for random pairs of times of the years 1900 until 2100
+   that are up to 5 years apart and for pairs around the daylight saving
+   changes of 2024 that are up to 3 days apart. Swapped pairs need to have
+   negated differences. Pairs with t2 in the repeated hour after a daylight
+   saving change need to have the expected differences.
+\* ------------------------------------------------------------------------- */
+
+#define TEST_DIFF_SIZE 4000
+
+int test_diff_time()
+{
+   static const int units[] = { TIME_UNIT_YEAR, TIME_UNIT_MONTH, TIME_UNIT_DAY, TIME_UNIT_HOUR, TIME_UNIT_MINUTE, TIME_UNIT_SECOND };
+
+   static const struct
+   {
+      const char * zone;
+      time64_t     t1;
+      time64_t     t2;
+      int          unit;
+      TIME_DIFF    expected;
+   }
+   repeated[] =
+   { /* 2003-10-25 02:32:07 CEST until 2003-10-26 02:31:02 CET, one day later is 02:32:07 CEST */
+      { "Paris",    1067041927, 1067131862, TIME_UNIT_DAY,   { 0, 0, 1,  0, 58, 55 } },
+      { "Paris",    1067041927, 1067131862, TIME_UNIT_HOUR,  { 0, 0, 0, 24, 58, 55 } },
+      { "Paris",    1064536327, 1067131862, TIME_UNIT_MONTH, { 0, 1, 0,  0, 58, 55 } }, /* from 2003-09-26 02:32:07 CEST */
+      { "Paris",    1064536327, 1067131862, TIME_UNIT_YEAR,  { 0, 1, 0,  0, 58, 55 } },
+      { "New_York", 1730526000, 1730615400, TIME_UNIT_DAY,   { 0, 0, 1,  0, 50,  0 } }, /* 2024-11-02 01:40 EDT until 2024-11-03 01:30 EST */
+   };
+
+   int              bRet = 0;
+   static time64_t  tt1[TEST_DIFF_SIZE];
+   static time64_t  tt2[TEST_DIFF_SIZE];
+   static TIME_DIFF td[TEST_DIFF_SIZE];
+   TIME_ZONE_INFO   tzi;
+   const char **    ppz;
+   size_t           i;
+   size_t           u;
+
+   for(i = 0; i < sizeof(repeated) / sizeof(repeated[0]); ++i)
+   {
+      const TIME_DIFF * pexp = &repeated[i].expected;
+      TIME_DIFF         diff;
+      TIME_DIFF         neg;
+      TIME_DIFF         ref;
+
+      if(!read_TZ(&tzi, pc_find_TZ(repeated[i].zone)))
+      {
+         fprintf(stderr, "read_TZ of %s has failed!\n", repeated[i].zone);
+         goto Exit;
+      }
+
+      test_diff_local_time(repeated[i].t1, repeated[i].t2, repeated[i].unit, &ref, &tzi);
+
+      if(   !diff_time_of_zone(repeated[i].t1, repeated[i].t2, repeated[i].unit, &diff, &tzi)
+         || !diff_time_of_zone(repeated[i].t2, repeated[i].t1, repeated[i].unit, &neg, &tzi)
+         || memcmp(&diff, pexp, sizeof(diff)) || memcmp(&ref, pexp, sizeof(ref))
+         || (neg.years != -pexp->years) || (neg.months  != -pexp->months)  || (neg.days    != -pexp->days)
+         || (neg.hours != -pexp->hours) || (neg.minutes != -pexp->minutes) || (neg.seconds != -pexp->seconds))
+      {
+         fprintf(stderr, "diff_time_of_zone of unit %d is wrong in %s for %lld and %lld in the repeated hour! (%lld %lld %lld %lld:%lld:%lld)\n",
+                 repeated[i].unit, repeated[i].zone, (long long) repeated[i].t1, (long long) repeated[i].t2,
+                 (long long) diff.years, (long long) diff.months, (long long) diff.days,
+                 (long long) diff.hours, (long long) diff.minutes, (long long) diff.seconds);
+         goto Exit;
+      }
+   }
+
+   for(i = 0; i < TEST_DIFF_SIZE; ++i)
+   {
+      if(i & 1)
+      {
+         tt1[i] = (time64_t) (test_random() % ((uint64_t) 86400 * 365 * 200)) - (time64_t) 2208988800LL;
+         tt2[i] = tt1[i] + (time64_t) (test_random() % ((uint64_t) 86400 * 365 * 5));
+      }
+      else
+      {
+         tt1[i] = (time64_t) 1704067200 + (time64_t) (test_random() % ((uint64_t) 86400 * 366));
+         tt2[i] = tt1[i] + (time64_t) (test_random() % ((uint64_t) 86400 * 3));
+      }
+   }
+
+   for(ppz = test_zones; ; ++ppz)
+   {
+      const TIME_ZONE_INFO * pz = *ppz ? &tzi : NULL;
+
+      if(*ppz && !read_TZ(&tzi, pc_find_TZ(*ppz)))
+      {
+         fprintf(stderr, "read_TZ of %s has failed!\n", *ppz);
+         goto Exit;
+      }
+
+      for(u = 0; u < sizeof(units) / sizeof(units[0]); ++u)
+      {
+         if(!diff_time_array_of_zone(tt1, tt2, td, TEST_DIFF_SIZE, units[u], pz))
+         {
+            fprintf(stderr, "diff_time_array_of_zone has failed!\n");
+            goto Exit;
+         }
+
+         for(i = 0; i < TEST_DIFF_SIZE; ++i)
+         {
+            TIME_DIFF ref;
+            TIME_DIFF neg;
+
+            test_diff_local_time(tt1[i], tt2[i], units[u], &ref, pz);
+
+            if(   !diff_time_of_zone(tt2[i], tt1[i], units[u], &neg, pz)
+               || memcmp(&td[i], &ref, sizeof(ref))
+               || (neg.years != -ref.years) || (neg.months  != -ref.months)  || (neg.days    != -ref.days)
+               || (neg.hours != -ref.hours) || (neg.minutes != -ref.minutes) || (neg.seconds != -ref.seconds))
+            {
+               fprintf(stderr, "diff_time_of_zone of unit %d differs in %s for %lld and %lld! (%lld %lld %lld %lld:%lld:%lld != %lld %lld %lld %lld:%lld:%lld)\n",
+                       units[u], *ppz ? *ppz : "UTC", (long long) tt1[i], (long long) tt2[i],
+                       (long long) td[i].years, (long long) td[i].months, (long long) td[i].days,
+                       (long long) td[i].hours, (long long) td[i].minutes, (long long) td[i].seconds,
+                       (long long) ref.years, (long long) ref.months, (long long) ref.days,
+                       (long long) ref.hours, (long long) ref.minutes, (long long) ref.seconds);
+               goto Exit;
+            }
+         }
+      }
+
+      if(!*ppz)
+         break;
+   }
+
+   errno = 0;
+   bRet = 1;
+   Exit:;
+
+   if(!bRet)
+      fprintf(stderr, "Test of diff_time_of_zone and diff_time_array_of_zone has failed!\n\n");
+   else
+      fprintf(stdout, "Test of diff_time_of_zone and diff_time_array_of_zone passed!\n\n");
+   return(bRet);
+} /* int test_diff_time() */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_time_ns checks the floor division of the nanosecond times at the
+   limits and compares the nanosecond conversions with the ones of whole
+   seconds for random times before and after 1970.
+\* ------------------------------------------------------------------------- */
+
+int test_time_ns()
+{
+   static const struct
+   {
+      int64_t      ns;
+      int          digits;
+      const char * zone;
+      const char * expected;
+   }
+   formats[] =
+   {
+      { -1,                                 9, NULL,       "1969-12-31T23:59:59.999999999Z" },
+      { -1,                                 0, "New_York", "1969-12-31T18:59:59-05:00" },
+      { (int64_t) 1711846800 * 1000000000 + 120000000, 3, "Paris", "2024-03-31T03:00:00.120+02:00" },
+      { (int64_t) 1711846799 * 1000000000 + 120000000, 2, "Paris", "2024-03-31T01:59:59.12+01:00" },
+      { INT64_MIN,                          9, NULL,       "1677-09-21T00:12:43.145224192Z" },
+      { INT64_MAX,                          6, "UTC",      "2262-04-11T23:47:16.854775+00:00" },
+   };
+
+   int            bRet = 0;
+   TIME_ZONE_INFO tzi;
+   const char **  ppz;
+   char           buf[TIME_FORMAT_NS_SIZE];
+   struct tm      tm;
+   struct tm      tm2;
+   int32_t        nsec;
+   size_t         i;
+
+   if((split_time_ns(-1, &nsec) != -1) || (nsec != 999999999)
+   || (split_time_ns(-1000000000, &nsec) != -1) || (nsec != 0)
+   || (split_time_ns(INT64_MIN, &nsec) != -(time64_t) 9223372037) || (nsec != 145224192)
+   || (join_time_ns(-(time64_t) 9223372037, 145224192) != INT64_MIN)
+   || (join_time_ns((time64_t) 9223372036, 854775807) != INT64_MAX)
+   || (join_time_ns(-2, 1999999999) != -1) || errno)
+   {
+      fprintf(stderr, "split_time_ns or join_time_ns is wrong at the limits!\n");
+      goto Exit;
+   }
+
+   if((join_time_ns((time64_t) 9223372036, 854775808) != -1) || !errno
+   || ((errno = 0), join_time_ns(-(time64_t) 9223372037, 145224191) != -1) || !errno
+   || ((errno = 0), join_time_ns(INT64_MAX, 0) != -1) || !errno)
+   {
+      fprintf(stderr, "join_time_ns doesn't detect an overflow!\n");
+      goto Exit;
+   }
+
+   errno = 0;
+
+   for(ppz = test_zones; ; ++ppz)
+   {
+      const TIME_ZONE_INFO * pz = *ppz ? &tzi : NULL;
+
+      if(*ppz && !read_TZ(&tzi, pc_find_TZ(*ppz)))
+      {
+         fprintf(stderr, "read_TZ of %s has failed!\n", *ppz);
+         goto Exit;
+      }
+
+      for(i = 0; i < 10000; ++i)
+      {
+         int64_t  ns = (int64_t) test_random();
+         time64_t t  = ns / 1000000000 - (ns % 1000000000 < 0);
+         int      failed;
+
+         if(pz)
+         {
+            failed = !localtime_of_zone_ns(ns, &tm, &nsec, pz) || !localtime_of_zone(t, &tm2, pz)
+                  || (mktime_of_zone_ns(&tm, nsec, pz) != ns);
+         }
+         else
+         {
+            failed = !new_gmtime_ns_r(ns, &tm, &nsec) || !new_gmtime_r(t, &tm2)
+                  || (new_timegm_ns(&tm, nsec) != ns);
+         }
+
+         failed |= (nsec != (int32_t) (ns % 1000000000 + (ns % 1000000000 < 0 ? 1000000000 : 0)))
+                || (tm.tm_year != tm2.tm_year) || (tm.tm_yday != tm2.tm_yday) || (tm.tm_hour != tm2.tm_hour)
+                || (tm.tm_min != tm2.tm_min) || (tm.tm_sec != tm2.tm_sec) || (tm.tm_isdst != tm2.tm_isdst) || errno;
+
+         if(failed)
+         {
+            fprintf(stderr, "The nanosecond conversion is wrong in %s for time %lld!\n", *ppz ? *ppz : "UTC", (long long) ns);
+            goto Exit;
+         }
+      }
+
+      if(!*ppz)
+         break;
+   }
+
+   /* 12/31/1969 23:59:59 UTC is -1 s without an error */
+   new_gmtime_r(-1, &tm);
+   if((new_timegm_ns(&tm, 500000000) != -500000000) || errno)
+   {
+      fprintf(stderr, "new_timegm_ns is wrong for the last second before 1970!\n");
+      goto Exit;
+   }
+
+   for(i = 0; i < sizeof(formats) / sizeof(formats[0]); ++i)
+   {
+      const TIME_ZONE_INFO * pz = formats[i].zone ? &tzi : NULL;
+
+      if(pz && !read_TZ(&tzi, pc_find_TZ(formats[i].zone)))
+      {
+         fprintf(stderr, "read_TZ of %s has failed!\n", formats[i].zone);
+         goto Exit;
+      }
+
+      if((format_time_of_zone_ns(formats[i].ns, formats[i].digits, buf, sizeof(buf), pz) != strlen(formats[i].expected))
+      || strcmp(buf, formats[i].expected))
+      {
+         fprintf(stderr, "format_time_of_zone_ns returns %s instead of %s!\n", buf, formats[i].expected);
+         goto Exit;
+      }
+   }
+
+   if(format_time_of_zone_ns(-1, 9, buf, 30, NULL) || (errno != ERANGE)
+   || ((errno = 0), format_time_of_zone_ns(-1, 10, buf, sizeof(buf), NULL)) || (errno != EINVAL))
+   {
+      fprintf(stderr, "format_time_of_zone_ns doesn't detect invalid arguments!\n");
+      goto Exit;
+   }
+
+   errno = 0;
+   bRet = 1;
+   Exit:;
+
+   if(!bRet)
+      fprintf(stderr, "Test of the nanosecond conversions has failed!\n\n");
+   else
+      fprintf(stdout, "Test of the nanosecond conversions passed!\n\n");
+   return(bRet);
+} /* int test_time_ns() */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_time_ns_wide checks the wide-range nanosecond times against the
+   nanosecond times and the arithmetic at the limits of a time64_t.
+\* ------------------------------------------------------------------------- */
+
+int test_time_ns_wide()
+{
+   int       bRet = 0;
+   TIME_NS   ts;
+   TIME_NS   ts2;
+   TIME_NS   dur;
+   TIME_NS   res;
+   struct tm tm;
+   char      buf[TIME_FORMAT_NS_SIZE];
+   int       i;
+
+   if(!make_time_ns(&ts, 0, -1) || (ts.sec != -1) || (ts.nsec != 999999999)
+   || !make_time_ns(&ts, 5, INT64_MIN) || (ts.sec != 5 - (time64_t) 9223372037) || (ts.nsec != 145224192)
+   || !make_time_ns(&ts, INT64_MIN, 999999999) || (ts.sec != INT64_MIN) || (ts.nsec != 999999999)
+   || make_time_ns(&ts, INT64_MAX, 1000000000) || (errno == 0)
+   || ((errno = 0), make_time_ns(&ts, INT64_MIN, -1)) || (errno == 0))
+   {
+      fprintf(stderr, "make_time_ns is wrong at the limits!\n");
+      goto Exit;
+   }
+
+   errno = 0;
+
+   for(i = 0; i < 100000; ++i)
+   {
+      int64_t ns1 = (int64_t) test_random() >> 2;
+      int64_t ns2 = (int64_t) test_random() >> 2;
+      int     cmp = (ns1 > ns2) - (ns1 < ns2);
+
+      make_time_ns(&ts,  0, ns1);
+      make_time_ns(&ts2, 0, ns2);
+
+      if(!add_time_ns(&res, &ts, &ts2) || (ns_of_time_ns(&res) != ns1 + ns2)
+      || !sub_time_ns(&res, &ts, &ts2) || (ns_of_time_ns(&res) != ns1 - ns2)
+      || (compare_time_ns(&ts, &ts2) != cmp) || errno)
+      {
+         fprintf(stderr, "The arithmetic of TIME_NS is wrong for %lld and %lld ns!\n", (long long) ns1, (long long) ns2);
+         goto Exit;
+      }
+
+      /* wide times and durations that may overflow */
+      ts.sec   = (time64_t) test_random();
+      dur.sec  = (time64_t) test_random() >> (test_random() % 64);
+      dur.nsec = (int32_t) (test_random() % 1000000000);
+
+      if(add_time_ns(&res, &ts, &dur))
+      {
+         if(!sub_time_ns(&ts2, &res, &dur) || compare_time_ns(&ts2, &ts)
+         || !sub_time_ns(&ts2, &res, &ts) || compare_time_ns(&ts2, &dur)
+         || (compare_time_ns(&res, &ts) != (dur.sec < 0 ? -1 : (dur.sec || dur.nsec))))
+         {
+            fprintf(stderr, "The arithmetic of TIME_NS is wrong for %lld s and %lld s!\n", (long long) ts.sec, (long long) dur.sec);
+            goto Exit;
+         }
+      }
+      else if((errno == 0) || ((dur.sec > 0) && (ts.sec < INT64_MAX - dur.sec)) || ((dur.sec < 0) && (ts.sec > INT64_MIN - dur.sec - 1)))
+      {
+         fprintf(stderr, "add_time_ns fails for %lld s and %lld s!\n", (long long) ts.sec, (long long) dur.sec);
+         goto Exit;
+      }
+
+      errno = 0;
+   }
+
+   /* the limits of a time64_t */
+   ts.sec   = INT64_MIN;
+   ts.nsec  = 0;
+   ts2.sec  = INT64_MAX;
+   ts2.nsec = 999999999;
+
+   if(!sub_time_ns(&res, &ts, &ts) || res.sec || res.nsec
+   || !sub_time_ns(&res, &ts2, &ts2) || res.sec || res.nsec
+   || sub_time_ns(&res, &ts2, &ts) || (errno == 0)
+   || ((errno = 0), !make_time_ns(&ts2, -1, 999999999)) || !sub_time_ns(&res, &ts2, &ts)
+   || (res.sec != INT64_MAX) || (res.nsec != 999999999)
+   || ((errno = 0), !make_time_ns(&dur, 0, 1)) || add_time_ns(&ts, &res, &dur) || (errno == 0))
+   {
+      fprintf(stderr, "The arithmetic of TIME_NS is wrong at the limits of a time64_t!\n");
+      goto Exit;
+   }
+
+   errno = 0;
+   memset(&tm, 0, sizeof(tm));
+   tm.tm_mday = 1;
+   tm.tm_year = -1 - 1900;
+   ts.sec     = new_timegm(&tm);
+   ts.nsec    = 500000000;
+   tm.tm_year = 12024 - 1900;
+   ts2.sec    = new_timegm(&tm);
+   ts2.nsec   = 0;
+
+   if(!format_time_ns_of_zone(&ts, 1, buf, sizeof(buf), NULL) || strcmp(buf, "-0001-01-01T00:00:00.5Z")
+   || !format_time_ns_of_zone(&ts2, 0, buf, sizeof(buf), NULL) || strcmp(buf, "+12024-01-01T00:00:00Z"))
+   {
+      fprintf(stderr, "format_time_ns_of_zone returns %s for an expanded year!\n", buf);
+      goto Exit;
+   }
+
+   ts.sec = INT64_MAX;
+   if(format_time_ns_of_zone(&ts, 0, buf, sizeof(buf), NULL) || (errno == 0))
+   {
+      fprintf(stderr, "format_time_ns_of_zone doesn't fail for a year out of the range of an int!\n");
+      goto Exit;
+   }
+
+   errno = 0;
+   bRet = 1;
+   Exit:;
+
+   if(!bRet)
+      fprintf(stderr, "Test of the wide-range nanosecond times has failed!\n\n");
+   else
+      fprintf(stdout, "Test of the wide-range nanosecond times passed!\n\n");
+   return(bRet);
+} /* int test_time_ns_wide() */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_localtime_of_zones compares localtime_of_zones with localtime_of_zone
+   and new_gmtime_r for random times in all test zones and in zones with the
+   largest offsets.
+\* ------------------------------------------------------------------------- */
+
+#define TEST_ZONES_COUNT   11
+
+int test_localtime_of_zones()
+{
+   static const char * extra_zones[] = { "<+24>-24", "<-24>24", "<-10>10<-09>9,M3.2.0,M11.1.0" };
+
+   int                    bRet = 0;
+   TIME_ZONE_INFO         tzi[TEST_ZONES_COUNT];
+   const TIME_ZONE_INFO * pzones[TEST_ZONES_COUNT];
+   struct tm              tm[TEST_ZONES_COUNT];
+   struct tm              tm2;
+   int32_t                offset[TEST_ZONES_COUNT];
+   int32_t                isdst[TEST_ZONES_COUNT];
+   uint8_t                err[(TEST_ZONES_COUNT + 7) / 8];
+   size_t                 count = 0;
+   size_t                 i;
+   int                    j;
+
+   for(i = 0; test_zones[i]; ++i, ++count)
+   {
+      pzones[count] = &tzi[count];
+
+      if(!read_TZ(&tzi[count], pc_find_TZ(test_zones[i])))
+      {
+         fprintf(stderr, "read_TZ of %s has failed!\n", test_zones[i]);
+         goto Exit;
+      }
+   }
+
+   for(i = 0; i < sizeof(extra_zones) / sizeof(extra_zones[0]); ++i, ++count)
+   {
+      pzones[count] = &tzi[count];
+
+      if(!read_TZ(&tzi[count], extra_zones[i]))
+      {
+         fprintf(stderr, "read_TZ of %s has failed!\n", extra_zones[i]);
+         goto Exit;
+      }
+   }
+
+   pzones[count++] = NULL;
+
+   for(j = 0; j < 100000; ++j)
+   {
+      time64_t t = (time64_t) (test_random() % ((uint64_t) 86400 * 365 * 6000)) - (time64_t) 86400 * 365 * 3970;
+
+      if(j & 1)
+         t -= t % 1800; /* hit the changes of the offsets */
+
+      if(localtime_of_zones(t, pzones, count, tm, offset, isdst, err))
+      {
+         fprintf(stderr, "localtime_of_zones fails for time %lld!\n", (long long) t);
+         goto Exit;
+      }
+
+      for(i = 0; i < count; ++i)
+      {
+         int isdst_tm = 0;
+
+         if(pzones[i])
+            localtime_of_zone(t, &tm2, pzones[i]);
+         else
+            new_gmtime_r(t, &tm2);
+
+         if((tm[i].tm_year != tm2.tm_year) || (tm[i].tm_mon != tm2.tm_mon) || (tm[i].tm_mday != tm2.tm_mday)
+         || (tm[i].tm_yday != tm2.tm_yday) || (tm[i].tm_wday != tm2.tm_wday) || (tm[i].tm_hour != tm2.tm_hour)
+         || (tm[i].tm_min != tm2.tm_min) || (tm[i].tm_sec != tm2.tm_sec) || (tm[i].tm_isdst != tm2.tm_isdst)
+         || (isdst[i] != tm2.tm_isdst) || (offset[i] != (pzones[i] ? test_gmtoff(t, pzones[i], &isdst_tm) : 0)))
+         {
+            fprintf(stderr, "localtime_of_zones is wrong in zone %d for time %lld!\n", (int) i, (long long) t);
+            goto Exit;
+         }
+      }
+   }
+
+   /* the local year of the first zone is out of the range of an int */
+   tm2.tm_year = INT_MAX;
+   tm2.tm_mon  = 11;
+   tm2.tm_mday = 31;
+   tm2.tm_hour = 23;
+   tm2.tm_min  = 0;
+   tm2.tm_sec  = 0;
+   pzones[0] = &tzi[count - 4];
+
+   if((localtime_of_zones(new_timegm(&tm2), pzones, 1, tm, NULL, NULL, err) != 1) || (err[0] != 1) || errno)
+   {
+      fprintf(stderr, "localtime_of_zones doesn't detect a year out of range!\n");
+      goto Exit;
+   }
+
+   bRet = 1;
+   Exit:;
+
+   if(!bRet)
+      fprintf(stderr, "Test of localtime_of_zones has failed!\n\n");
+   else
+      fprintf(stdout, "Test of localtime_of_zones passed!\n\n");
+   return(bRet);
+} /* int test_localtime_of_zones() */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_convert_time checks convert_time_of_zone for random local times
+   around the daylight saving changes of the source zone against
+   localtime_of_zone. Unique local times need to have one UTC time, skipped
+   ones none and repeated ones two. The columns need to have the same
+   results as the single conversions.
+\* ------------------------------------------------------------------------- */
+
+#define TEST_CONVERT_SIZE   512
+
+int test_convert_time()
+{
+   static int32_t cols_year[TEST_CONVERT_SIZE];
+   static int8_t  cols_mon[TEST_CONVERT_SIZE];
+   static int8_t  cols_mday[TEST_CONVERT_SIZE];
+   static int8_t  cols_hour[TEST_CONVERT_SIZE];
+   static int8_t  cols_min[TEST_CONVERT_SIZE];
+   static int8_t  cols_sec[TEST_CONVERT_SIZE];
+   static int32_t res_year[TEST_CONVERT_SIZE];
+   static int8_t  res_mon[TEST_CONVERT_SIZE];
+   static int8_t  res_mday[TEST_CONVERT_SIZE];
+   static int8_t  res_hour[TEST_CONVERT_SIZE];
+   static int8_t  res_min[TEST_CONVERT_SIZE];
+   static int8_t  res_sec[TEST_CONVERT_SIZE];
+   static int8_t  res_wday[TEST_CONVERT_SIZE];
+   static int16_t res_yday[TEST_CONVERT_SIZE];
+   static int8_t  res_isdst[TEST_CONVERT_SIZE];
+   static int32_t res_gmtoff[TEST_CONVERT_SIZE];
+   static int8_t  kinds[TEST_CONVERT_SIZE];
+   static uint8_t err[TEST_CONVERT_SIZE / 8];
+
+   int            bRet = 0;
+   TIME_ZONE_INFO tzi_from;
+   TIME_ZONE_INFO tzi_to;
+   TIME_COLUMNS   cols;
+   TIME_COLUMNS   res;
+   struct tm      tm;
+   struct tm      tm_earlier;
+   struct tm      tm_later;
+   struct tm      tm2;
+   const char **  ppfrom;
+   int            i;
+
+   memset(&cols, 0, sizeof(cols));
+   cols.year = cols_year;
+   cols.mon  = cols_mon;
+   cols.mday = cols_mday;
+   cols.hour = cols_hour;
+   cols.min  = cols_min;
+   cols.sec  = cols_sec;
+
+   res.year   = res_year;
+   res.mon    = res_mon;
+   res.mday   = res_mday;
+   res.hour   = res_hour;
+   res.min    = res_min;
+   res.sec    = res_sec;
+   res.wday   = res_wday;
+   res.yday   = res_yday;
+   res.isdst  = res_isdst;
+   res.gmtoff = res_gmtoff;
+
+   for(ppfrom = test_zones; *ppfrom; ++ppfrom)
+   {
+      const char ** ppto;
+
+      if(!read_TZ(&tzi_from, pc_find_TZ(*ppfrom)))
+      {
+         fprintf(stderr, "read_TZ of %s has failed!\n", *ppfrom);
+         goto Exit;
+      }
+
+      for(ppto = test_zones; ; ++ppto)
+      {
+         const TIME_ZONE_INFO * pto = *ppto ? &tzi_to : NULL;
+
+         if(*ppto && !read_TZ(&tzi_to, pc_find_TZ(*ppto)))
+         {
+            fprintf(stderr, "read_TZ of %s has failed!\n", *ppto);
+            goto Exit;
+         }
+
+         for(i = 0; i < TEST_CONVERT_SIZE; ++i)
+         {
+            TIME_ZONE_TRANSITION tr;
+            time64_t t = (time64_t) (test_random() % ((uint64_t) 86400 * 365 * 6000)) - (time64_t) 86400 * 365 * 3970;
+            time64_t t_earlier;
+            time64_t t_later;
+            time64_t t_compatible;
+            int      kind;
+            int      kind2;
+            int      back_earlier;
+            int      back_later;
+            int      failed;
+
+            /* a local time within one hour around the begin of a transition */
+            if(next_transition(t, &tr, &tzi_from))
+               t = tr.time - 1;
+
+            localtime_of_zone(t, &tm, &tzi_from);
+            new_gmtime_r(new_timegm(&tm) + (time64_t) (test_random() % 7200) - 3599, &tm);
+
+            cols_year[i] = tm.tm_year;
+            cols_mon[i]  = (int8_t) tm.tm_mon;
+            cols_mday[i] = (int8_t) tm.tm_mday;
+            cols_hour[i] = (int8_t) tm.tm_hour;
+            cols_min[i]  = (int8_t) tm.tm_min;
+            cols_sec[i]  = (int8_t) tm.tm_sec;
+
+            kind  = convert_time_of_zone(&tm, &tzi_from, TIME_LOCAL_EARLIER, &tm_earlier, pto, &t_earlier);
+            kind2 = convert_time_of_zone(&tm, &tzi_from, TIME_LOCAL_LATER,   &tm_later,   pto, &t_later);
+
+            localtime_of_zone(t_earlier, &tm2, &tzi_from);
+            back_earlier = (tm2.tm_year == tm.tm_year) && (tm2.tm_yday == tm.tm_yday) && (tm2.tm_hour == tm.tm_hour) && (tm2.tm_min == tm.tm_min) && (tm2.tm_sec == tm.tm_sec);
+            localtime_of_zone(t_later, &tm2, &tzi_from);
+            back_later   = (tm2.tm_year == tm.tm_year) && (tm2.tm_yday == tm.tm_yday) && (tm2.tm_hour == tm.tm_hour) && (tm2.tm_min == tm.tm_min) && (tm2.tm_sec == tm.tm_sec);
+
+            failed = (kind < 0) || (kind != kind2) || errno;
+
+            if(kind == TIME_LOCAL_UNIQUE)
+               failed |= (t_earlier != t_later) || !back_earlier;
+            else if(kind == TIME_LOCAL_REPEATED)
+               failed |= (t_earlier >= t_later) || !back_earlier || !back_later;
+            else
+               failed |= (t_earlier >= t_later) || back_earlier || back_later;
+
+            if(pto)
+               localtime_of_zone(t_earlier, &tm2, pto);
+            else
+               new_gmtime_r(t_earlier, &tm2);
+
+            failed |= (tm2.tm_year != tm_earlier.tm_year) || (tm2.tm_mon != tm_earlier.tm_mon) || (tm2.tm_mday != tm_earlier.tm_mday)
+                   || (tm2.tm_yday != tm_earlier.tm_yday) || (tm2.tm_wday != tm_earlier.tm_wday) || (tm2.tm_hour != tm_earlier.tm_hour)
+                   || (tm2.tm_min != tm_earlier.tm_min) || (tm2.tm_sec != tm_earlier.tm_sec) || (tm2.tm_isdst != tm_earlier.tm_isdst);
+
+            /* the compatible policy and the rejection */
+            failed |= (convert_time_of_zone(&tm, &tzi_from, TIME_LOCAL_COMPATIBLE, &tm2, pto, &t_compatible) != kind)
+                   || (t_compatible != (kind == TIME_LOCAL_SKIPPED ? t_later : t_earlier));
+
+            if(kind == TIME_LOCAL_UNIQUE)
+            {
+               tm.tm_isdst = -1;
+               failed |= (convert_time_of_zone(&tm, &tzi_from, TIME_LOCAL_REJECT, &tm2, pto, NULL) != kind) || (mktime_of_zone(&tm, &tzi_from) != t_earlier);
+            }
+            else
+            {
+               failed |= (convert_time_of_zone(&tm, &tzi_from, TIME_LOCAL_REJECT, &tm2, pto, NULL) != -1) || (errno != ERANGE);
+               errno = 0;
+            }
+
+            if(failed)
+            {
+               fprintf(stderr, "convert_time_of_zone is wrong from %s to %s for the local time %d-%02d-%02d %02d:%02d:%02d!\n",
+                       *ppfrom, *ppto ? *ppto : "UTC", tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec);
+               goto Exit;
+            }
+         }
+
+         /* the columns need the same results as the single conversions */
+         if(convert_columns_of_zone(&cols, TEST_CONVERT_SIZE, &tzi_from, TIME_LOCAL_EARLIER, &res, pto, kinds, err) || errno)
+         {
+            fprintf(stderr, "convert_columns_of_zone fails from %s to %s!\n", *ppfrom, *ppto ? *ppto : "UTC");
+            goto Exit;
+         }
+
+         for(i = 0; i < TEST_CONVERT_SIZE; ++i)
+         {
+            time64_t t_earlier;
+
+            memset(&tm, 0, sizeof(tm));
+            tm.tm_year = cols_year[i];
+            tm.tm_mon  = cols_mon[i];
+            tm.tm_mday = cols_mday[i];
+            tm.tm_hour = cols_hour[i];
+            tm.tm_min  = cols_min[i];
+            tm.tm_sec  = cols_sec[i];
+
+            if((convert_time_of_zone(&tm, &tzi_from, TIME_LOCAL_EARLIER, &tm2, pto, &t_earlier) != kinds[i])
+            || (tm2.tm_year != res_year[i]) || (tm2.tm_mon != res_mon[i]) || (tm2.tm_mday != res_mday[i])
+            || (tm2.tm_hour != res_hour[i]) || (tm2.tm_min != res_min[i]) || (tm2.tm_sec != res_sec[i])
+            || (tm2.tm_wday != res_wday[i]) || (tm2.tm_yday != res_yday[i]) || (tm2.tm_isdst != res_isdst[i])
+            || (utc_offset_of_zone(t_earlier, pto, NULL, NULL, NULL) != res_gmtoff[i]))
+            {
+               fprintf(stderr, "convert_columns_of_zone is wrong from %s to %s for element %d!\n", *ppfrom, *ppto ? *ppto : "UTC", i);
+               goto Exit;
+            }
+         }
+
+         if(!*ppto)
+            break;
+      }
+   }
+
+   /* invalid fields and rejected local times in the columns */
+   cols_mday[0] = 31;
+   cols_mon[0]  = 1;
+   cols_hour[1] = 24;
+   cols_year[2] = 2024 - 1900; /* 3/31/2024 02:30 is skipped in Paris */
+   cols_mon[2]  = 2;
+   cols_mday[2] = 31;
+   cols_hour[2] = 2;
+   cols_min[2]  = 30;
+   read_TZ(&tzi_from, pc_find_TZ("Paris"));
+
+   if((convert_columns_of_zone(&cols, 3, &tzi_from, TIME_LOCAL_REJECT, &res, NULL, kinds, err) != 3) || (err[0] != 7)
+   || (kinds[0] != -1) || (kinds[1] != -1) || (kinds[2] != TIME_LOCAL_SKIPPED) || errno)
+   {
+      fprintf(stderr, "convert_columns_of_zone doesn't detect invalid fields!\n");
+      goto Exit;
+   }
+
+   bRet = 1;
+   Exit:;
+
+   if(!bRet)
+      fprintf(stderr, "Test of convert_time_of_zone has failed!\n\n");
+   else
+      fprintf(stdout, "Test of convert_time_of_zone passed!\n\n");
+   return(bRet);
+} /* int test_convert_time() */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_time_pool compares the batch functions of a pool with the ones of a
+   single thread. The pool has only the calling thread if time_api.c isn't
+   compiled with TIME_API_ENABLE_THREADS.
+\* ------------------------------------------------------------------------- */
+
+int test_time_pool()
+{
+   static struct tm stm[TEST_ARRAY_SIZE];
+   static time64_t  tt[TEST_ARRAY_SIZE];
+   static time64_t  tt2[TEST_ARRAY_SIZE];
+   static time64_t  tt3[TEST_ARRAY_SIZE];
+   static int32_t   year[2][TEST_ARRAY_SIZE];
+   static int8_t    mon[2][TEST_ARRAY_SIZE];
+   static int8_t    mday[2][TEST_ARRAY_SIZE];
+   static int8_t    hour[2][TEST_ARRAY_SIZE];
+   static int8_t    min[2][TEST_ARRAY_SIZE];
+   static int8_t    sec[2][TEST_ARRAY_SIZE];
+   static int8_t    isdst[2][TEST_ARRAY_SIZE];
+   static uint8_t   err[2][(TEST_ARRAY_SIZE + 7) / 8];
+   int              bRet = 0;
+   TIME_POOL *      pool = create_time_pool(4);
+   TIME_ZONE_INFO   tzi;
+   TIME_COLUMNS     cols[2];
+   size_t           errors[2];
+   const char **    ppz;
+   int              j;
+   size_t           i;
+
+   if(!pool || ((get_time_pool_threads(pool) != 4) && (get_time_pool_threads(pool) != 1)))
+   {
+      fprintf(stderr, "create_time_pool has failed!\n");
+      goto Exit;
+   }
+
+   fprintf(stdout, "The pool has %d threads.\n", get_time_pool_threads(pool));
+
+   for(j = 0; j < 2; ++j)
+   {
+      memset(&cols[j], 0, sizeof(cols[j]));
+      cols[j].year  = year[j];
+      cols[j].mon   = mon[j];
+      cols[j].mday  = mday[j];
+      cols[j].hour  = hour[j];
+      cols[j].min   = min[j];
+      cols[j].sec   = sec[j];
+      cols[j].isdst = isdst[j];
+   }
+
+   for(i = 0; i < TEST_ARRAY_SIZE; ++i)
+   {
+      random_tm(&stm[i]);
+      tt[i] = (time64_t) (test_random() % ((uint64_t) 86400 * 365 * 40000)) - (time64_t) 86400 * 365 * 20000;
+   }
+
+   for(ppz = test_zones; ; ++ppz)
+   {
+      const TIME_ZONE_INFO * pz = *ppz ? &tzi : NULL;
+
+      if(*ppz && !read_TZ(&tzi, pc_find_TZ(*ppz)))
+      {
+         fprintf(stderr, "read_TZ of %s has failed!\n", *ppz);
+         goto Exit;
+      }
+
+      memset(err, 0xFF, sizeof(err));
+
+      if(pz)
+      {
+         errors[0] = mktime_of_zone_array_mt(pool, stm, tt2, err[0], TEST_ARRAY_SIZE, pz);
+         errors[1] = mktime_of_zone_array(stm, tt3, err[1], TEST_ARRAY_SIZE, pz);
+      }
+      else
+      {
+         errors[0] = new_timegm_array_mt(pool, stm, tt2, err[0], TEST_ARRAY_SIZE);
+         errors[1] = new_timegm_array(stm, tt3, err[1], TEST_ARRAY_SIZE);
+      }
+
+      if(!errors[0] || (errors[0] != errors[1]) || memcmp(err[0], err[1], sizeof(err[0])) || memcmp(tt2, tt3, sizeof(tt2)))
+      {
+         fprintf(stderr, "The array conversion of a pool is wrong in %s!\n", *ppz ? *ppz : "UTC");
+         goto Exit;
+      }
+
+      errors[0] = localtime_columns_of_zone_mt(pool, tt, TEST_ARRAY_SIZE, &cols[0], err[0], pz);
+      errors[1] = localtime_columns_of_zone(tt, TEST_ARRAY_SIZE, &cols[1], err[1], pz);
+
+      if(errors[0] || errors[1] || memcmp(err[0], err[1], sizeof(err[0]))
+      || memcmp(year[0], year[1], sizeof(year[0])) || memcmp(mon[0], mon[1], sizeof(mon[0])) || memcmp(mday[0], mday[1], sizeof(mday[0]))
+      || memcmp(hour[0], hour[1], sizeof(hour[0])) || memcmp(min[0], min[1], sizeof(min[0])) || memcmp(sec[0], sec[1], sizeof(sec[0]))
+      || memcmp(isdst[0], isdst[1], sizeof(isdst[0])))
+      {
+         fprintf(stderr, "The columnar conversion of a pool is wrong in %s!\n", *ppz ? *ppz : "UTC");
+         goto Exit;
+      }
+
+      errors[0] = mktime_columns_of_zone_mt(pool, &cols[0], TEST_ARRAY_SIZE, tt2, err[0], pz);
+
+      if(errors[0] || memcmp(tt, tt2, sizeof(tt)))
+      {
+         fprintf(stderr, "The columnar conversion of a pool into times is wrong in %s!\n", *ppz ? *ppz : "UTC");
+         goto Exit;
+      }
+
+      if(!*ppz)
+         break;
+   }
+
+   bRet = 1;
+   Exit:;
+
+   destroy_time_pool(pool);
+
+   if(!bRet)
+      fprintf(stderr, "Test of the conversions of a time pool has failed!\n\n");
+   else
+      fprintf(stdout, "Test of the conversions of a time pool passed!\n\n");
+   return(bRet);
+} /* int test_time_pool() */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_zone_ids compares localtime_columns_of_zone_ids for random times in
+   random zones of a registry with localtime_of_zone. A few zone ids are
+   out of the range of the registry.
+\* ------------------------------------------------------------------------- */
+
+int test_zone_ids()
+{
+   static time64_t  tt[TEST_ARRAY_SIZE];
+   static uint16_t  ids[TEST_ARRAY_SIZE];
+   static int32_t   year[TEST_ARRAY_SIZE];
+   static int8_t    mon[TEST_ARRAY_SIZE];
+   static int8_t    mday[TEST_ARRAY_SIZE];
+   static int8_t    hour[TEST_ARRAY_SIZE];
+   static int8_t    min[TEST_ARRAY_SIZE];
+   static int8_t    sec[TEST_ARRAY_SIZE];
+   static int8_t    wday[TEST_ARRAY_SIZE];
+   static int16_t   yday[TEST_ARRAY_SIZE];
+   static int8_t    isdst[TEST_ARRAY_SIZE];
+   static int32_t   gmtoff[TEST_ARRAY_SIZE];
+   static uint8_t   err[(TEST_ARRAY_SIZE + 7) / 8];
+   int              bRet = 0;
+   TIME_ZONE_INFO   zones[TEST_ZONES_COUNT];
+   TIME_COLUMNS     cols;
+   size_t           zone_count;
+   size_t           invalid = 0;
+   size_t           i;
+
+   cols.year = year;   cols.mon  = mon;  cols.mday = mday; cols.hour  = hour;  cols.min    = min;
+   cols.sec  = sec;    cols.wday = wday; cols.yday = yday; cols.isdst = isdst; cols.gmtoff = gmtoff;
+
+   for(zone_count = 0; test_zones[zone_count]; ++zone_count)
+   {
+      if(!read_TZ(&zones[zone_count], pc_find_TZ(test_zones[zone_count])))
+      {
+         fprintf(stderr, "read_TZ of %s has failed!\n", test_zones[zone_count]);
+         goto Exit;
+      }
+   }
+
+   for(i = 0; i < TEST_ARRAY_SIZE; ++i)
+   {
+      tt[i]   = (time64_t) (test_random() % ((uint64_t) 86400 * 365 * 40000)) - (time64_t) 86400 * 365 * 20000;
+      ids[i]  = (uint16_t) (test_random() % (zone_count + 1));
+      year[i] = INT32_MIN;
+
+      if(i % 3000 < 1000)
+         ids[i] = (uint16_t) (i / 3000 % zone_count); /* longer runs of the same zone */
+   }
+
+   invalid = 0;
+   for(i = 0; i < TEST_ARRAY_SIZE; ++i)
+      invalid += (ids[i] >= zone_count);
+
+   memset(err, 0xFF, sizeof(err));
+
+   if(localtime_columns_of_zone_ids(tt, ids, TEST_ARRAY_SIZE, zones, zone_count, &cols, err) != invalid)
+   {
+      fprintf(stderr, "localtime_columns_of_zone_ids returns a wrong number of invalid elements!\n");
+      goto Exit;
+   }
+
+   for(i = 0; i < TEST_ARRAY_SIZE; ++i)
+   {
+      struct tm stm;
+      int       bad = (err[i / 8] >> (i % 8)) & 1;
+
+      if(ids[i] >= zone_count)
+      {
+         if(!bad || (year[i] != INT32_MIN))
+         {
+            fprintf(stderr, "localtime_columns_of_zone_ids doesn't detect the invalid zone id of element %d!\n", (int) i);
+            goto Exit;
+         }
+
+         continue;
+      }
+
+      localtime_of_zone(tt[i], &stm, &zones[ids[i]]);
+
+      if(   bad
+         || (stm.tm_year  != year[i])
+         || (stm.tm_mon   != mon[i])
+         || (stm.tm_mday  != mday[i])
+         || (stm.tm_hour  != hour[i])
+         || (stm.tm_min   != min[i])
+         || (stm.tm_sec   != sec[i])
+         || (stm.tm_wday  != wday[i])
+         || (stm.tm_yday  != yday[i])
+         || (stm.tm_isdst != isdst[i])
+         || (utc_offset_of_zone(tt[i], &zones[ids[i]], NULL, NULL, NULL) != gmtoff[i]))
+      {
+         fprintf(stderr, "localtime_columns_of_zone_ids is wrong for element %d in %s!\n", (int) i, test_zones[ids[i]]);
+         goto Exit;
+      }
+   }
+
+   bRet = 1;
+   Exit:;
+
+   if(!bRet)
+      fprintf(stderr, "Test of localtime_columns_of_zone_ids has failed!\n\n");
+   else
+      fprintf(stdout, "Test of localtime_columns_of_zone_ids passed!\n\n");
+   return(bRet);
+} /* int test_zone_ids() */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_parse_time checks parse_time_of_zone_ns with a few fixed times and
+   parses the formatted random times of all test zones back.
+\* ------------------------------------------------------------------------- */
+
+int test_parse_time()
+{
+   static const struct
+   {
+      const char * str;
+      const char * zone;
+      size_t       used;
+      int64_t      ns;
+   }
+   parses[] =
+   {
+      { "1970-01-01T00:00:00Z",                NULL,       20, 0 },
+      { "1969-12-31 23:59:59.999999999999 x",  NULL,       32, -1 },
+      { "2024-03-31T03:00:00,12+0200",         NULL,       27, (int64_t) 1711846800 * 1000000000 + 120000000 },
+      { "2024-03-31t01:59:59.5-01",            NULL,       24, (int64_t) 1711853999 * 1000000000 + 500000000 },
+      { "2024-03-31T02:30:00",                 "Paris",    19, (int64_t) 1711848600 * 1000000000 },  /* skipped, taken as 03:30 */
+      { "2024-10-27T02:30:00.1",               "Paris",    21, (int64_t) 1729989000 * 1000000000 + 100000000 }, /* repeated, the earlier */
+      { "2016-12-31T23:59:60Z",                NULL,       20, (int64_t) 1483228800 * 1000000000 },
+   };
+
+   static const char * const invalid[] =
+   {
+      "2024-02-30T00:00:00Z", "2024-01-01T24:00:00Z", "2024-01-01T00:00:00.Z", "2024-01-01X00:00:00Z",
+      "2024-01-01T00:00:00+24:00", "2024-1-01T00:00:00Z", "2024-01-01T00:00",
+   };
+
+   int            bRet = 0;
+   TIME_ZONE_INFO tzi;
+   const char **  ppz;
+   char           buf[TIME_FORMAT_NS_SIZE];
+   int64_t        ns;
+   size_t         i;
+
+   for(i = 0; i < sizeof(parses) / sizeof(parses[0]); ++i)
+   {
+      const TIME_ZONE_INFO * pz = parses[i].zone ? &tzi : NULL;
+
+      if(pz && !read_TZ(&tzi, pc_find_TZ(parses[i].zone)))
+      {
+         fprintf(stderr, "read_TZ of %s has failed!\n", parses[i].zone);
+         goto Exit;
+      }
+
+      if((parse_time_of_zone_ns(parses[i].str, strlen(parses[i].str), &ns, pz) != parses[i].used) || (ns != parses[i].ns) || errno)
+      {
+         fprintf(stderr, "parse_time_of_zone_ns is wrong for %s!\n", parses[i].str);
+         goto Exit;
+      }
+   }
+
+   for(i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i)
+   {
+      if(parse_time_of_zone_ns(invalid[i], strlen(invalid[i]), &ns, NULL) || (errno != EINVAL))
+      {
+         fprintf(stderr, "parse_time_of_zone_ns doesn't reject %s!\n", invalid[i]);
+         goto Exit;
+      }
+
+      errno = 0;
+   }
+
+   if(parse_time_of_zone_ns("2262-04-11T23:47:16.854775808Z", 30, &ns, NULL) || (errno != EOVERFLOW)
+   || ((errno = 0), parse_time_of_zone_ns("2024-01-01T00:00:00Z", 18, &ns, NULL)) || (errno != EINVAL))
+   {
+      fprintf(stderr, "parse_time_of_zone_ns doesn't detect an overflow or a short string!\n");
+      goto Exit;
+   }
+
+   errno = 0;
+
+   for(ppz = test_zones; ; ++ppz)
+   {
+      const TIME_ZONE_INFO * pz = *ppz ? &tzi : NULL;
+
+      if(*ppz && !read_TZ(&tzi, pc_find_TZ(*ppz)))
+      {
+         fprintf(stderr, "read_TZ of %s has failed!\n", *ppz);
+         goto Exit;
+      }
+
+      for(i = 0; i < 10000; ++i)
+      {
+         int64_t ns1 = (int64_t) test_random();
+         size_t  len = format_time_of_zone_ns(ns1, 9, buf, sizeof(buf), pz);
+
+         if(!len || (parse_time_of_zone_ns(buf, len, &ns, NULL) != len) || (ns != ns1) || errno)
+         {
+            fprintf(stderr, "parse_time_of_zone_ns doesn't parse %s back in %s!\n", buf, *ppz ? *ppz : "UTC");
+            goto Exit;
+         }
+      }
+
+      if(!*ppz)
+         break;
+   }
+
+   bRet = 1;
+   Exit:;
+
+   if(!bRet)
+      fprintf(stderr, "Test of the parsing of times has failed!\n\n");
+   else
+      fprintf(stdout, "Test of the parsing of times passed!\n\n");
+   return(bRet);
+} /* int test_parse_time() */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_parse_layout checks parse_times_of_layout with a few fixed strings
+   and compares it with new_timegm for random times of two layouts. Every
+   third element is corrupted by a random character.
+\* ------------------------------------------------------------------------- */
+
+#define TEST_LAYOUT_COUNT  1000
+
+int test_parse_layout()
+{
+   static const struct
+   {
+      const char * layout;
+      const char * str;
+      time64_t     t;
+      int32_t      nsec;
+   }
+   parses[] =
+   {
+      { "YYYY-MM-DDThh:mm:ssZ",             "1970-01-01T00:00:00Z",             0,           0 },
+      { "YYYYMMDDhhmmss",                   "20240229235960",                   1709251200,  0 },
+      { "YYYY-MM-DD",                       "1600-03-01",                       -(time64_t) 11670912000, 0 },
+      { "DD.MM.YYYY hh:mm:ss,fffffffff",    "31.12.9999 23:59:59,999999999",    (time64_t) 253402300799, 999999999 },
+      { "YYYY/MM/DD hh:mm:ss.ff +0000",     "2024/03/31 01:59:59.12 +0000",     1711850399,  120000000 },
+      { "YYYYMMDD",                         "20230229",                         -1,          0 },
+      { "YYYY-MM-DDThh:mm:ssZ",             "2024-01-01T00:00:00z",             -1,          0 },
+      { "YYYY-MM-DDThh:mm:ssZ",             "2024-01-01T24:00:00Z",             -1,          0 },
+      { "YYYY-MM-DDThh:mm:ssZ",             "2024-01-0/T00:00:00Z",             -1,          0 },
+   };
+
+   static const char * const invalid_layouts[] =
+   {
+      "YY-MM-DD", "YYYY-MM", "YYYY-MM-DD hh:mm:ss.ffffffffff", "YYYY-MM-DD-DD", "YYYY-MM-DD hh:mm:ss.fff          Z",
+   };
+
+   static char strings[2][TEST_LAYOUT_COUNT * 25];
+
+   int       bRet = 0;
+   time64_t  t[TEST_LAYOUT_COUNT];
+   time64_t  expected[TEST_LAYOUT_COUNT];
+   int32_t   expected_nsec[TEST_LAYOUT_COUNT];
+   int32_t   nsec[TEST_LAYOUT_COUNT];
+   uint8_t   err[(TEST_LAYOUT_COUNT + 7) / 8];
+   struct tm tm;
+   size_t    errors;
+   size_t    i;
+
+   for(i = 0; i < sizeof(parses) / sizeof(parses[0]); ++i)
+   {
+      errors = parse_times_of_layout(parses[i].layout, parses[i].str, 0, 1, t, nsec, err);
+
+      if((errors != (parses[i].t == -1)) || (err[0] != errors) || (t[0] != parses[i].t) || (nsec[0] != parses[i].nsec) || errno)
+      {
+         fprintf(stderr, "parse_times_of_layout is wrong for %s!\n", parses[i].str);
+         goto Exit;
+      }
+   }
+
+   for(i = 0; i < sizeof(invalid_layouts) / sizeof(invalid_layouts[0]); ++i)
+   {
+      if(parse_times_of_layout(invalid_layouts[i], "2024-01-01 00:00:00.000000000000000", 0, 3, t, NULL, NULL) != 3)
+      {
+         fprintf(stderr, "parse_times_of_layout doesn't reject the layout %s!\n", invalid_layouts[i]);
+         goto Exit;
+      }
+   }
+
+   for(i = 0; i < TEST_LAYOUT_COUNT; ++i)
+   {
+      time64_t tt = (time64_t) (test_random() % (uint64_t) 315537897600) - (time64_t) 62135596800; /* 1/1/0001 until 12/31/9999 */
+      int32_t  ms = (int32_t) (test_random() % 1000);
+
+      new_gmtime_r(tt, &tm);
+      sprintf(strings[0] + (i * 25), "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ", tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec, ms);
+      memcpy(strings[1] + (i * 14), strings[0] + (i * 25), 4);      /* YYYYMMDDhhmmss without terminations */
+      memcpy(strings[1] + (i * 14) + 4, strings[0] + (i * 25) + 5, 2);
+      memcpy(strings[1] + (i * 14) + 6, strings[0] + (i * 25) + 8, 2);
+      memcpy(strings[1] + (i * 14) + 8, strings[0] + (i * 25) + 11, 2);
+      memcpy(strings[1] + (i * 14) + 10, strings[0] + (i * 25) + 14, 2);
+      memcpy(strings[1] + (i * 14) + 12, strings[0] + (i * 25) + 17, 2);
+      expected[i]      = tt;
+      expected_nsec[i] = ms * 1000000;
+
+      if(i % 3 == 1)
+      { /* any other character than a digit or than the separator */
+         size_t pos = (size_t) (test_random() % 24);
+         char   c   = (char) (test_random() % 256);
+
+         if((pos == 4) || (pos == 7) || (pos == 10) || (pos == 13) || (pos == 16) || (pos == 19) || (pos == 23))
+            c = (c == strings[0][i * 25 + pos]) ? '0' : c;
+         else if((uint32_t) (c - '0') <= 9)
+            c = '-';
+
+         strings[0][i * 25 + pos] = c;
+         strings[1][i * 14 + pos % 14] = '+';
+         expected[i]      = -1;
+         expected_nsec[i] = 0;
+      }
+   }
+
+   errors = parse_times_of_layout("YYYY-MM-DDThh:mm:ss.fffZ", strings[0], 25, TEST_LAYOUT_COUNT, t, nsec, err);
+
+   for(i = 0; i < TEST_LAYOUT_COUNT; ++i)
+   {
+      if((t[i] != expected[i]) || (((err[i / 8] >> (i % 8)) & 1) != (expected[i] == -1)) || (nsec[i] != expected_nsec[i]))
+      {
+         fprintf(stderr, "parse_times_of_layout is wrong for %.24s!\n", strings[0] + (i * 25));
+         goto Exit;
+      }
+   }
+
+   if((errors != (TEST_LAYOUT_COUNT + 1) / 3)
+   || (parse_times_of_layout("YYYYMMDDhhmmss", strings[1], 14, TEST_LAYOUT_COUNT, t, NULL, err) != errors) || errno)
+   {
+      fprintf(stderr, "parse_times_of_layout returns the wrong number of errors!\n");
+      goto Exit;
+   }
+
+   for(i = 0; i < TEST_LAYOUT_COUNT; ++i)
+   {
+      if(t[i] != expected[i])
+      {
+         fprintf(stderr, "parse_times_of_layout is wrong for %.14s!\n", strings[1] + (i * 14));
+         goto Exit;
+      }
+   }
+
+   bRet = 1;
+   Exit:;
+
+   if(!bRet)
+      fprintf(stderr, "Test of the parsing of fixed layouts has failed!\n\n");
+   else
+      fprintf(stdout, "Test of the parsing of fixed layouts passed!\n\n");
+   return(bRet);
+} /* int test_parse_layout() */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_http_date checks the HTTP-date formats and compares the cached
+   formatting of random times with the parsing of their results.
+\* ------------------------------------------------------------------------- */
+
+int test_http_date()
+{
+   static const struct
+   {
+      const char * str;
+      size_t       used;
+      time64_t     t;
+   }
+   parses[] =
+   {
+      { "Sun, 06 Nov 1994 08:49:37 GMT",    29, 784111777 },
+      { "Sunday, 06-Nov-94 08:49:37 GMT",   30, 784111777 },
+      { "Sun Nov  6 08:49:37 1994",         24, 784111777 },
+      { "Thu, 01 Jan 1970 00:00:00 GMT\r\n", 29, 0 },
+      { "Wed, 31 Dec 1969 23:59:59 GMT",    29, -1 },
+      { "Sat, 31 Dec 2016 23:59:60 GMT",    29, 1483228800 },
+      { "Mon, 01 Jan 0001 00:00:00 GMT",    29, -(time64_t) 62135596800LL },
+      { "Fri Dec 31 23:59:59 9999",         24, (time64_t) 253402300799LL },
+   };
+
+   static const char * const invalid[] =
+   {
+      "Sun, 06 Nov 1994 08:49:37 UTC", "sun, 06 Nov 1994 08:49:37 GMT", "Sun, 31 Nov 1994 08:49:37 GMT",
+      "Sun, 06 NOV 1994 08:49:37 GMT", "Sun, 06 Nov 1994 24:00:00 GMT", "Sun Nov 6 08:49:37 1994",
+      "Sun, 06-Nov-94 08:49:37 GMT", "Sunday, 06-Nov-1994 08:49:37 GMT", "Sun, 06 Nov 1994 08:49:37",
+   };
+
+   int            bRet = 0;
+   char           buf[TIME_HTTP_DATE_SIZE];
+   char           text[40];
+   time64_t       t;
+   time64_t       now = unix_time() / 1000000;
+   struct tm      tm;
+   size_t         i;
+
+   for(i = 0; i < sizeof(parses) / sizeof(parses[0]); ++i)
+   {
+      if((parse_http_date(parses[i].str, strlen(parses[i].str), &t) != parses[i].used) || (t != parses[i].t) || errno)
+      {
+         fprintf(stderr, "parse_http_date is wrong for %s!\n", parses[i].str);
+         goto Exit;
+      }
+   }
+
+   for(i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i)
+   {
+      if(parse_http_date(invalid[i], strlen(invalid[i]), &t) || (errno != EINVAL))
+      {
+         fprintf(stderr, "parse_http_date doesn't reject %s!\n", invalid[i]);
+         goto Exit;
+      }
+
+      errno = 0;
+   }
+
+   /* the two digit years of the current year and of 51 years in the future */
+   new_gmtime_r(now, &tm);
+   sprintf(text, "Monday, 01-Jan-%02d 00:00:00 GMT", (tm.tm_year + 1900) % 100);
+   tm.tm_mon  = 0;
+   tm.tm_mday = 1;
+   tm.tm_hour = tm.tm_min = tm.tm_sec = 0;
+
+   if(!parse_http_date(text, strlen(text), &t) || (t != new_timegm(&tm)))
+   {
+      fprintf(stderr, "parse_http_date is wrong for the current year %s!\n", text);
+      goto Exit;
+   }
+
+   sprintf(text, "Monday, 01-Jan-%02d 00:00:00 GMT", (tm.tm_year + 1900 + 51) % 100);
+   tm.tm_year -= 49;
+
+   if(!parse_http_date(text, strlen(text), &t) || (t != new_timegm(&tm)))
+   {
+      fprintf(stderr, "parse_http_date is wrong for the past century %s!\n", text);
+      goto Exit;
+   }
+
+   for(i = 0; i < 100000; ++i)
+   { /* a few seconds of the same day after each other and random days */
+      time64_t t1 = (i % 4) ? t + (time64_t) (i % 3) : (time64_t) (test_random() % (uint64_t) 315537897600) - (time64_t) 62135596800;
+      time64_t t2;
+
+      if((format_http_date(t1, buf, sizeof(buf)) != TIME_HTTP_DATE_SIZE - 1) || (parse_http_date(buf, strlen(buf), &t2) != 29)
+      || (t2 != t1) || errno)
+      {
+         fprintf(stderr, "format_http_date is wrong for time %lld!\n", (long long) t1);
+         goto Exit;
+      }
+
+      t = t1;
+   }
+
+   if((format_http_date(784111777, buf, sizeof(buf)) != 29) || strcmp(buf, "Sun, 06 Nov 1994 08:49:37 GMT")
+   || (format_http_date(784111777 + 86400 * 30 + 3600, buf, sizeof(buf)) != 29) || strcmp(buf, "Tue, 06 Dec 1994 09:49:37 GMT"))
+   {
+      fprintf(stderr, "format_http_date returns %s!\n", buf);
+      goto Exit;
+   }
+
+   if(format_http_date(0, buf, TIME_HTTP_DATE_SIZE - 1) || (errno != ERANGE)
+   || ((errno = 0), format_http_date((time64_t) 253402300800LL, buf, sizeof(buf))) || (errno != EOVERFLOW)
+   || ((errno = 0), format_http_date(-(time64_t) 62167219201LL, buf, sizeof(buf))) || (errno != EOVERFLOW))
+   {
+      fprintf(stderr, "format_http_date doesn't detect invalid arguments!\n");
+      goto Exit;
+   }
+
+   errno = 0;
+   bRet = 1;
+   Exit:;
+
+   if(!bRet)
+      fprintf(stderr, "Test of the HTTP dates has failed!\n\n");
+   else
+      fprintf(stdout, "Test of the HTTP dates passed!\n\n");
+   return(bRet);
+} /* int test_http_date() */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_log_time checks the parsers of the timestamps of log files and the
+   year inference of syslog times around the turn of the year.
+\* ------------------------------------------------------------------------- */
+
+int test_log_time()
+{
+   static const struct
+   {
+      const char * str;
+      const char * reference; /* local reference time */
+      const char * zone;
+      size_t       used;
+      const char * expected;  /* local time of the result */
+   }
+   syslogs[] =
+   {
+      { "Oct 17 04:01:02 host sshd[1]: ", "2023-10-17T04:05:00", NULL,       15, "2023-10-17T04:01:02Z" },
+      { "Dec 31 23:59:59 host",           "2024-01-01T00:00:05", "Paris",    15, "2023-12-31T23:59:59+01:00" },
+      { "Jan  1 00:00:01.250 host",       "2023-12-31T23:59:58", "Paris",    19, "2024-01-01T00:00:01.25+01:00" },
+      { "Feb 29 12:00:00",                "2025-01-10T00:00:00", "New_York", 15, "2024-02-29T12:00:00-05:00" },
+      { "Mar 31 03:30:00",                "2024-04-01T00:00:00", "Paris",    15, "2024-03-31T03:30:00+02:00" },
+      { "Jul  4 12:00:00",                "2024-01-01T00:00:00", "Sydney",   15, "2023-07-04T12:00:00+10:00" },
+      { "Jan  7 23:00:00",                "2023-12-31T23:00:00", "Sydney",   15, "2024-01-07T23:00:00+11:00" },
+      { "Jan  8 00:00:01",                "2023-12-31T23:00:00", "Sydney",   15, "2023-01-08T00:00:01+11:00" },
+   };
+
+   static const char * const invalid[] =
+   {
+      "Okt 17 04:01:02", "Oct 17 4:01:02", "Oct 32 04:01:02", "Oct 17 24:01:02", "Feb 29 12:00:00", "Oct 0 04:01:02",
+   };
+
+   int            bRet = 0;
+   TIME_ZONE_INFO tzi;
+   char           buf[TIME_FORMAT_NS_SIZE];
+   time64_t       t;
+   time64_t       ref;
+   int64_t        ns;
+   int32_t        nsec;
+   size_t         i;
+
+   for(i = 0; i < sizeof(syslogs) / sizeof(syslogs[0]); ++i)
+   {
+      const TIME_ZONE_INFO * pz = syslogs[i].zone ? &tzi : NULL;
+
+      if(pz && !read_TZ(&tzi, pc_find_TZ(syslogs[i].zone)))
+      {
+         fprintf(stderr, "read_TZ of %s has failed!\n", syslogs[i].zone);
+         goto Exit;
+      }
+
+      parse_time_of_zone_ns(syslogs[i].reference, strlen(syslogs[i].reference), &ns, pz);
+      ref = split_time_ns(ns, &nsec);
+
+      if((parse_syslog_time(syslogs[i].str, strlen(syslogs[i].str), ref, &t, &nsec, pz) != syslogs[i].used)
+      || !format_time_of_zone_ns(join_time_ns(t, nsec), 0, buf, sizeof(buf), pz) || errno)
+      {
+         fprintf(stderr, "parse_syslog_time has failed for %s!\n", syslogs[i].str);
+         goto Exit;
+      }
+
+      if(nsec)
+         format_time_of_zone_ns(join_time_ns(t, nsec), 2, buf, sizeof(buf), pz);
+
+      if(strcmp(buf, syslogs[i].expected))
+      {
+         fprintf(stderr, "parse_syslog_time returns %s instead of %s for %s!\n", buf, syslogs[i].expected, syslogs[i].str);
+         goto Exit;
+      }
+   }
+
+   for(i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i)
+   { /* February 29 is invalid around 2023 */
+      if(parse_syslog_time(invalid[i], strlen(invalid[i]), 1690000000, &t, NULL, NULL) || (errno != EINVAL))
+      {
+         fprintf(stderr, "parse_syslog_time doesn't reject %s!\n", invalid[i]);
+         goto Exit;
+      }
+
+      errno = 0;
+   }
+
+   if((parse_clf_time("[10/Oct/2000:13:55:36 -0700] \"GET /", 36, &t, &nsec) != 28) || (t != 971211336) || nsec
+   || (parse_clf_time("01/Jan/1970:00:00:00 +0130", 26, &t, NULL) != 26) || (t != -5400)
+   || (parse_clf_time("[29/Feb/2024:23:59:60 +0000]", 28, &t, NULL) != 28) || (t != 1709251200) || errno)
+   {
+      fprintf(stderr, "parse_clf_time is wrong!\n");
+      goto Exit;
+   }
+
+   if(parse_clf_time("[10/Oct/2000:13:55:36 -0700", 27, &t, NULL) || (errno != EINVAL)
+   || ((errno = 0), parse_clf_time("10/Oct/2000:13:55:36 0700", 25, &t, NULL)) || (errno != EINVAL)
+   || ((errno = 0), parse_clf_time("29/Feb/2023:00:00:00 +0000", 26, &t, NULL)) || (errno != EINVAL))
+   {
+      fprintf(stderr, "parse_clf_time doesn't reject invalid times!\n");
+      goto Exit;
+   }
+
+   errno = 0;
+
+   if((parse_journal_time("1697515262123456\n", 17, &t, &nsec) != 16) || (t != 1697515262) || (nsec != 123456000)
+   || (parse_journal_time("9223372036854775807", 19, &t, &nsec) != 19) || (t != (time64_t) 9223372036854LL) || (nsec != 775807000) || errno)
+   {
+      fprintf(stderr, "parse_journal_time is wrong!\n");
+      goto Exit;
+   }
+
+   if(parse_journal_time("9223372036854775808", 19, &t, &nsec) || (errno != EOVERFLOW)
+   || ((errno = 0), parse_journal_time("-1", 2, &t, &nsec)) || (errno != EINVAL))
+   {
+      fprintf(stderr, "parse_journal_time doesn't reject invalid times!\n");
+      goto Exit;
+   }
+
+   errno = 0;
+   bRet = 1;
+   Exit:;
+
+   if(!bRet)
+      fprintf(stderr, "Test of the timestamps of log files has failed!\n\n");
+   else
+      fprintf(stdout, "Test of the timestamps of log files passed!\n\n");
+   return(bRet);
+} /* int test_log_time() */
+
+
+/* ------------------------------------------------------------------------- *\
+   count_find_TZ counts the lookups of the time zone cache.
+\* ------------------------------------------------------------------------- */
+
+static int find_TZ_count = 0;
+
+static const char * count_find_TZ(const char * name)
+{
+   ++find_TZ_count;
+   return (pc_find_TZ(name));
+} /* const char * count_find_TZ(const char * name) */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_zoned_time checks parse_zoned_time_ns with zone name suffixes, that
+   the cache looks up every name once only and that a returned zone stays
+   unchanged after more distinct words and zones than the capacity.
+\* ------------------------------------------------------------------------- */
+
+int test_zoned_time()
+{
+   static const struct
+   {
+      const char * str;
+      size_t       used;     /* 0 for an invalid time */
+      const char * expected; /* UTC time of the result */
+   }
+   parses[] =
+   {
+      { "2026-10-17T04:01:02+02:00[Europe/Paris]",               39, "2026-10-17T02:01:02.0Z" },
+      { "2026-10-17T04:01:02.5[!Europe/Paris] x",                36, "2026-10-17T02:01:02.5Z" },
+      { "2026-10-17T04:01:02 Europe/Paris rest",                 32, "2026-10-17T02:01:02.0Z" },
+      { "2026-10-17T04:01:02Z[America/New_York]",                38, "2026-10-17T04:01:02.0Z" },
+      { "2026-10-17T04:01:02-04:00[America/New_York][u-ca=hebrew]", 56, "2026-10-17T08:01:02.0Z" },
+      { "2026-10-17T04:01:02[Europe/Paris][!u-ca=gregory]",      48, "2026-10-17T02:01:02.0Z" },
+      { "2026-10-17T04:01:02+05:30[+05:30]",                     33, "2026-10-16T22:31:02.0Z" },
+      { "2026-10-17T04:01:02 INFO started",                      19, "2026-10-17T04:01:02.0Z" },
+      { "2026-10-17T04:01:02 UTC started",                       23, "2026-10-17T04:01:02.0Z" },
+      { "2026-03-29T02:30:00[Europe/Paris]",                     33, "2026-03-29T01:30:00.0Z" },
+      { "2026-10-17T04:01:02+01:00[Europe/Paris]",               0,  NULL },
+      { "2026-10-17T04:01:02[Mars/Olympus_Mons]",                0,  NULL },
+      { "2026-10-17T04:01:02[Europe/Paris][Europe/Paris]",       0,  NULL },
+      { "2026-10-17T04:01:02[!u-ca=hebrew]",                     0,  NULL },
+      { "2026-10-17T04:01:02[Europe/Paris",                      0,  NULL },
+      { "2026-10-17T04:01:02[]",                                 0,  NULL },
+   };
+
+   int                    bRet   = 0;
+   TIME_ZONE_CACHE *      pcache = NULL;
+   const TIME_ZONE_INFO * pzone;
+   const TIME_ZONE_INFO * pparis;
+   char                   buf[TIME_FORMAT_NS_SIZE];
+   int64_t                ns;
+   int64_t                ns_paris;
+   int                    round;
+   size_t                 i;
+
+   pcache = create_time_zone_cache(0, count_find_TZ);
+   if(!pcache)
+   {
+      fprintf(stderr, "create_time_zone_cache has failed!\n");
+      goto Exit;
+   }
+
+   for(round = 0; round < 3; ++round)
+   {
+      for(i = 0; i < sizeof(parses) / sizeof(parses[0]); ++i)
+      {
+         size_t used = parse_zoned_time_ns(parses[i].str, strlen(parses[i].str), &ns, NULL, pcache, &pzone);
+
+         if(used != parses[i].used)
+         {
+            fprintf(stderr, "parse_zoned_time_ns returns %u instead of %u for %s!\n", (unsigned) used, (unsigned) parses[i].used, parses[i].str);
+            goto Exit;
+         }
+
+         if(!used)
+         {
+            if(errno != EINVAL)
+            {
+               fprintf(stderr, "parse_zoned_time_ns doesn't set EINVAL for %s!\n", parses[i].str);
+               goto Exit;
+            }
+
+            errno = 0;
+            continue;
+         }
+
+         if(!format_time_of_zone_ns(ns, 1, buf, sizeof(buf), NULL) || errno)
+            goto Exit;
+
+         if(strcmp(buf, parses[i].expected))
+         {
+            fprintf(stderr, "parse_zoned_time_ns returns %s instead of %s for %s!\n", buf, parses[i].expected, parses[i].str);
+            goto Exit;
+         }
+      }
+   }
+
+   /* Europe/Paris, America/New_York, UTC and Mars/Olympus_Mons, but not INFO */
+   if(find_TZ_count != 4)
+   {
+      fprintf(stderr, "The time zone cache has looked up %d names instead of 4!\n", find_TZ_count);
+      goto Exit;
+   }
+
+   destroy_time_zone_cache(pcache);
+
+   /* a cache of 2 names grows for the known zones and keeps the unknown names up to its capacity */
+   pcache = create_time_zone_cache(2, pc_find_TZ);
+   if(!pcache)
+      goto Exit;
+
+   if(!parse_zoned_time_ns("2026-10-17T04:01:02 Europe/Paris", 32, &ns_paris, NULL, pcache, &pparis) || !pparis)
+   {
+      fprintf(stderr, "parse_zoned_time_ns doesn't find Europe/Paris!\n");
+      goto Exit;
+   }
+
+   for(i = 0; i < 300; ++i)
+   { /* plain words, unknown plain names and unknown names in brackets */
+      static const char * const formats[] = { "2026-10-17T04:01:02 WORD%u started", "2026-10-17T04:01:02 Area%u/City", "2026-10-17T04:01:02[Area%u/City]" };
+      static const size_t       expected[] = { 19, 19, 0 };
+      char                      line[80];
+      size_t                    used;
+
+      sprintf(line, formats[i % 3], (unsigned) (i / 3));
+      used = parse_zoned_time_ns(line, strlen(line), &ns, NULL, pcache, &pzone);
+
+      if((used != expected[i % 3]) || (used && pzone) || (!used && (errno != EINVAL)))
+      {
+         fprintf(stderr, "parse_zoned_time_ns is wrong for %s!\n", line);
+         goto Exit;
+      }
+
+      errno = 0;
+   }
+
+   if(!format_time_of_zone_ns(ns_paris, 0, buf, sizeof(buf), pparis) || strcmp(buf, "2026-10-17T04:01:02+02:00"))
+   {
+      fprintf(stderr, "The zone of Europe/Paris has changed after unknown names in the time zone cache!\n");
+      goto Exit;
+   }
+
+   for(i = 0; i < 30; ++i)
+   {
+      static const char * const names[] = { "Australia/Sydney", "America/Santiago", "Asia/Tokyo", "Europe/Dublin", "Australia/Lord_Howe" };
+      TIME_ZONE_INFO            tzi;
+      const char *              name = names[i % 5];
+
+      pzone = get_cached_zone(pcache, name, strlen(name));
+
+      if(!pzone || !read_TZ(&tzi, pc_find_TZ(name)) || memcmp(&tzi, pzone, sizeof(tzi)))
+      {
+         fprintf(stderr, "get_cached_zone returns the wrong zone for %s!\n", name);
+         goto Exit;
+      }
+   }
+
+   if(   !format_time_of_zone_ns(ns_paris, 0, buf, sizeof(buf), pparis) || strcmp(buf, "2026-10-17T04:01:02+02:00")
+      || !parse_zoned_time_ns("2026-10-17T04:01:02 Europe/Paris", 32, &ns, NULL, pcache, &pzone) || (pzone != pparis))
+   {
+      fprintf(stderr, "The zone of Europe/Paris has changed after more zones in the time zone cache!\n");
+      goto Exit;
+   }
+
+   bRet = 1;
+   Exit:;
+   destroy_time_zone_cache(pcache);
+
+   if(!bRet)
+      fprintf(stderr, "Test of the times with time zone names has failed!\n\n");
+   else
+      fprintf(stdout, "Test of the times with time zone names passed!\n\n");
+   return(bRet);
+} /* int test_zoned_time() */
+
+
+/* ------------------------------------------------------------------------- *\
+   check_week_dates compares the week dates of week_date_array_of_zone and
+   of week_date_of_zone for an array of times with the calendar week of
+   calendar_week_of_year and the year and the day of the week of
+   test_localtime.
+\* ------------------------------------------------------------------------- */
+
+static int check_week_dates(const time64_t * tt, size_t count, const TIME_ZONE_INFO * pz, const char * name)
+{
+   static int32_t years[TEST_ARRAY_SIZE];
+   static int8_t  weeks[TEST_ARRAY_SIZE];
+   static int8_t  wdays[TEST_ARRAY_SIZE];
+   static uint8_t errs[(TEST_ARRAY_SIZE + 7) / 8];
+   size_t         i;
+
+   if(week_date_array_of_zone(tt, count, years, weeks, wdays, errs, pz))
+   {
+      fprintf(stderr, "week_date_array_of_zone reports invalid times in %s!\n", name);
+      return (0);
+   }
+
+   for(i = 0; i < count; ++i)
+   {
+      TIME_WEEK_DATE date;
+      struct tm      tm;
+      int            week;
+      int            year;
+
+      test_localtime(tt[i], &tm, pz);
+
+      week = calendar_week_of_year(&tm);
+      year = tm.tm_year + 1900;
+
+      if((week >= 52) && (tm.tm_mon == 0))
+         --year;
+      else if((week == 1) && (tm.tm_mon == 11))
+         ++year;
+
+      if(   !week_date_of_zone(tt[i], &date, pz)
+         || (date.year != year) || (date.week != week) || (date.wday != (tm.tm_wday ? tm.tm_wday : 7))
+         || (years[i] != year) || (weeks[i] != week) || (wdays[i] != date.wday) || (errs[i >> 3] & (1 << (i & 7))))
+      {
+         fprintf(stderr, "The week date of %lld in %s is %d-W%d-%d instead of %d-W%d!\n",
+                 (long long) tt[i], name, (int) years[i], (int) weeks[i], (int) wdays[i], year, week);
+         return (0);
+      }
+   }
+
+   return (1);
+} /* int check_week_dates(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_week_date checks the ISO 8601 week dates of week_date_of_zone,
+   week_date_array_of_zone and format_week_date_of_zone for the days
+   around New Year and for random and sorted times in the test zones.
+\* ------------------------------------------------------------------------- */
+
+int test_week_date()
+{
+   static const struct
+   {
+      time64_t     t;
+      const char * zone;     /* NULL for UTC */
+      const char * expected;
+   }
+   dates[] =
+   {
+      { 0,            NULL,               "1970-W01-4" },
+      { 1609675200,   NULL,               "2020-W53-7" },
+      { 1230508800,   NULL,               "2009-W01-1" },
+      { 1262559600,   NULL,               "2009-W53-7" },
+      { 1262559600,   "Australia/Sydney", "2010-W01-1" },
+      { 1735515000,   NULL,               "2024-W52-7" },
+      { 1735515000,   "Europe/Paris",     "2025-W01-1" },
+      { 1792368000,   "America/New_York", "2026-W42-7" },
+      { 253402300800, NULL,               "9999-W52-6" },
+      { 253402473600, NULL,               "+10000-W01-1" },
+   };
+
+   int             bRet = 0;
+   static time64_t tt[TEST_ARRAY_SIZE];
+   TIME_ZONE_INFO  tzi;
+   TIME_WEEK_DATE  date;
+   const char **   ppz;
+   char            buf[TIME_WEEK_DATE_SIZE];
+   size_t          i;
+
+   for(i = 0; i < sizeof(dates) / sizeof(dates[0]); ++i)
+   {
+      if(dates[i].zone && !read_TZ(&tzi, pc_find_TZ(dates[i].zone)))
+      {
+         fprintf(stderr, "read_TZ of %s has failed!\n", dates[i].zone);
+         goto Exit;
+      }
+
+      if(   (format_week_date_of_zone(dates[i].t, buf, sizeof(buf), dates[i].zone ? &tzi : NULL) != strlen(dates[i].expected))
+         || strcmp(buf, dates[i].expected))
+      {
+         fprintf(stderr, "format_week_date_of_zone returns %s instead of %s for %lld!\n", buf, dates[i].expected, (long long) dates[i].t);
+         goto Exit;
+      }
+   }
+
+   for(i = 0; i < TEST_ARRAY_SIZE; ++i)
+   {
+      if(i & 1) /* random times of the years 2000 BC until 4000 AD */
+         tt[i] = (time64_t) (test_random() % ((uint64_t) 86400 * 365 * 6000)) - (time64_t) 86400 * 365 * 3970;
+      else      /* the years 2020 until 2024 in steps of a bit less than 4 hours */
+         tt[i] = (time64_t) 1577836800 + (time64_t) (i / 2) * 14159;
+   }
+
+   for(ppz = test_zones; ; ++ppz)
+   {
+      if(*ppz && !read_TZ(&tzi, pc_find_TZ(*ppz)))
+      {
+         fprintf(stderr, "read_TZ of %s has failed!\n", *ppz);
+         goto Exit;
+      }
+
+      if(!check_week_dates(tt, TEST_ARRAY_SIZE, *ppz ? &tzi : NULL, *ppz ? *ppz : "UTC"))
+         goto Exit;
+
+      if(!*ppz)
+         break;
+   }
+
+   for(i = 0; i < TEST_ARRAY_SIZE; ++i) /* sorted times of the same zone reuse the offset and the week */
+      tt[i] = (time64_t) 1577836800 + (time64_t) i * 7919;
+
+   if(!read_TZ(&tzi, pc_find_TZ("Europe/Paris")) || !check_week_dates(tt, TEST_ARRAY_SIZE, &tzi, "Europe/Paris"))
+      goto Exit;
+
+   errno = 0;
+   if(week_date_of_zone(INT64_MAX, &date, NULL) || (errno == 0))
+   {
+      fprintf(stderr, "week_date_of_zone accepted a year out of range!\n");
+      goto Exit;
+   }
+
+   tt[0] = 0;
+   tt[1] = INT64_MIN;
+   tt[2] = (time64_t) 86400 * 366 * 2147483647;
+   if(week_date_array_of_zone(tt, 3, NULL, NULL, NULL, NULL, NULL) != 2)
+   {
+      fprintf(stderr, "week_date_array_of_zone accepted years out of range!\n");
+      goto Exit;
+   }
+
+   errno = 0;
+   if(format_week_date_of_zone(0, buf, 10, NULL) || (errno != ERANGE))
+   {
+      fprintf(stderr, "format_week_date_of_zone ignores the size of the buffer!\n");
+      goto Exit;
+   }
+
+   errno = 0;
+   bRet = 1;
+   Exit:;
+
+   if(!bRet)
+      fprintf(stderr, "Test of the ISO 8601 week dates has failed!\n\n");
+   else
+      fprintf(stdout, "Test of the ISO 8601 week dates passed!\n\n");
+   return(bRet);
+} /* int test_week_date() */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_time_api_stats checks the optional runtime statistics if they are
+   compiled in and that get_time_api_stats returns zeroed counters otherwise.
+\* ------------------------------------------------------------------------- */
+
+int test_time_api_stats()
+{
+   int            bRet = 0;
+   TIME_API_STATS st0;
+   TIME_API_STATS st1;
+   struct tm      stm;
+   int            err = errno;
+
+   if(!get_time_api_stats(&st0))
+   {
+      static const TIME_API_STATS zero; /* all counters 0 */
+
+      if(memcmp(&st0, &zero, sizeof(st0)))
+      {
+         fprintf(stderr, "get_time_api_stats returned counters without statistics compiled in!\n");
+         goto Exit;
+      }
+
+      fprintf(stdout, "Runtime statistics are not compiled in.\n\n");
+      bRet = 1;
+      goto Exit;
+   }
+
+   memset(&stm, 0, sizeof(stm));
+   new_gmtime_r(0, &stm);
+   new_localtime_r(0, &stm);
+   update_time_zone_info();  /* TZ is unchanged here */
+   stm.tm_mon = 12;
+   new_timegm(&stm);         /* ERANGE */
+   errno = err;
+
+   get_time_api_stats(&st1);
+
+   if(   (st1.calls_new_gmtime_r      < st0.calls_new_gmtime_r + 2) /* one more by new_localtime_r */
+      || (st1.calls_new_localtime_r   != st0.calls_new_localtime_r + 1)
+      || (st1.calls_localtime_of_zone != st0.calls_localtime_of_zone + 1)
+      || (st1.calls_new_timegm        != st0.calls_new_timegm + 1)
+      || (st1.tz_unchanged            != st0.tz_unchanged + 1)
+      || (st1.cache_hits              != st0.cache_hits + 1)
+      || (st1.errors_erange           != st0.errors_erange + 1))
+   {
+      fprintf(stderr, "Unexpected counters of get_time_api_stats!\n");
+      goto Exit;
+   }
+
+   fprintf(stdout, "Runtime statistics: %llu reloads, %llu unchanged TZ, %llu file reads, %llu locks, %llu cache hits, %llu cache misses\n",
+           (unsigned long long) st1.tz_reloads, (unsigned long long) st1.tz_unchanged, (unsigned long long) st1.zone_file_reads,
+           (unsigned long long) st1.lock_acquisitions, (unsigned long long) st1.cache_hits, (unsigned long long) st1.cache_misses);
+
+   bRet = 1;
+   fprintf(stdout, "Test of the runtime statistics passed!\n\n");
+   Exit:;
+
+   if(!bRet)
+      fprintf(stderr, "Test of the runtime statistics has failed!\n\n");
+   return(bRet);
+} /* int test_time_api_stats() */
+
+
 /* ------------------------------------------------------------------------- *\
    main function
 \* ------------------------------------------------------------------------- */
@@ -1065,6 +3924,69 @@ int main(int argc, char * argv[])
    if (!test_new_gmtime_r())
       goto Exit;
 
+   if (!test_tm_arrays())
+      goto Exit;
+
+   if (!test_time_columns())
+      goto Exit;
+
+   if (!test_trunc_time())
+      goto Exit;
+
+   if (!test_time_boundaries())
+      goto Exit;
+
+   if (!test_transitions())
+      goto Exit;
+
+   if (!test_utc_offset())
+      goto Exit;
+
+   if (!test_add_time())
+      goto Exit;
+
+   if (!test_diff_time())
+      goto Exit;
+
+   if (!test_time_ns())
+      goto Exit;
+
+   if (!test_time_ns_wide())
+      goto Exit;
+
+   if (!test_localtime_of_zones())
+      goto Exit;
+
+   if (!test_convert_time())
+      goto Exit;
+
+   if (!test_time_pool())
+      goto Exit;
+
+   if (!test_zone_ids())
+      goto Exit;
+
+   if (!test_parse_time())
+      goto Exit;
+
+   if (!test_parse_layout())
+      goto Exit;
+
+   if (!test_http_date())
+      goto Exit;
+
+   if (!test_log_time())
+      goto Exit;
+
+   if (!test_zoned_time())
+      goto Exit;
+
+   if (!test_week_date())
+      goto Exit;
+
+   if (!test_time_api_stats())
+      goto Exit;
+
    iRet = 0;
    Exit:;
 
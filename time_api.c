@@ -105,10 +105,180 @@
 #include <windows.h>  /* required for struct timeval and LPFILETIME */
 #endif
 
+#if (defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && (_M_IX86_FP >= 2))) && !defined (TIME_API_NO_SSE2)
+#include <emmintrin.h>
+#define TIME_API_SSE2 1 /* parse_times_of_layout checks 16 characters at once */
+#endif
+
 
 #include <time_api.h>
 
 
+/* ========================================================================= *\
+   Optional runtime statistics
+\* ========================================================================= */
+
+#if defined (_MSC_VER)
+#define TA_THREAD_LOCAL __declspec(thread)
+#else
+#define TA_THREAD_LOCAL __thread
+#endif
+
+#ifdef TIME_API_ENABLE_STATS
+
+typedef struct TA_STATS_BLOCK_S TA_STATS_BLOCK;
+struct TA_STATS_BLOCK_S
+{
+   TIME_API_STATS   stats; /* the counters of a single thread */
+   TA_STATS_BLOCK * pnext; /* next block in the list of all threads */
+};
+
+static TA_STATS_BLOCK * volatile        pstats_list   = NULL; /* blocks of all threads that ever used the API */
+static TA_STATS_BLOCK                   stats_shared;         /* fallback if a thread block can't be allocated */
+static TA_THREAD_LOCAL TA_STATS_BLOCK * pstats_thread = NULL; /* counters of the current thread */
+
+
+/* ------------------------------------------------------------------------- *\
+   get_thread_stats returns the counters of the current thread and registers
+   a new block of counters at the first call of a thread. The blocks are
+   never released for keeping the counts of terminated threads.
+\* ------------------------------------------------------------------------- */
+
+static TIME_API_STATS * get_thread_stats()
+{
+   TA_STATS_BLOCK * pb = pstats_thread;
+
+   if(!pb)
+   {
+      pb = (TA_STATS_BLOCK *) calloc(1, sizeof(*pb));
+
+      if(!pb)
+         return (&stats_shared.stats); /* count without a thread block in the worst case */
+
+      do
+      {
+         pb->pnext = pstats_list;
+      }
+#if defined (_WIN32)
+      while(InterlockedCompareExchangePointer((PVOID volatile *) &pstats_list, pb, pb->pnext) != pb->pnext);
+#else
+      while(!__sync_bool_compare_and_swap(&pstats_list, pb->pnext, pb));
+#endif
+
+      pstats_thread = pb;
+   }
+
+   return (&pb->stats);
+} /* TIME_API_STATS * get_thread_stats() */
+
+
+/* ------------------------------------------------------------------------- *\
+   count_error counts the errors according to the value of errno
+\* ------------------------------------------------------------------------- */
+
+static void count_error(int err)
+{
+   TIME_API_STATS * ps = get_thread_stats();
+
+   if(err == EINVAL)
+      ++ps->errors_einval;
+   else if(err == ERANGE)
+      ++ps->errors_erange;
+#ifdef EOVERFLOW
+   else if(err == EOVERFLOW)
+      ++ps->errors_eoverflow;
+#endif
+   else
+      ++ps->errors_other;
+} /* void count_error(int err) */
+
+#define TA_STAT_INC(member)  (++get_thread_stats()->member)
+#define TA_STAT_ERROR(err)   count_error(err)
+
+#else
+
+#define TA_STAT_INC(member)  ((void) 0)
+#define TA_STAT_ERROR(err)   ((void) 0)
+
+#endif /* TIME_API_ENABLE_STATS */
+
+
+/* ------------------------------------------------------------------------- *\
+   Optional USDT probes of the provider limitless_times for tracing the slow
+   paths with bpftrace, perf or SystemTap in production. They are compiled in
+   only if time_api.c is compiled with TIME_API_ENABLE_USDT defined and
+   require sys/sdt.h of SystemTap then. The probes are no more than a nop
+   instruction as long as nobody is tracing.
+
+   tz_reload(const char * tz)      update_time_zone_info reloads the zone info
+   tz_parse_fail(const char * tz)  read_TZ failed to parse a TZ value
+   lock()                          the lock callback of the time API is called
+   error(int errno)                errno was set to ERANGE or EOVERFLOW for a
+                                   result out of range or to ENOMEM
+
+   The error probe doesn't fire for EINVAL, since invalid arguments are
+   rejected by the checks at the begin of the functions and aren't a slow
+   path of a conversion. They are counted by the runtime statistics only.
+\* ------------------------------------------------------------------------- */
+
+#ifdef TIME_API_ENABLE_USDT
+#include <sys/sdt.h>
+
+#define TA_PROBE0(name)        DTRACE_PROBE(limitless_times, name)
+#define TA_PROBE1(name, arg)   DTRACE_PROBE1(limitless_times, name, arg)
+#define TA_PROBE_ERROR(err)    do { if((err) != EINVAL) DTRACE_PROBE1(limitless_times, error, err); } while(0)
+#else
+#define TA_PROBE0(name)        ((void) 0)
+#define TA_PROBE1(name, arg)   ((void) 0)
+#define TA_PROBE_ERROR(err)    ((void) 0)
+#endif /* TIME_API_ENABLE_USDT */
+
+
+/* sets errno to an error value and counts and traces that error */
+#define SET_ERRNO(err)  do { errno = (err); TA_STAT_ERROR(err); TA_PROBE_ERROR(err); } while(0)
+
+
+/* ------------------------------------------------------------------------- *\
+   get_time_api_stats stores the sum of the counters of all threads in a user
+   provided struct TIME_API_STATS. It returns nonzero if the statistics are
+   compiled in and zero with all counters set to 0 otherwise.
+\* ------------------------------------------------------------------------- */
+
+int get_time_api_stats(TIME_API_STATS * pstats)
+{
+   int iret = 0;
+
+   if(!pstats)
+      goto Exit;
+
+   memset(pstats, 0, sizeof(*pstats));
+
+#ifdef TIME_API_ENABLE_STATS
+   {
+      const TA_STATS_BLOCK * pb = &stats_shared;
+
+      do
+      {
+         const uint64_t * psrc = (const uint64_t *) &pb->stats;
+         uint64_t *       pdst = (uint64_t *) pstats;
+         size_t           num  = sizeof(*pstats) / sizeof(uint64_t);
+
+         while(num--)
+            *pdst++ += *psrc++;
+
+         pb = (pb == &stats_shared) ? pstats_list : pb->pnext;
+      }
+      while(pb);
+   }
+
+   iret = 1;
+#endif /* TIME_API_ENABLE_STATS */
+
+   Exit:;
+   return (iret);
+} /* int get_time_api_stats(TIME_API_STATS * pstats) */
+
+
 #if defined (_WIN32) || defined (__CYGWIN__)
 
 /* ------------------------------------------------------------------------- *\
@@ -306,6 +476,29 @@ void init_time_api_lock(TIME_API_LOCK pfn_lock,   /* pointer to a user provided
 } /* void set_time_api_lock(...) */
 
 
+/* ------------------------------------------------------------------------- *\
+   lock_time_api and unlock_time_api are calling the optional lock and
+   unlock callbacks of init_time_api_lock.
+\* ------------------------------------------------------------------------- */
+
+static void lock_time_api()
+{
+   if(pta_lock)
+   {
+      TA_STAT_INC(lock_acquisitions);
+      TA_PROBE0(lock);
+      pta_lock(pv_lock_context);
+   }
+} /* void lock_time_api() */
+
+
+static void unlock_time_api()
+{
+   if(pta_unlock)
+      pta_unlock(pv_lock_context);
+} /* void unlock_time_api() */
+
+
 /* ========================================================================= *\
    Routines for calculating calendar week of a given date
 \* ========================================================================= */
@@ -353,7 +546,15 @@ int calendar_week_of_year(const struct tm * ptm)
    }
 
    if(!kw_ret)
-      kw_ret = 53;  /* KW0 indicates KW53 of previous year. */
+   { /* KW0 is the last week of the previous year, it is KW53 if the previous year
+        started on a Thursday, i.e. if the 01/01 is a Friday or a Saturday after a leap year */
+      int prev_year = (year + 399) % 400;
+
+      if((wday_01_01 == -3) || ((wday_01_01 == -2) && !(prev_year & 3) && ((prev_year % 100) || !prev_year)))
+         kw_ret = 53;
+      else
+         kw_ret = 52;
+   }
 
    Exit:;
       return (kw_ret);
@@ -432,9 +633,11 @@ time64_t new_timegm(const struct tm * ptm)
    int32_t time_of_year;
    int     leap_year = 0;
 
+   TA_STAT_INC(calls_new_timegm);
+
    if(!ptm)
    {
-      errno = EINVAL;
+      SET_ERRNO(EINVAL);
       goto Exit;
    }
 
@@ -444,7 +647,7 @@ time64_t new_timegm(const struct tm * ptm)
        ||  (ptm->tm_mday < 1)
        || ((ptm->tm_mon  < 0) || (ptm->tm_mon  > 11)))
    {
-      errno = ERANGE;
+      SET_ERRNO(ERANGE);
       goto Exit;
    }
 
@@ -515,7 +718,8 @@ time64_t new_timegm(const struct tm * ptm)
    {
       if (ptm->tm_mday > days_of_month_array[ptm->tm_mon])
       {
-         errno = ERANGE;
+         tt = -1;
+         SET_ERRNO(ERANGE);
          goto Exit;
       }
 
@@ -525,7 +729,8 @@ time64_t new_timegm(const struct tm * ptm)
    {
       if (ptm->tm_mday > days_of_month_array_ly[ptm->tm_mon])
       {
-         errno = ERANGE;
+         tt = -1;
+         SET_ERRNO(ERANGE);
          goto Exit;
       }
 
@@ -553,7 +758,10 @@ time64_t new_timegm(const struct tm * ptm)
 
 time64_t std_timegm(struct tm * ptm)
 {
-   time64_t t_ret = new_timegm(ptm);
+   time64_t t_ret;
+
+   TA_STAT_INC(calls_std_timegm);
+   t_ret = new_timegm(ptm);
 
    if(t_ret != (time64_t) -1)
    {
@@ -628,9 +836,11 @@ struct tm * new_gmtime_r(time64_t t, struct tm * ptm)
     10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,
     11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11};
 
+   TA_STAT_INC(calls_new_gmtime_r);
+
    if(!ptm)
    {
-      errno = EINVAL;
+      SET_ERRNO(EINVAL);
       goto Exit; /* destination missing */
    }
 
@@ -735,9 +945,9 @@ struct tm * new_gmtime_r(time64_t t, struct tm * ptm)
    if (year != (int) year)
    {
 #ifdef EOVERFLOW
-      errno = EOVERFLOW;
+      SET_ERRNO(EOVERFLOW);
 #else
-      errno = ERANGE;
+      SET_ERRNO(ERANGE);
 #endif
       ptm = NULL;
       goto Exit;
@@ -751,6 +961,25 @@ Exit:;
 static TIME_ZONE_INFO ti;   /* static time zone information as returned by the system functions */
 
 
+/* ------------------------------------------------------------------------- *\
+   check_time_zone_info initializes the static time zone information at the
+   first usage. The caller has to hold the lock of the time API.
+\* ------------------------------------------------------------------------- */
+
+static void check_time_zone_info()
+{
+   if(!ti.type)
+   {
+      TA_STAT_INC(cache_misses);
+      update_time_zone_info();
+   }
+   else
+   {
+      TA_STAT_INC(cache_hits);
+   }
+} /* void check_time_zone_info() */
+
+
 /* ------------------------------------------------------------------------- *\
    get_rule_offset is a helper function that calculates the time in seconds
    that a given daylight saving rule applies after the begin of the year.
@@ -1149,6 +1378,7 @@ int read_TZ (TIME_ZONE_INFO * ptzi, const char * pTZ)
    TIME_ZONE_INFO zi;
    char * ps = (char *) pTZ;
 
+   TA_STAT_INC(calls_read_TZ);
    memset(&zi, 0, sizeof(zi));
 
    if (!ptzi || !ps)
@@ -1184,6 +1414,10 @@ int read_TZ (TIME_ZONE_INFO * ptzi, const char * pTZ)
    bRet = 1;
 
    Exit:;
+
+   if(!bRet)
+      TA_PROBE1(tz_parse_fail, pTZ);
+
    return(bRet);
 } /* read_TZ() */
 
@@ -1202,8 +1436,8 @@ void update_time_zone_info()
    char * pTZ = getenv("TZ");
    struct stat st;
 
-   if(pta_lock)
-      pta_lock(pv_lock_context);
+   TA_STAT_INC(calls_update_time_zone_info);
+   lock_time_api();
 
    if(!pTZ)
    {
@@ -1211,11 +1445,17 @@ void update_time_zone_info()
       pTZ = getenv("TZ");
    }
 
-   if(pTZ)
+   if(pTZ && !strncmp(pTZ, last_TZ, sizeof(last_TZ) - 1))
    {
-      if(!strncmp(pTZ, last_TZ, sizeof(last_TZ) - 1))
-          goto Exit; /* timezone unchanged */
+      TA_STAT_INC(tz_unchanged);
+      goto Exit; /* timezone unchanged */
+   }
 
+   TA_STAT_INC(tz_reloads);
+   TA_PROBE1(tz_reload, pTZ);
+
+   if(pTZ)
+   {
       strncpy(last_TZ, pTZ, sizeof(last_TZ) - 1);
 
       if (read_TZ(&ti, pTZ))
@@ -1262,6 +1502,8 @@ void update_time_zone_info()
             char * pz = buf;
             char * pe = buf;
 
+            TA_STAT_INC(zone_file_reads);
+
             do
             {
                size = read(fd, buf, (unsigned int) sizeof(buf));
@@ -1372,8 +1614,7 @@ void update_time_zone_info()
 
    Exit:;
 
-   if(pta_unlock)
-      pta_unlock(pv_lock_context);
+   unlock_time_api();
 } /* void update_time_zone_info() */
 
 
@@ -1392,9 +1633,11 @@ time64_t mktime_of_zone(const struct tm * ptm, const TIME_ZONE_INFO * ptzi)
    int32_t startday_of_month;
    int32_t days_of_month;
 
+   TA_STAT_INC(calls_mktime_of_zone);
+
    if(!ptm)
    {
-      errno = EINVAL;
+      SET_ERRNO(EINVAL);
       goto Exit;
    }
 
@@ -1404,7 +1647,7 @@ time64_t mktime_of_zone(const struct tm * ptm, const TIME_ZONE_INFO * ptzi)
        ||  (ptm->tm_mday < 1)
        || ((ptm->tm_mon  < 0) || (ptm->tm_mon  > 11)))
    {
-      errno = ERANGE;
+      SET_ERRNO(ERANGE);
       goto Exit;
    }
 
@@ -1484,7 +1727,8 @@ time64_t mktime_of_zone(const struct tm * ptm, const TIME_ZONE_INFO * ptzi)
 
    if (ptm->tm_mday > days_of_month)
    {
-      errno = ERANGE;
+      tt = -1;
+      SET_ERRNO(ERANGE);
       goto Exit;
    }
 
@@ -1535,279 +1779,4798 @@ time64_t mktime_of_zone(const struct tm * ptm, const TIME_ZONE_INFO * ptzi)
 } /* time64_t mktime_of_zone(const struct tm * ptm, const TIME_ZONE_INFO * ptzi) */
 
 
+/* ========================================================================= *\
+   Conversions of arrays of broken-down times
+\* ========================================================================= */
+
 /* ------------------------------------------------------------------------- *\
-   new_mktime is a mktime implementation that does not adjust any members of
-   the input struct as mktime does.
+   days_of_civil_date is a branch free helper that returns the days of a date
+   since 1/1/1970. The month needs to be between 0 and 11. It stores whether
+   the year is a leap year and the index of the precalculated start times of
+   the daylight saving rules of the year in the TIME_ZONE_RULE start array.
 \* ------------------------------------------------------------------------- */
-time64_t new_mktime(const struct tm * ptm)
+
+static int64_t days_of_civil_date(int64_t year, int32_t mon, int32_t mday, int32_t * pleap_year, int32_t * prule_index)
 {
-   time64_t t_ret;
+   int64_t epoch = ((year >= 0) ? year : (year - 399)) / 400; /* 400 year epoch of the year */
+   int32_t yoe   = (int32_t) (year - epoch * 400);            /* year of the epoch between 0 and 399 */
+   int32_t days  = (yoe * 365) + ((yoe + 3) / 4) - ((yoe + 99) / 100) + ((yoe + 399) / 400); /* days from the begin of the epoch until the begin of the year */
+   int32_t leap_year = ((yoe & 3) == 0) & ((yoe % 100 != 0) | (yoe == 0));
 
-   if(pta_lock)
-      pta_lock(pv_lock_context);
+   *pleap_year  = leap_year;
+   *prule_index = ((days + 6 /* 6 is offset at 1/1/0000 */) % 7) + (leap_year * 7);
 
-   if(!ti.type)
-      update_time_zone_info();
+   days += leap_year ? startday_of_month_array_ly[mon] : startday_of_month_array[mon];
 
-   t_ret = mktime_of_zone(ptm, &ti);
+   return ((epoch * 146097) + days + (mday - 1) - 719528 /* days from 1/1/0000 until 1/1/1970 */);
+} /* int64_t days_of_civil_date(...) */
 
-   if(pta_unlock)
-      pta_unlock(pv_lock_context);
 
-   return(t_ret);
-} /* time64_t new_mktime(struct tm * ptm) */
+/* ------------------------------------------------------------------------- *\
+   get_local_bias returns the bias of a local time of a year according to
+   the tm_isdst value as mktime_of_zone does. It needs the time in seconds
+   since the begin of the year and the index of the start times of the
+   daylight saving rules of that year.
+\* ------------------------------------------------------------------------- */
+
+static int32_t get_local_bias(const TIME_ZONE_INFO * ptzi, int32_t isdst, int32_t time_of_year, int32_t rule_index)
+{
+   int32_t bias = ptzi->standard.bias;
+
+   if(ptzi->type > 1)
+   {
+      if(isdst < 0)
+      {
+         int32_t daylight_start = ptzi->daylight.start[rule_index]; /* time offset of begin of the daylight saving within the year in seconds */
+         int32_t standard_start = ptzi->standard.start[rule_index] + (ptzi->daylight.bias - ptzi->standard.bias); /* time offset of returning to the standard time in the year in seconds */
+         int32_t daylight_saving;
+
+         if (daylight_start > standard_start)
+            daylight_saving = (time_of_year < standard_start) | (time_of_year >= daylight_start); /* southern hemisphere */
+         else
+            daylight_saving = (time_of_year >= daylight_start) & (time_of_year < standard_start); /* northern hemisphere */
+
+         if(daylight_saving)
+            bias = ptzi->daylight.bias;
+      }
+      else if(isdst)
+      {
+         bias = ptzi->daylight.bias;
+      }
+   }
+
+   return (bias);
+} /* int32_t get_local_bias(...) */
 
 
 /* ------------------------------------------------------------------------- *\
-   std_mktime is a mktime implementation that adjust the members of the
-   input struct as the C standard requires.
+   convert_tm_array is the common implementation of new_timegm_array and
+   mktime_of_zone_array. A ptzi of NULL means UTC.
 \* ------------------------------------------------------------------------- */
-time64_t std_mktime(struct tm * ptm)
+
+static size_t convert_tm_array(const struct tm * ptm, time64_t * pt, uint8_t * perr, size_t count, const TIME_ZONE_INFO * ptzi)
 {
-   time64_t t_ret;
+   size_t  errors = 0;
+   size_t  i;
+   uint8_t bits   = 0;
 
-   if(pta_lock)
-      pta_lock(pv_lock_context);
+   for(i = 0; i < count; ++i, ++ptm)
+   {
+      int32_t leap_year;
+      int32_t rule_index;
+      int32_t time_of_day;
+      int64_t days;
+      int32_t mon  = ptm->tm_mon;
+      int32_t mday = ptm->tm_mday;
+      int32_t bad  = ((uint32_t) ptm->tm_sec  > 60) /* allow specification of a positive leap second */
+                   | ((uint32_t) ptm->tm_min  > 59)
+                   | ((uint32_t) ptm->tm_hour > 23)
+                   | ((uint32_t) mon          > 11)
+                   | (((uint32_t) mday - 1u)  > 30);
+
+      if(bad)
+      { /* keep the table lookups and the math valid, the element is invalid anyway */
+         mon  = 0;
+         mday = 1;
+      }
 
-   if(!ti.type)
-      update_time_zone_info();
+      days = days_of_civil_date((int64_t) ptm->tm_year + 1900, mon, mday, &leap_year, &rule_index);
 
-   t_ret = mktime_of_zone(ptm, &ti);
+      bad |= mday > (leap_year ? days_of_month_array_ly[mon] : days_of_month_array[mon]);
 
-   if(t_ret != (time64_t) -1)
-   {
-      localtime_of_zone(t_ret, ptm, &ti);
-   }
-   else
-   { /* We must not call localtime_of_zoner after a conversion error and
-        preserve errno if there was no conversion error. */
+      time_of_day = (int32_t) ((uint32_t) ptm->tm_sec + ((uint32_t) ptm->tm_min * 60u) + ((uint32_t) ptm->tm_hour * 3600u));
 
-      int err = errno;
-      errno = 0;
+      if(ptzi)
+      {
+         int32_t time_of_year = (int32_t) (leap_year ? startday_of_month_array_ly[mon] : startday_of_month_array[mon]);
+         time_of_year = ((time_of_year + mday - 1) * 86400) + time_of_day;
+         time_of_day += get_local_bias(ptzi, ptm->tm_isdst, time_of_year, rule_index);
+      }
 
-      t_ret = mktime_of_zone(ptm, &ti);
+      pt[i] = bad ? (time64_t) -1 : (time64_t) ((days * 86400) + time_of_day);
 
-      if(!errno)
-         localtime_of_zone(t_ret, ptm, &ti);
-      else
-         errno = err;
+      errors += bad;
+      bits   |= (uint8_t) (bad << (i & 7));
+
+      if(((i & 7) == 7) || (i + 1 == count))
+      {
+         if(perr)
+            perr[i >> 3] = bits;
+         bits = 0;
+      }
    }
 
-   if(pta_unlock)
-      pta_unlock(pv_lock_context);
+   return (errors);
+} /* size_t convert_tm_array(...) */
 
-   return(t_ret);
-} /* time64_t std_mktime(struct tm * ptm) */
+
+/* ------------------------------------------------------------------------- *\
+   new_timegm_array converts an array of struct tm as new_timegm does.
+   Bit (i % 8) of perr[i / 8] is set if the element i is invalid and its
+   result is -1 and it is cleared otherwise. perr may be NULL and errno is
+   not changed. The function returns the number of the invalid elements.
+\* ------------------------------------------------------------------------- */
+
+size_t new_timegm_array(const struct tm * ptm, time64_t * pt, uint8_t * perr, size_t count)
+{
+   if(!ptm || !pt)
+      return (count);
+
+   return (convert_tm_array(ptm, pt, perr, count, NULL));
+} /* size_t new_timegm_array(...) */
 
 
 /* ------------------------------------------------------------------------- *\
-   localtime_of_zone is just multithreading safe version of localtime
-   according to the time zone and daylight saving rules that are given
-   in a struct TIME_ZONE_INFO
+   mktime_of_zone_array converts an array of struct tm as mktime_of_zone
+   does. Bit (i % 8) of perr[i / 8] is set if the element i is invalid and
+   its result is -1 and it is cleared otherwise. perr may be NULL and errno
+   is not changed. The function returns the number of the invalid elements.
+\* ------------------------------------------------------------------------- */
 
-   Note: new_localtime_r returns the atronomical date that has a year 0.
-         If you need the historical date you can do this as following
-   ...
-   new_localtime_r(&t, ptm);
-   if(ptm->year <= -1900)
-      --ptm->year;
-   printf ( "The historical year was %s%i%s", ptm->year > -1900 ? "AD" : "",
-            ptm->year + 1900, ptm->year < -1900 ? " BC" : "");
-   ...
+size_t mktime_of_zone_array(const struct tm * ptm, time64_t * pt, uint8_t * perr, size_t count, const TIME_ZONE_INFO * ptzi)
+{
+   if(!ptm || !pt || !ptzi)
+      return (count);
 
-   In Posix 2024 systems ptm->tm_zone points to storage in the TIME_ZONE_INFO
-   struct. It becomes invalid once the storage of ptzi is released or adjusted.
+   return (convert_tm_array(ptm, pt, perr, count, ptzi));
+} /* size_t mktime_of_zone_array(...) */
+
+
+/* ========================================================================= *\
+   Columnar conversions
+\* ========================================================================= */
+
+/* ------------------------------------------------------------------------- *\
+   split_time splits a time into the days since 1/1/1970 and the seconds of
+   the day.
 \* ------------------------------------------------------------------------- */
-struct tm * localtime_of_zone(time64_t utc_time, struct tm * ptm, const TIME_ZONE_INFO * ptzi)
+
+static int64_t split_time(time64_t t, int32_t * ptime_of_day)
 {
-   const   TIME_ZONE_RULE * ptz;
-   int32_t isDaylightSaving = 0;
+   int64_t days        = t / 86400;
+   int32_t time_of_day = (int32_t) (t - (days * 86400));
 
-   if (ptzi->type > 1)
+   if(time_of_day < 0)
    {
-      int32_t  daylight_start; /* begin of day light saving in seconds after begin of the year */
-      int32_t  standard_start; /* begin of standard time in seconds after begin of the year */
-      int32_t  time_of_day;
-      uint32_t day;
-      int32_t  time_of_year;
-      int32_t  wday_year_start;
-      int32_t  leap_year = 1;
+      time_of_day += 86400;
+      --days;
+   }
 
-      int64_t  time = utc_time + ((int64_t) 719528 * 86400); /* add the time from 1/1/0000 to 1/1/1970 */
-      int64_t  year;
+   *ptime_of_day = time_of_day;
+   return (days);
+} /* int64_t split_time(time64_t t, int32_t * ptime_of_day) */
 
-      if (time < 0)
-         year = time / ((int64_t) 146097 * 86400) - 1; /* calculate the 400 year epoche before that time */
-      else
-         year = time / ((int64_t) 146097 * 86400); /* calculate the 400 year epoche before that time */
 
-      time -= year * ((int64_t) 146097 * 86400); /* time is between 0 an 400 AD now */
-      day  = (uint32_t) (time / 86400); /* number of days within the 400 year epoch */
-      time_of_day = (int32_t) (time - ((int64_t) day * 86400));
+/* ------------------------------------------------------------------------- *\
+   civil_of_days is a branch free helper that returns the year of the days
+   since 1/1/1970 and stores the month (0 = January), the day of the month,
+   the day of the year and whether the year is a leap year. The calculation
+   starts the years at the 1st of March internally because the leap day
+   becomes the last day of such a year then.
+\* ------------------------------------------------------------------------- */
 
-      if (day >= 36526)
-      {  /* the time is more than 100 years after a full 400 year epoch */
-         day -= 36526;
+static int64_t civil_of_days(int64_t days, int32_t * pmon, int32_t * pmday, int32_t * pyday, int32_t * pleap_year)
+{
+   int64_t z     = days + 719468;                                   /* days since 3/1/0000 */
+   int64_t epoch = ((z >= 0) ? z : (z - 146096)) / 146097;          /* 400 year epoch */
+   int32_t doe   = (int32_t) (z - (epoch * 146097));                /* day of the epoch between 0 and 146096 */
+   int32_t yoe   = (doe - (doe / 1460) + (doe / 36524) - (doe / 146096)) / 365; /* year of the epoch between 0 and 399 */
+   int32_t doy   = doe - ((365 * yoe) + (yoe / 4) - (yoe / 100));   /* day of the year that starts at the 1st of March */
+   int32_t mp    = ((5 * doy) + 2) / 153;                           /* month of the year that starts at the 1st of March */
+   int32_t jan   = (mp >= 10);                                      /* January and February belong to the next year */
+   int64_t year  = (epoch * 400) + yoe + jan;
+   int32_t leap_year = ((year & 3) == 0) & ((year % 100 != 0) | (year % 400 == 0));
 
-         if (day >= 36525)
-         {
-            day -= 36525;
+   *pmday      = doy - (((153 * mp) + 2) / 5) + 1;
+   *pmon       = jan ? (mp - 10) : (mp + 2);
+   *pyday      = jan ? (doy - 306) : (doy + 59 + leap_year);
+   *pleap_year = leap_year;
 
-            if (day >= 36525)
-               day -= 36525;
-         }
+   return (year);
+} /* int64_t civil_of_days(...) */
 
-         /* handle the first non leap years at begin of the century and ensure all remaining 4 year epochs start with a leap year */
-         if (day >= 1460)
-         {
-            day -= 1460;
-         }
-         else
-         {
-            leap_year = 0; /* we have to ignore the leap year within the first four years of a century */
+
+/* ------------------------------------------------------------------------- *\
+   get_rule_of_year returns the time zone rule that applies to the UTC time
+   of a year as localtime_of_zone determines it. It needs the seconds since
+   the begin of the UTC year and the index of the start times of the rules
+   of that year. It stores the daylight saving flag in pisdst.
+\* ------------------------------------------------------------------------- */
+
+static const TIME_ZONE_RULE * get_rule_of_year(const TIME_ZONE_INFO * ptzi, int32_t time_of_year, int32_t rule_index, int32_t * pisdst)
+{
+   const TIME_ZONE_RULE * ptz = &ptzi->standard;
+   int32_t isdst = 0;
+
+   if (ptzi->type > 1)
+   {
+      int32_t daylight_start = ptzi->daylight.start[rule_index] + ptzi->standard.bias; /* begin of the daylight saving in seconds after begin of the UTC year */
+      int32_t standard_start = ptzi->standard.start[rule_index] + ptzi->daylight.bias; /* begin of the standard time in seconds after begin of the UTC year */
+
+      if (daylight_start > standard_start)
+         isdst = (time_of_year < standard_start) | (time_of_year >= daylight_start); /* southern hemisphere */
+      else
+         isdst = (time_of_year >= daylight_start) & (time_of_year < standard_start); /* northern hemisphere */
+
+      if(isdst)
+         ptz = &ptzi->daylight;
+   }
+
+   *pisdst = isdst;
+   return (ptz);
+} /* const TIME_ZONE_RULE * get_rule_of_year(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   get_rule_index returns the index of the start times of the rules of the
+   year of the days since 1/1/1970 by the day of the week the year starts
+   with and whether it is a leap year.
+\* ------------------------------------------------------------------------- */
+
+static int32_t get_rule_index(int64_t days, int32_t yday, int32_t leap_year)
+{
+   int32_t wday_year_start = (int32_t) ((days - yday + 4 /* 1/1/1970 was a Thursday */) % 7);
+
+   if(wday_year_start < 0)
+      wday_year_start += 7;
+
+   return (wday_year_start + (leap_year * 7));
+} /* int32_t get_rule_index(int64_t days, int32_t yday, int32_t leap_year) */
+
+
+/* ------------------------------------------------------------------------- *\
+   get_utc_rule returns the time zone rule that applies to a UTC time as
+   localtime_of_zone determines it. It needs the days since 1/1/1970, the
+   day of the UTC year, the seconds of the UTC day and whether the UTC year
+   is a leap year. It stores the daylight saving flag in pisdst.
+\* ------------------------------------------------------------------------- */
+
+static const TIME_ZONE_RULE * get_utc_rule(const TIME_ZONE_INFO * ptzi, int64_t days, int32_t yday, int32_t time_of_day, int32_t leap_year, int32_t * pisdst)
+{
+   if (ptzi->type > 1)
+      return (get_rule_of_year(ptzi, (yday * 86400) + time_of_day, get_rule_index(days, yday, leap_year), pisdst));
+
+   *pisdst = 0;
+   return (&ptzi->standard);
+} /* const TIME_ZONE_RULE * get_utc_rule(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   set_local_columns stores the local broken-down time of t in the element i
+   of the columns of pcols as localtime_of_zone does. A ptzi of NULL means
+   UTC. It returns nonzero if the year is out of the range of an int32_t.
+\* ------------------------------------------------------------------------- */
+
+static int32_t set_local_columns(const TIME_COLUMNS * pcols, size_t i, time64_t t, const TIME_ZONE_INFO * ptzi)
+{
+   int32_t time_of_day;
+   int32_t mon;
+   int32_t mday;
+   int32_t yday;
+   int32_t leap_year;
+   int32_t isdst  = 0;
+   int32_t gmtoff = 0;
+   int64_t days   = split_time(t, &time_of_day);
+   int64_t year   = civil_of_days(days, &mon, &mday, &yday, &leap_year);
+
+   if(ptzi)
+   {
+      gmtoff = -get_utc_rule(ptzi, days, yday, time_of_day, leap_year, &isdst)->bias;
+
+      time_of_day += gmtoff;
+
+      if((uint32_t) time_of_day >= 86400)
+      { /* the local time is at another day than the UTC time */
+         days = split_time((days * 86400) + time_of_day, &time_of_day);
+         year = civil_of_days(days, &mon, &mday, &yday, &leap_year);
+      }
+   }
+
+   year -= 1900;
+
+   if(pcols->year)   pcols->year[i]   = (int32_t) year;
+   if(pcols->mon)    pcols->mon[i]    = (int8_t)  mon;
+   if(pcols->mday)   pcols->mday[i]   = (int8_t)  mday;
+   if(pcols->hour)   pcols->hour[i]   = (int8_t)  (time_of_day / 3600);
+   if(pcols->min)    pcols->min[i]    = (int8_t)  ((time_of_day / 60) % 60);
+   if(pcols->sec)    pcols->sec[i]    = (int8_t)  (time_of_day % 60);
+   if(pcols->yday)   pcols->yday[i]   = (int16_t) yday;
+   if(pcols->isdst)  pcols->isdst[i]  = (int8_t)  isdst;
+   if(pcols->gmtoff) pcols->gmtoff[i] = gmtoff;
+
+   if(pcols->wday)
+   {
+      int32_t wday = (int32_t) ((days + 4 /* 1/1/1970 was a Thursday */) % 7);
+      pcols->wday[i] = (int8_t) ((wday < 0) ? wday + 7 : wday);
+   }
+
+   return (year != (int32_t) year);
+} /* static int32_t set_local_columns(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   localtime_columns_of_zone converts an array of times into the columns of
+   local broken-down times as localtime_of_zone does. A ptzi of NULL means
+   UTC as new_gmtime_r does.
+\* ------------------------------------------------------------------------- */
+
+size_t localtime_columns_of_zone(const time64_t * pt, size_t count, const TIME_COLUMNS * pcols, uint8_t * perr, const TIME_ZONE_INFO * ptzi)
+{
+   size_t  errors = 0;
+   size_t  i;
+   uint8_t bits   = 0;
+
+   if(!pt || !pcols)
+      return (count);
+
+   for(i = 0; i < count; ++i)
+   {
+      int32_t bad = set_local_columns(pcols, i, pt[i], ptzi);
+
+      errors += bad;
+      bits   |= (uint8_t) (bad << (i & 7));
+
+      if(((i & 7) == 7) || (i + 1 == count))
+      {
+         if(perr)
+            perr[i >> 3] = bits;
+         bits = 0;
+      }
+   }
+
+   return (errors);
+} /* size_t localtime_columns_of_zone(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   mktime_columns_of_zone converts columns of local broken-down times into
+   an array of times as mktime_of_zone does. A ptzi of NULL means UTC as
+   new_timegm does.
+\* ------------------------------------------------------------------------- */
+
+size_t mktime_columns_of_zone(const TIME_COLUMNS * pcols, size_t count, time64_t * pt, uint8_t * perr, const TIME_ZONE_INFO * ptzi)
+{
+   size_t  errors = 0;
+   size_t  i;
+   uint8_t bits   = 0;
+
+   if(!pcols || !pt || !pcols->year || !pcols->mon || !pcols->mday)
+      return (count);
+
+   for(i = 0; i < count; ++i)
+   {
+      int32_t leap_year;
+      int32_t rule_index;
+      int64_t days;
+      int32_t mon   = pcols->mon[i];
+      int32_t mday  = pcols->mday[i];
+      int32_t hour  = pcols->hour ? pcols->hour[i] : 0;
+      int32_t min   = pcols->min  ? pcols->min[i]  : 0;
+      int32_t sec   = pcols->sec  ? pcols->sec[i]  : 0;
+      int32_t time_of_day;
+      int32_t bad   = ((uint32_t) sec  > 60) /* allow specification of a positive leap second */
+                    | ((uint32_t) min  > 59)
+                    | ((uint32_t) hour > 23)
+                    | ((uint32_t) mon  > 11)
+                    | (((uint32_t) mday - 1u) > 30);
+
+      if(bad)
+      { /* keep the table lookups valid, the element is invalid anyway */
+         mon  = 0;
+         mday = 1;
+      }
+
+      days = days_of_civil_date((int64_t) pcols->year[i] + 1900, mon, mday, &leap_year, &rule_index);
+
+      bad |= mday > (leap_year ? days_of_month_array_ly[mon] : days_of_month_array[mon]);
+
+      time_of_day = sec + (min * 60) + (hour * 3600);
+
+      if(ptzi)
+      {
+         int32_t time_of_year = (int32_t) (leap_year ? startday_of_month_array_ly[mon] : startday_of_month_array[mon]);
+         time_of_year = ((time_of_year + mday - 1) * 86400) + time_of_day;
+         time_of_day += get_local_bias(ptzi, pcols->isdst ? pcols->isdst[i] : -1, time_of_year, rule_index);
+      }
+
+      pt[i] = bad ? (time64_t) -1 : (time64_t) ((days * 86400) + time_of_day);
+
+      errors += bad;
+      bits   |= (uint8_t) (bad << (i & 7));
+
+      if(((i & 7) == 7) || (i + 1 == count))
+      {
+         if(perr)
+            perr[i >> 3] = bits;
+         bits = 0;
+      }
+   }
+
+   return (errors);
+} /* size_t mktime_columns_of_zone(...) */
+
+
+/* ========================================================================= *\
+   Calendar truncation in time zones
+\* ========================================================================= */
+
+/* ------------------------------------------------------------------------- *\
+   get_transitions_of_year returns the UTC time of the return to the
+   standard time in a UTC year and stores the UTC time of the begin of the
+   daylight saving in pdaylight_begin as localtime_of_zone determines them.
+\* ------------------------------------------------------------------------- */
+
+static int64_t get_transitions_of_year(const TIME_ZONE_INFO * ptzi, int64_t year, int64_t * pdaylight_begin)
+{
+   int32_t leap_year;
+   int32_t rule_index;
+   int64_t year_start = days_of_civil_date(year, 0, 1, &leap_year, &rule_index) * 86400;
+
+   *pdaylight_begin = year_start + ptzi->daylight.start[rule_index] + ptzi->standard.bias;
+   return (year_start + ptzi->standard.start[rule_index] + ptzi->daylight.bias);
+} /* int64_t get_transitions_of_year(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   get_rule_interval returns the time zone rule that applies at the time t
+   and stores the begin and the end of the interval of UTC times around t
+   that have the same rule if pbegin isn't NULL.
+\* ------------------------------------------------------------------------- */
+
+static const TIME_ZONE_RULE * get_rule_interval(const TIME_ZONE_INFO * ptzi, time64_t t, int64_t * pbegin, int64_t * pend)
+{
+   const TIME_ZONE_RULE * ptz;
+   int32_t time_of_day;
+   int32_t mon;
+   int32_t mday;
+   int32_t yday;
+   int32_t leap_year;
+   int32_t isdst;
+   int64_t days;
+   int64_t year;
+   int64_t first;
+   int64_t last;
+   int64_t tmp;
+
+   if(ptzi->type < 2)
+   {
+      if(pbegin)
+      {
+         *pbegin = INT64_MIN;
+         *pend   = INT64_MAX;
+      }
+      return (&ptzi->standard);
+   }
+
+   days = split_time(t, &time_of_day);
+   year = civil_of_days(days, &mon, &mday, &yday, &leap_year);
+   ptz  = get_utc_rule(ptzi, days, yday, time_of_day, leap_year, &isdst);
+
+   if(!pbegin)
+      return (ptz); /* the interval isn't required */
+
+   last = get_transitions_of_year(ptzi, year, &first);
+
+   if(first > last)
+   { /* southern hemisphere */
+      tmp   = first;
+      first = last;
+      last  = tmp;
+   }
+
+   if(t < first)
+   {
+      *pend   = first;
+      tmp     = get_transitions_of_year(ptzi, year - 1, &first);
+      *pbegin = (tmp > first) ? tmp : first;
+   }
+   else if(t >= last)
+   {
+      *pbegin = last;
+      tmp     = get_transitions_of_year(ptzi, year + 1, &first);
+      *pend   = (tmp < first) ? tmp : first;
+   }
+   else
+   {
+      *pbegin = first;
+      *pend   = last;
+   }
+
+   return (ptz);
+} /* const TIME_ZONE_RULE * get_rule_interval(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   get_offset_interval returns the offset of the local time to UTC in
+   seconds at the time t and stores the begin and the end of the interval
+   of UTC times around t that have the same offset. A ptzi of NULL means UTC.
+\* ------------------------------------------------------------------------- */
+
+static int32_t get_offset_interval(const TIME_ZONE_INFO * ptzi, time64_t t, int64_t * pbegin, int64_t * pend)
+{
+   if(!ptzi || (ptzi->type < 2))
+   {
+      *pbegin = INT64_MIN;
+      *pend   = INT64_MAX;
+      return (ptzi ? -ptzi->standard.bias : 0);
+   }
+
+   return (-get_rule_interval(ptzi, t, pbegin, pend)->bias);
+} /* int32_t get_offset_interval(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   The offset cache keeps the last interval of UTC times with the same
+   offset. An interval with begin and end of 0 is empty.
+\* ------------------------------------------------------------------------- */
+
+typedef struct ZONE_OFFSET_CACHE_S ZONE_OFFSET_CACHE;
+struct ZONE_OFFSET_CACHE_S
+{
+   int64_t begin;  /* first UTC time of the interval */
+   int64_t end;    /* UTC time after the interval */
+   int32_t offset; /* offset of the local time to UTC in seconds */
+};
+
+static int32_t get_cached_offset(const TIME_ZONE_INFO * ptzi, time64_t t, ZONE_OFFSET_CACHE * pcache)
+{
+   if((t < pcache->begin) || (t >= pcache->end))
+      pcache->offset = get_offset_interval(ptzi, t, &pcache->begin, &pcache->end);
+
+   return (pcache->offset);
+} /* int32_t get_cached_offset(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   get_local_period returns the first local day of the day, week, month,
+   quarter or year that contains the local day days and stores the local
+   day after that period in pend. Local days are counted since 1/1/1970.
+\* ------------------------------------------------------------------------- */
+
+static int64_t get_local_period(int64_t days, int unit, int64_t * pend)
+{
+   const uint16_t * pstartday;
+   int32_t          mon;
+   int32_t          mday;
+   int32_t          yday;
+   int32_t          leap_year;
+   int32_t          first;
+   int32_t          last;
+
+   if(unit == TIME_UNIT_DAY)
+   {
+      *pend = days + 1;
+      return (days);
+   }
+
+   if(unit == TIME_UNIT_WEEK)
+   {
+      int32_t wday = (int32_t) ((days + 3 /* 1/1/1970 was a Thursday */) % 7); /* 0 = Monday */
+
+      if(wday < 0)
+         wday += 7;
+
+      *pend = days - wday + 7;
+      return (days - wday);
+   }
+
+   civil_of_days(days, &mon, &mday, &yday, &leap_year);
+
+   days -= yday; /* begin of the year */
+
+   if(unit == TIME_UNIT_YEAR)
+   {
+      *pend = days + 365 + leap_year;
+      return (days);
+   }
+
+   pstartday = leap_year ? startday_of_month_array_ly : startday_of_month_array;
+   first     = (unit == TIME_UNIT_QUARTER) ? (mon - (mon % 3)) : mon;
+   last      = first + ((unit == TIME_UNIT_QUARTER) ? 3 : 1);
+
+   *pend = days + ((last < 12) ? pstartday[last] : (365 + leap_year));
+   return (days + pstartday[first]);
+} /* int64_t get_local_period(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   The truncation state keeps the offset intervals of the last time and of
+   the last begin of a period, the last local period of days and the local
+   begin of the last period.
+\* ------------------------------------------------------------------------- */
+
+typedef struct TRUNC_STATE_S TRUNC_STATE;
+struct TRUNC_STATE_S
+{
+   ZONE_OFFSET_CACHE time_offset;  /* offset interval of the truncated times */
+   ZONE_OFFSET_CACHE begin_offset; /* offset interval of the begins of the periods */
+   int64_t           period_begin; /* first local day of the last period */
+   int64_t           period_end;   /* local day after the last period */
+   int64_t           local_begin;  /* local begin of the last period in seconds since 1/1/1970 */
+};
+
+
+/* ------------------------------------------------------------------------- *\
+   trunc_time is the common implementation of trunc_time_of_zone and
+   trunc_time_array_of_zone. The local begin of the period is converted
+   with the offset of t if no daylight saving change lies in between.
+   Otherwise the intervals of the offsets are walked back from t. The
+   period starts at the last change whose local time before it is outside
+   of the period, i.e. if the local begin was skipped or if the local time
+   was set back into the period, or at the local begin in the interval that
+   contains it.
+\* ------------------------------------------------------------------------- */
+
+static time64_t trunc_time(time64_t t, int unit, const TIME_ZONE_INFO * ptzi, TRUNC_STATE * pstate)
+{
+   int32_t offset = get_cached_offset(ptzi, t, &pstate->time_offset);
+   int64_t local  = t + offset;
+   int64_t local_begin;
+   int64_t local_end;
+   int64_t begin;
+   int64_t change;
+
+   switch(unit)
+   {
+      case TIME_UNIT_SECOND:
+         local_begin = local;
+         local_end   = local + 1;
+         break;
+
+      case TIME_UNIT_MINUTE:
+         local_begin = local - (local % 60);
+         if(local_begin > local)
+            local_begin -= 60;
+         local_end = local_begin + 60;
+         break;
+
+      case TIME_UNIT_HOUR:
+         local_begin = local - (local % 3600);
+         if(local_begin > local)
+            local_begin -= 3600;
+         local_end = local_begin + 3600;
+         break;
+
+      default:
+      {
+         int32_t time_of_day;
+         int64_t days = split_time(local, &time_of_day);
+
+         if((days < pstate->period_begin) || (days >= pstate->period_end))
+            pstate->period_begin = get_local_period(days, unit, &pstate->period_end);
+
+         local_begin = pstate->period_begin * 86400;
+         local_end   = pstate->period_end * 86400;
+         break;
+      }
+   }
+
+   pstate->local_begin = local_begin;
+
+   begin  = local_begin - offset;
+   change = pstate->time_offset.begin;
+
+   while(begin < change)
+   { /* a change of the offset lies between the local begin and t */
+      int64_t local_before;
+
+      offset       = get_cached_offset(ptzi, change - 1, &pstate->begin_offset);
+      local_before = change - 1 + offset;
+
+      if((local_before < local_begin) || (local_before >= local_end))
+         return (change); /* the period starts with the change */
+
+      begin  = local_begin - offset;
+      change = pstate->begin_offset.begin;
+   }
+
+   return (begin);
+} /* time64_t trunc_time(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   trunc_time_of_zone returns the UTC time of the begin of the local period
+   of a unit that contains the time t in the time zone of ptzi.
+\* ------------------------------------------------------------------------- */
+
+time64_t trunc_time_of_zone(time64_t t, int unit, const TIME_ZONE_INFO * ptzi)
+{
+   TRUNC_STATE state;
+
+   if((unit < TIME_UNIT_SECOND) || (unit > TIME_UNIT_YEAR))
+   {
+      SET_ERRNO(EINVAL);
+      return ((time64_t) -1);
+   }
+
+   memset(&state, 0, sizeof(state));
+   return (trunc_time(t, unit, ptzi, &state));
+} /* time64_t trunc_time_of_zone(time64_t t, int unit, const TIME_ZONE_INFO * ptzi) */
+
+
+/* ------------------------------------------------------------------------- *\
+   trunc_time_array_of_zone truncates an array of times as
+   trunc_time_of_zone does.
+\* ------------------------------------------------------------------------- */
+
+int trunc_time_array_of_zone(const time64_t * pt, time64_t * presult, size_t count, int unit, const TIME_ZONE_INFO * ptzi)
+{
+   TRUNC_STATE state;
+   size_t      i;
+
+   if(!pt || !presult || (unit < TIME_UNIT_SECOND) || (unit > TIME_UNIT_YEAR))
+   {
+      SET_ERRNO(EINVAL);
+      return (0);
+   }
+
+   memset(&state, 0, sizeof(state));
+
+   for(i = 0; i < count; ++i)
+      presult[i] = trunc_time(pt[i], unit, ptzi, &state);
+
+   return (1);
+} /* int trunc_time_array_of_zone(...) */
+
+
+/* ========================================================================= *\
+   Iteration of local calendar boundaries
+\* ========================================================================= */
+
+/* ------------------------------------------------------------------------- *\
+   set_local_begin sets the local begin of the period of the next boundary
+   of an iterator together with its local year and month.
+\* ------------------------------------------------------------------------- */
+
+static void set_local_begin(TIME_BOUNDARIES * pit, int64_t local)
+{
+   int32_t time_of_day;
+   int32_t mday;
+   int32_t yday;
+   int32_t leap_year;
+
+   pit->local = local;
+
+   if(pit->unit >= TIME_UNIT_MONTH)
+      pit->year = civil_of_days(split_time(local, &time_of_day), &pit->mon, &mday, &yday, &leap_year);
+} /* void set_local_begin(TIME_BOUNDARIES * pit, int64_t local) */
+
+
+/* ------------------------------------------------------------------------- *\
+   step_local_period moves the local begin of the period of an iterator to
+   the begin of the following period.
+\* ------------------------------------------------------------------------- */
+
+static void step_local_period(TIME_BOUNDARIES * pit)
+{
+   static const int32_t unit_seconds[TIME_UNIT_MONTH] = { 1, 60, 3600, 86400, 7 * 86400 };
+
+   int32_t days   = 0;
+   int32_t months = 12;
+
+   if(pit->unit < TIME_UNIT_MONTH)
+   {
+      pit->local += unit_seconds[pit->unit];
+      return;
+   }
+
+   if(pit->unit == TIME_UNIT_MONTH)
+      months = 1;
+   else if(pit->unit == TIME_UNIT_QUARTER)
+      months = 3;
+
+   do
+   {
+      int32_t leap_year = ((pit->year & 3) == 0) & ((pit->year % 100 != 0) | (pit->year % 400 == 0));
+
+      days += leap_year ? days_of_month_array_ly[pit->mon] : days_of_month_array[pit->mon];
+
+      if(++pit->mon == 12)
+      {
+         pit->mon = 0;
+         ++pit->year;
+      }
+   }
+   while(--months);
+
+   pit->local += (int64_t) days * 86400;
+} /* void step_local_period(TIME_BOUNDARIES * pit) */
+
+
+/* ------------------------------------------------------------------------- *\
+   advance_boundary moves an iterator to the following boundary. The local
+   begin of the following period is converted with the offset of the
+   current boundary as long as no change of the offset lies in between.
+   Otherwise the period of the change is truncated as trunc_time_of_zone
+   does. The change itself is the next boundary if it begins a period, e.g.
+   the repeated hour after the return to the standard time or a day whose
+   midnight was skipped, and the stepping continues from its period.
+\* ------------------------------------------------------------------------- */
+
+static void advance_boundary(TIME_BOUNDARIES * pit)
+{
+   for(;;)
+   {
+      TRUNC_STATE state;
+      time64_t    t;
+      time64_t    change;
+
+      step_local_period(pit);
+
+      t = pit->local - pit->offset;
+
+      if(t < pit->offset_end)
+      {
+         pit->next = t;
+         return;
+      }
+
+      change = pit->offset_end;
+
+      memset(&state, 0, sizeof(state));
+      t = trunc_time(change, pit->unit, pit->ptzi, &state);
+
+      set_local_begin(pit, state.local_begin);
+      pit->offset_begin = state.time_offset.begin;
+      pit->offset_end   = state.time_offset.end;
+      pit->offset       = state.time_offset.offset;
+
+      if(t == change)
+      {
+         pit->next = t;
+         return;
+      }
+   }
+} /* void advance_boundary(TIME_BOUNDARIES * pit) */
+
+
+/* ------------------------------------------------------------------------- *\
+   init_time_boundaries initializes an iterator over the boundaries of the
+   local periods of a unit in a time zone.
+\* ------------------------------------------------------------------------- */
+
+int init_time_boundaries(TIME_BOUNDARIES * pit, time64_t begin, time64_t end, int unit, const TIME_ZONE_INFO * ptzi)
+{
+   TRUNC_STATE state;
+
+   if(!pit || (unit < TIME_UNIT_SECOND) || (unit > TIME_UNIT_YEAR))
+   {
+      SET_ERRNO(EINVAL);
+      return (0);
+   }
+
+   memset(&state, 0, sizeof(state));
+
+   pit->ptzi = ptzi;
+   pit->unit = unit;
+   pit->end  = end;
+   pit->next = trunc_time(begin, unit, ptzi, &state);
+
+   set_local_begin(pit, state.local_begin);
+   pit->offset = get_offset_interval(ptzi, pit->next, &pit->offset_begin, &pit->offset_end);
+
+   if(pit->next < begin)
+      advance_boundary(pit);
+
+   return (1);
+} /* int init_time_boundaries(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   next_time_boundary returns the next boundary of an iterator.
+\* ------------------------------------------------------------------------- */
+
+int next_time_boundary(TIME_BOUNDARIES * pit, time64_t * pt)
+{
+   if(pit->next >= pit->end)
+      return (0);
+
+   *pt = pit->next;
+   advance_boundary(pit);
+   return (1);
+} /* int next_time_boundary(TIME_BOUNDARIES * pit, time64_t * pt) */
+
+
+/* ------------------------------------------------------------------------- *\
+   get_time_boundaries returns up to count next boundaries of an iterator.
+\* ------------------------------------------------------------------------- */
+
+size_t get_time_boundaries(TIME_BOUNDARIES * pit, time64_t * pt, size_t count)
+{
+   size_t i;
+
+   for(i = 0; (i < count) && (pit->next < pit->end); ++i)
+   {
+      pt[i] = pit->next;
+      advance_boundary(pit);
+   }
+
+   return (i);
+} /* size_t get_time_boundaries(TIME_BOUNDARIES * pit, time64_t * pt, size_t count) */
+
+
+/* ========================================================================= *\
+   Daylight saving transitions
+\* ========================================================================= */
+
+/* ------------------------------------------------------------------------- *\
+   find_transition stores the change of the rules that begins the interval
+   of the time t, or the one that ends it if next is nonzero, in ptr.
+   Interval limits without a change of the offset, which rules with equal
+   biases may produce, are skipped.
+\* ------------------------------------------------------------------------- */
+
+static int find_transition(time64_t t, int next, TIME_ZONE_TRANSITION * ptr, const TIME_ZONE_INFO * ptzi)
+{
+   const TIME_ZONE_RULE * pbefore;
+   const TIME_ZONE_RULE * pafter;
+   int64_t begin;
+   int64_t end;
+   int     tries = 4;
+
+   if(!ptr || !ptzi)
+   {
+      SET_ERRNO(EINVAL);
+      return (0);
+   }
+
+   if((ptzi->type < 2) || (ptzi->standard.bias == ptzi->daylight.bias))
+      return (0);
+
+   do
+   {
+      get_rule_interval(ptzi, t, &begin, &end);
+
+      t = next ? end : begin;
+
+      if((t == INT64_MIN) || (t == INT64_MAX))
+         return (0);
+
+      pafter  = get_rule_interval(ptzi, t, &begin, &end);
+      pbefore = get_rule_interval(ptzi, t - 1, &begin, &end);
+
+      if(next)
+         ++t; /* search after the change if it doesn't change the offset */
+      else
+         --t; /* search before the change */
+   }
+   while((pbefore->bias == pafter->bias) && --tries);
+
+   if(pbefore->bias == pafter->bias)
+      return (0);
+
+   ptr->time          = next ? (t - 1) : (t + 1);
+   ptr->gmtoff_before = -pbefore->bias;
+   ptr->gmtoff_after  = -pafter->bias;
+   ptr->isdst_before  = (pbefore == &ptzi->daylight);
+   ptr->isdst_after   = (pafter  == &ptzi->daylight);
+   ptr->zone_before   = pbefore->zone_name;
+   ptr->zone_after    = pafter->zone_name;
+
+   return (1);
+} /* int find_transition(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   next_transition returns the first change of the offset after t.
+\* ------------------------------------------------------------------------- */
+
+int next_transition(time64_t t, TIME_ZONE_TRANSITION * ptr, const TIME_ZONE_INFO * ptzi)
+{
+   return (find_transition(t, 1, ptr, ptzi));
+} /* int next_transition(time64_t t, TIME_ZONE_TRANSITION * ptr, const TIME_ZONE_INFO * ptzi) */
+
+
+/* ------------------------------------------------------------------------- *\
+   prev_transition returns the last change of the offset at or before t.
+\* ------------------------------------------------------------------------- */
+
+int prev_transition(time64_t t, TIME_ZONE_TRANSITION * ptr, const TIME_ZONE_INFO * ptzi)
+{
+   return (find_transition(t, 0, ptr, ptzi));
+} /* int prev_transition(time64_t t, TIME_ZONE_TRANSITION * ptr, const TIME_ZONE_INFO * ptzi) */
+
+
+/* ------------------------------------------------------------------------- *\
+   utc_offset_of_zone returns the offset of the local time to UTC at the
+   time t and the interval that it is valid for.
+\* ------------------------------------------------------------------------- */
+
+int32_t utc_offset_of_zone(time64_t t, const TIME_ZONE_INFO * ptzi, int32_t * pisdst, time64_t * pbegin, time64_t * pend)
+{
+   const TIME_ZONE_RULE * ptz   = NULL;
+   int64_t                begin = INT64_MIN;
+   int64_t                end   = INT64_MAX;
+
+   if(ptzi)
+      ptz = get_rule_interval(ptzi, t, (pbegin || pend) ? &begin : NULL, &end);
+
+   if(pisdst)
+      *pisdst = ptz ? (ptz == &ptzi->daylight) : 0;
+
+   if(pbegin)
+      *pbegin = (time64_t) begin;
+
+   if(pend)
+      *pend = (time64_t) end;
+
+   return (ptz ? -ptz->bias : 0);
+} /* int32_t utc_offset_of_zone(...) */
+
+
+/* ========================================================================= *\
+   Calendar arithmetic in time zones
+\* ========================================================================= */
+
+/* ------------------------------------------------------------------------- *\
+   get_local_validity checks whether a local time of a year is valid with
+   the standard offset (bit 0) and with the daylight saving offset (bit 1)
+   by the same comparisons as localtime_of_zone does them for the UTC time
+   of each offset. It needs the local time in seconds since the begin of
+   the year and the index of the start times of the daylight saving rules
+   of that year.
+\* ------------------------------------------------------------------------- */
+
+static int get_local_validity(const TIME_ZONE_INFO * ptzi, int32_t time_of_year, int32_t rule_index)
+{
+   int32_t daylight_start = ptzi->daylight.start[rule_index] + ptzi->standard.bias; /* begin of the daylight saving in seconds after begin of the UTC year */
+   int32_t standard_start = ptzi->standard.start[rule_index] + ptzi->daylight.bias; /* begin of the standard time in seconds after begin of the UTC year */
+   int32_t standard       = time_of_year + ptzi->standard.bias; /* UTC time of the year with the standard offset */
+   int32_t daylight       = time_of_year + ptzi->daylight.bias; /* UTC time of the year with the daylight saving offset */
+   int     standard_in_daylight;
+   int     daylight_in_daylight;
+
+   if (daylight_start > standard_start)
+   { /* southern hemisphere */
+      standard_in_daylight = (standard < standard_start) | (standard >= daylight_start);
+      daylight_in_daylight = (daylight < standard_start) | (daylight >= daylight_start);
+   }
+   else
+   { /* northern hemisphere */
+      standard_in_daylight = (standard >= daylight_start) & (standard < standard_start);
+      daylight_in_daylight = (daylight >= daylight_start) & (daylight < standard_start);
+   }
+
+   return ((!standard_in_daylight) | (daylight_in_daylight << 1));
+} /* int get_local_validity(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   resolve_local_time converts a local time in seconds since 1/1/1970 into
+   UTC according to a policy for skipped and repeated local times. A local
+   time that is valid with both offsets of a zone is repeated and one that
+   is valid with none is skipped. In both cases the earlier UTC time is the
+   one with the larger offset. It needs the local time of the year and the
+   index of the start times of the daylight saving rules of that year.
+   It stores TIME_LOCAL_UNIQUE, TIME_LOCAL_SKIPPED or TIME_LOCAL_REPEATED in
+   pkind if it isn't NULL. The function returns 0 if the policy rejected
+   the local time.
+\* ------------------------------------------------------------------------- */
+
+static int resolve_local_time(int64_t local, int32_t time_of_year, int32_t rule_index, int policy, const TIME_ZONE_INFO * ptzi, time64_t * pt, int * pkind)
+{
+   int64_t standard;
+   int64_t daylight;
+   int     valid;
+
+   if(pkind)
+      *pkind = TIME_LOCAL_UNIQUE;
+
+   if(!ptzi || (ptzi->type < 2))
+   {
+      *pt = local + (ptzi ? ptzi->standard.bias : 0);
+      return (1);
+   }
+
+   standard = local + ptzi->standard.bias;
+   daylight = local + ptzi->daylight.bias;
+   valid    = get_local_validity(ptzi, time_of_year, rule_index);
+
+   if((valid == 1) || (standard == daylight))
+   {
+      *pt = standard;
+      return (1);
+   }
+
+   if(valid == 2)
+   {
+      *pt = daylight;
+      return (1);
+   }
+
+   if(pkind)
+      *pkind = valid ? TIME_LOCAL_REPEATED : TIME_LOCAL_SKIPPED;
+
+   if(   (policy == TIME_LOCAL_EARLIER)
+      || ((policy == TIME_LOCAL_COMPATIBLE) && (valid == 3)))
+   {
+      *pt = (standard < daylight) ? standard : daylight;
+      return (1);
+   }
+
+   if(policy != TIME_LOCAL_REJECT)
+   {
+      *pt = (standard > daylight) ? standard : daylight;
+      return (1);
+   }
+
+   *pt = (time64_t) -1;
+   return (0);
+} /* int resolve_local_time(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   split_local_time returns the local year of a time in a zone and stores
+   the local day since 1/1/1970, the month, the day of the month and the
+   seconds of the day. A ptzi of NULL means UTC.
+\* ------------------------------------------------------------------------- */
+
+static int64_t split_local_time(time64_t t, const TIME_ZONE_INFO * ptzi, int64_t * pday, int32_t * pmon, int32_t * pmday, int32_t * ptime_of_day)
+{
+   int32_t time_of_day;
+   int32_t yday;
+   int32_t leap_year;
+   int32_t isdst;
+   int64_t day  = split_time(t, &time_of_day);
+   int64_t year = civil_of_days(day, pmon, pmday, &yday, &leap_year);
+
+   if(ptzi)
+   {
+      time_of_day -= get_utc_rule(ptzi, day, yday, time_of_day, leap_year, &isdst)->bias;
+
+      if((uint32_t) time_of_day >= 86400)
+      { /* the local time is at another day than the UTC time */
+         day  = split_time((day * 86400) + time_of_day, &time_of_day);
+         year = civil_of_days(day, pmon, pmday, &yday, &leap_year);
+      }
+   }
+
+   *pday         = day;
+   *ptime_of_day = time_of_day;
+   return (year);
+} /* int64_t split_local_time(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   add_months_to_date adds months to a date and clamps a day of the month
+   that doesn't exist in the resulting month to its last day.
+\* ------------------------------------------------------------------------- */
+
+static void add_months_to_date(int64_t * pyear, int32_t * pmon, int32_t * pmday, int64_t months)
+{
+   int64_t year;
+   int32_t mon;
+   int32_t leap_year;
+   int32_t last_mday;
+
+   months += *pmon;
+   year    = *pyear + (months / 12);
+   mon     = (int32_t) (months % 12);
+
+   if(mon < 0)
+   {
+      mon += 12;
+      --year;
+   }
+
+   leap_year = ((year & 3) == 0) & ((year % 100 != 0) | (year % 400 == 0));
+   last_mday = leap_year ? days_of_month_array_ly[mon] : days_of_month_array[mon];
+
+   if(*pmday > last_mday)
+      *pmday = last_mday;
+
+   *pyear = year;
+   *pmon  = mon;
+} /* void add_months_to_date(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   resolve_local_date converts a local date plus a number of days and a time
+   of the day into UTC as resolve_local_time does. The date is split again
+   only if days are added.
+\* ------------------------------------------------------------------------- */
+
+static int resolve_local_date(int64_t year, int32_t mon, int32_t mday, int64_t days, int32_t time_of_day, int policy, const TIME_ZONE_INFO * ptzi, time64_t * pt)
+{
+   int32_t leap_year;
+   int32_t rule_index;
+   int64_t day  = days_of_civil_date(year, mon, mday, &leap_year, &rule_index);
+   int32_t yday = (leap_year ? startday_of_month_array_ly[mon] : startday_of_month_array[mon]) + mday - 1;
+
+   if(days)
+   {
+      int32_t wday_year_start;
+
+      day += days;
+      civil_of_days(day, &mon, &mday, &yday, &leap_year);
+
+      wday_year_start = (int32_t) ((day - yday + 4 /* 1/1/1970 was a Thursday */) % 7);
+
+      if(wday_year_start < 0)
+         wday_year_start += 7;
+
+      rule_index = wday_year_start + (leap_year * 7);
+   }
+
+   return (resolve_local_time((day * 86400) + time_of_day, (yday * 86400) + time_of_day, rule_index, policy, ptzi, pt, NULL));
+} /* int resolve_local_date(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   add_time is the common implementation of add_time_of_zone and
+   add_time_array_of_zone. The local date is split once, the months are
+   added to its fields and the days to its day number.
+\* ------------------------------------------------------------------------- */
+
+static int add_time(time64_t t, int64_t months, int32_t days, int policy, const TIME_ZONE_INFO * ptzi, time64_t * pt)
+{
+   int64_t day;
+   int32_t mon;
+   int32_t mday;
+   int32_t time_of_day;
+   int64_t year = split_local_time(t, ptzi, &day, &mon, &mday, &time_of_day);
+
+   if(months)
+      add_months_to_date(&year, &mon, &mday, months);
+
+   return (resolve_local_date(year, mon, mday, days, time_of_day, policy, ptzi, pt));
+} /* int add_time(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   add_time_of_zone adds calendar years, months and days to the local date
+   of a time in a zone.
+\* ------------------------------------------------------------------------- */
+
+time64_t add_time_of_zone(time64_t t, int32_t years, int32_t months, int32_t days, int policy, const TIME_ZONE_INFO * ptzi)
+{
+   if((policy < TIME_LOCAL_COMPATIBLE) || (policy > TIME_LOCAL_REJECT))
+   {
+      SET_ERRNO(EINVAL);
+      return ((time64_t) -1);
+   }
+
+   if(!add_time(t, ((int64_t) years * 12) + months, days, policy, ptzi, &t))
+      SET_ERRNO(ERANGE);
+
+   return (t);
+} /* time64_t add_time_of_zone(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   add_time_array_of_zone adds calendar years, months and days to an array
+   of times as add_time_of_zone does.
+\* ------------------------------------------------------------------------- */
+
+size_t add_time_array_of_zone(const time64_t * pt, time64_t * presult, uint8_t * perr, size_t count, int32_t years, int32_t months, int32_t days, int policy, const TIME_ZONE_INFO * ptzi)
+{
+   int64_t all_months = ((int64_t) years * 12) + months;
+   size_t  errors     = 0;
+   size_t  i;
+   uint8_t bits       = 0;
+
+   if(!pt || !presult || (policy < TIME_LOCAL_COMPATIBLE) || (policy > TIME_LOCAL_REJECT))
+      return (count);
+
+   for(i = 0; i < count; ++i)
+   {
+      int bad = !add_time(pt[i], all_months, days, policy, ptzi, &presult[i]);
+
+      errors += bad;
+      bits   |= (uint8_t) (bad << (i & 7));
+
+      if(((i & 7) == 7) || (i + 1 == count))
+      {
+         if(perr)
+            perr[i >> 3] = bits;
+         bits = 0;
+      }
+   }
+
+   return (errors);
+} /* size_t add_time_array_of_zone(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   get_max_offset returns the largest offset of the local time to UTC in
+   seconds that the time zone of ptzi has. A ptzi of NULL means UTC.
+\* ------------------------------------------------------------------------- */
+
+static int32_t get_max_offset(const TIME_ZONE_INFO * ptzi)
+{
+   int32_t bias;
+
+   if(!ptzi)
+      return (0);
+
+   bias = ptzi->standard.bias;
+
+   if((ptzi->type >= 2) && (ptzi->daylight.bias < bias))
+      bias = ptzi->daylight.bias;
+
+   return (-bias);
+} /* int32_t get_max_offset(const TIME_ZONE_INFO * ptzi) */
+
+
+/* ------------------------------------------------------------------------- *   diff_time is the common implementation of diff_time_of_zone and
+   diff_time_array_of_zone for valid units. The months follow from the
+   local year and month numbers and the days from the local day numbers.
+   The local time of t1 at the date of t2 is taken only if it may resolve
+   to a time before t2. That is the case if it isn't after the local time
+   of t2 or if the local time was set back before t2 by at least their
+   difference, e.g. if t2 is in the repeated hour after a daylight saving
+   change. If the local time of t1 after adding them resolves to a time
+   after t2, e.g. because of a skipped local time, one day or month less
+   is taken.
+\* ------------------------------------------------------------------------- */
+
+static void diff_time(time64_t t1, time64_t t2, int largest_unit, TIME_DIFF * pdiff, const TIME_ZONE_INFO * ptzi)
+{
+   int64_t sign   = 1;
+   int64_t months = 0;
+   int64_t days   = 0;
+   int64_t rest;
+
+   if(t2 < t1)
+   {
+      time64_t tmp = t1;
+
+      t1   = t2;
+      t2   = tmp;
+      sign = -1;
+   }
+
+   if(largest_unit >= TIME_UNIT_DAY)
+   {
+      int64_t  day;
+      int64_t  day1;
+      int64_t  day2;
+      int64_t  year;
+      int32_t  mon;
+      int32_t  mday;
+      int32_t  mon1;
+      int32_t  mon2;
+      int32_t  mday1;
+      int32_t  mday2;
+      int32_t  time_of_day1;
+      int32_t  time_of_day2;
+      int32_t  leap_year;
+      int32_t  rule_index;
+      time64_t t     = t1;
+      int64_t  year1 = split_local_time(t1, ptzi, &day1, &mon1, &mday1, &time_of_day1);
+      int64_t  year2 = split_local_time(t2, ptzi, &day2, &mon2, &mday2, &time_of_day2);
+      int64_t  set_back;  /* the most that the local time may have been set back before t2 */
+      int      found = 0;
+
+      set_back = get_max_offset(ptzi) - ((day2 * 86400) + time_of_day2 - t2);
+
+      if(largest_unit >= TIME_UNIT_MONTH)
+      {
+         months = ((year2 - year1) * 12) + (mon2 - mon1);
+
+         if(months > 0)
+         {
+            year = year1;
+            mon  = mon1;
+            mday = mday1;
+            add_months_to_date(&year, &mon, &mday, months);
+
+            if((mday > mday2) || ((mday == mday2) && (time_of_day1 - time_of_day2 > set_back)))
+               --months;
+         }
+         else
+         {
+            months = 0;
+         }
+      }
+
+      for(;;)
+      {
+         year = year1;
+         mon  = mon1;
+         mday = mday1;
+
+         if(months)
+            add_months_to_date(&year, &mon, &mday, months);
+
+         day  = days_of_civil_date(year, mon, mday, &leap_year, &rule_index);
+         days = day2 - day - (time_of_day1 - time_of_day2 > set_back);
+
+         while((days >= 0) && !found)
+         {
+            if(!months && !days)
+               t = t1;
+            else if((day + days == day2) || ((day + days == day2 - 1) && (mday2 > 1)))
+               resolve_local_date(year2, mon2, mday2 - (int32_t) (day2 - day - days), 0, time_of_day1, TIME_LOCAL_COMPATIBLE, ptzi, &t); /* the date of t2 or the day before, no split required */
+            else
+               resolve_local_date(year, mon, mday, days, time_of_day1, TIME_LOCAL_COMPATIBLE, ptzi, &t);
+
+            found = (t <= t2);
+
+            if(!found)
+               --days;
+         }
+
+         if(found)
+            break;
+
+         if(!months)
+         { /* the local time of t2 is before the one of t1 because it is repeated */
+            t    = t1;
+            days = 0;
+            break;
+         }
+
+         --months;
+      }
+
+      rest = t2 - t;
+   }
+   else
+   {
+      rest = t2 - t1;
+   }
+
+   memset(pdiff, 0, sizeof(*pdiff));
+
+   if(largest_unit == TIME_UNIT_YEAR)
+   {
+      pdiff->years = sign * (months / 12);
+      months %= 12;
+   }
+
+   pdiff->months = sign * months;
+   pdiff->days   = sign * days;
+
+   if(largest_unit >= TIME_UNIT_HOUR)
+   {
+      pdiff->hours = sign * (rest / 3600);
+      rest %= 3600;
+   }
+
+   if(largest_unit >= TIME_UNIT_MINUTE)
+   {
+      pdiff->minutes = sign * (rest / 60);
+      rest %= 60;
+   }
+
+   pdiff->seconds = sign * rest;
+} /* void diff_time(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   diff_time_of_zone returns the difference of two times in calendar units
+   of a time zone.
+\* ------------------------------------------------------------------------- */
+
+int diff_time_of_zone(time64_t t1, time64_t t2, int largest_unit, TIME_DIFF * pdiff, const TIME_ZONE_INFO * ptzi)
+{
+   if(!pdiff || (largest_unit < TIME_UNIT_SECOND) || (largest_unit > TIME_UNIT_YEAR) || (largest_unit == TIME_UNIT_WEEK) || (largest_unit == TIME_UNIT_QUARTER))
+   {
+      SET_ERRNO(EINVAL);
+      return (0);
+   }
+
+   diff_time(t1, t2, largest_unit, pdiff, ptzi);
+   return (1);
+} /* int diff_time_of_zone(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   diff_time_array_of_zone returns the differences of arrays of pairs of
+   times as diff_time_of_zone does.
+\* ------------------------------------------------------------------------- */
+
+int diff_time_array_of_zone(const time64_t * pt1, const time64_t * pt2, TIME_DIFF * pdiff, size_t count, int largest_unit, const TIME_ZONE_INFO * ptzi)
+{
+   size_t i;
+
+   if(!pt1 || !pt2 || !pdiff || (largest_unit < TIME_UNIT_SECOND) || (largest_unit > TIME_UNIT_YEAR) || (largest_unit == TIME_UNIT_WEEK) || (largest_unit == TIME_UNIT_QUARTER))
+   {
+      SET_ERRNO(EINVAL);
+      return (0);
+   }
+
+   for(i = 0; i < count; ++i)
+      diff_time(pt1[i], pt2[i], largest_unit, &pdiff[i], ptzi);
+
+   return (1);
+} /* int diff_time_array_of_zone(...) */
+
+
+/* ========================================================================= *\
+   Conversions of nanosecond times
+\* ========================================================================= */
+
+/* ------------------------------------------------------------------------- *\
+   split_time_ns returns the seconds of a count of nanoseconds since
+   1/1/1970 UTC by a floor division and stores the nanoseconds of that
+   second between 0 and 999999999 in pnsec if it isn't NULL.
+\* ------------------------------------------------------------------------- */
+
+time64_t split_time_ns(int64_t ns, int32_t * pnsec)
+{
+   int64_t t    = ns / 1000000000;
+   int32_t nsec = (int32_t) (ns - t * 1000000000);
+
+   if(nsec < 0)
+   { /* the division truncates towards zero */
+      nsec += 1000000000;
+      --t;
+   }
+
+   if(pnsec)
+      *pnsec = nsec;
+
+   return ((time64_t) t);
+} /* time64_t split_time_ns(int64_t ns, int32_t * pnsec) */
+
+
+/* ------------------------------------------------------------------------- *\
+   join_time_ns returns the count of nanoseconds since 1/1/1970 UTC of t
+   seconds and nsec nanoseconds. It returns -1 and sets errno to EOVERFLOW
+   if the result is out of the range of an int64_t.
+\* ------------------------------------------------------------------------- */
+
+int64_t join_time_ns(time64_t t, int32_t nsec)
+{
+   /* seconds and nanoseconds of INT64_MIN and INT64_MAX as split_time_ns returns them */
+   const int64_t min_t    = -(int64_t) 9223372037;
+   const int32_t min_nsec = 145224192;
+   const int64_t max_t    = (int64_t) 9223372036;
+   const int32_t max_nsec = 854775807;
+
+   int64_t ns = -1;
+
+   if((t >= min_t - 3) && (t <= max_t + 3))
+   { /* the normalization can't overflow */
+      t   += nsec / 1000000000;
+      nsec = nsec % 1000000000;
+
+      if(nsec < 0)
+      {
+         nsec += 1000000000;
+         --t;
+      }
+   }
+
+   if((t < min_t) || ((t == min_t) && (nsec < min_nsec)) || (t > max_t) || ((t == max_t) && (nsec > max_nsec)))
+   {
+#ifdef EOVERFLOW
+      SET_ERRNO(EOVERFLOW);
+#else
+      SET_ERRNO(ERANGE);
+#endif
+      goto Exit;
+   }
+
+   if(t < 0) /* t * 1000000000 of min_t is out of the range of an int64_t */
+      ns = (t + 1) * 1000000000 + (nsec - 1000000000);
+   else
+      ns = t * 1000000000 + nsec;
+
+   Exit:;
+   return (ns);
+} /* int64_t join_time_ns(time64_t t, int32_t nsec) */
+
+
+/* ------------------------------------------------------------------------- *\
+   new_gmtime_ns_r converts a nanosecond time as new_gmtime_r does and
+   stores the nanoseconds of the second in pnsec if it isn't NULL.
+\* ------------------------------------------------------------------------- */
+
+struct tm * new_gmtime_ns_r(int64_t ns, struct tm * ptm, int32_t * pnsec)
+{
+   return (new_gmtime_r(split_time_ns(ns, pnsec), ptm));
+} /* struct tm * new_gmtime_ns_r(int64_t ns, struct tm * ptm, int32_t * pnsec) */
+
+
+/* ------------------------------------------------------------------------- *\
+   localtime_of_zone_ns converts a nanosecond time as localtime_of_zone does
+   and stores the nanoseconds of the second in pnsec if it isn't NULL.
+\* ------------------------------------------------------------------------- */
+
+struct tm * localtime_of_zone_ns(int64_t ns, struct tm * ptm, int32_t * pnsec, const TIME_ZONE_INFO * ptzi)
+{
+   return (localtime_of_zone(split_time_ns(ns, pnsec), ptm, ptzi));
+} /* struct tm * localtime_of_zone_ns(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   join_converted_time returns the nanosecond time of a time t that was
+   converted with errno cleared before. A result of -1 of the conversion is
+   an error only if errno was set then. Otherwise errno is restored to err.
+\* ------------------------------------------------------------------------- */
+
+static int64_t join_converted_time(time64_t t, int32_t nsec, int err)
+{
+   if((t == (time64_t) -1) && errno)
+      return (-1);
+
+   errno = err;
+   return (join_time_ns(t, nsec));
+} /* static int64_t join_converted_time(time64_t t, int32_t nsec, int err) */
+
+
+/* ------------------------------------------------------------------------- *\
+   new_timegm_ns returns the nanosecond time of a broken-down UTC time and
+   nsec nanoseconds as new_timegm does.
+\* ------------------------------------------------------------------------- */
+
+int64_t new_timegm_ns(const struct tm * ptm, int32_t nsec)
+{
+   int err = errno;
+
+   errno = 0;
+   return (join_converted_time(new_timegm(ptm), nsec, err));
+} /* int64_t new_timegm_ns(const struct tm * ptm, int32_t nsec) */
+
+
+/* ------------------------------------------------------------------------- *\
+   mktime_of_zone_ns returns the nanosecond time of a broken-down local time
+   and nsec nanoseconds as mktime_of_zone does.
+\* ------------------------------------------------------------------------- */
+
+int64_t mktime_of_zone_ns(const struct tm * ptm, int32_t nsec, const TIME_ZONE_INFO * ptzi)
+{
+   int err = errno;
+
+   errno = 0;
+   return (join_converted_time(mktime_of_zone(ptm, ptzi), nsec, err));
+} /* int64_t mktime_of_zone_ns(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   put_digits writes value with digits decimal digits and leading zeros to
+   p and returns the position behind them.
+\* ------------------------------------------------------------------------- */
+
+static char * put_digits(char * p, uint32_t value, int digits)
+{
+   char * pend = p + digits;
+
+   for(p = pend; digits > 0; --digits)
+   {
+      *--p   = (char) ('0' + value % 10);
+      value /= 10;
+   }
+
+   return (pend);
+} /* static char * put_digits(char * p, uint32_t value, int digits) */
+
+
+/* ------------------------------------------------------------------------- *\
+   put_year writes a year with 4 digits or with a sign and at least 4 digits
+   if it is before 0 or after 9999 as the expanded representation of
+   ISO 8601 does. The year needs to be in the range of an int32_t. It
+   returns the position after the year.
+\* ------------------------------------------------------------------------- */
+
+static char * put_year(char * p, int64_t year)
+{
+   static const uint32_t digit_limits[10] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+
+   uint32_t value;
+   int      count = 4;
+
+   if((year >= 0) && (year <= 9999))
+      return (put_digits(p, (uint32_t) year, 4));
+
+   value = (uint32_t) (year < 0 ? -year : year);
+
+   while((count < 10) && (value >= digit_limits[count]))
+      ++count;
+
+   *p++ = year < 0 ? '-' : '+';
+   return (put_digits(p, value, count));
+} /* static char * put_year(char * p, int64_t year) */
+
+
+/* ------------------------------------------------------------------------- *\
+   format_time writes the time t with nsec nanoseconds as RFC 3339 local
+   time of the time zone of ptzi with digits fractional digits into buf.
+   Years before 0 or after 9999 are written with a sign and at least 4
+   digits as the expanded representation of ISO 8601 does. It returns the
+   length of the string or 0 in error case.
+\* ------------------------------------------------------------------------- */
+
+static size_t format_time(time64_t t, int32_t nsec, int digits, char * buf, size_t size, const TIME_ZONE_INFO * ptzi)
+{
+   static const int32_t fraction_divisors[10] = { 1000000000, 100000000, 10000000, 1000000, 100000, 10000, 1000, 100, 10, 1 };
+
+   char      str[TIME_FORMAT_NS_SIZE];
+   char *    p   = str;
+   size_t    len = 0;
+   struct tm tm;
+   int64_t   year;
+   int32_t   offset;
+
+   if(!buf || (digits < 0) || (digits > 9))
+   {
+      SET_ERRNO(EINVAL);
+      goto Exit;
+   }
+
+   if((t < INT64_MIN + 86400) || (t > INT64_MAX - 86400))
+   { /* the local time is out of the range of a time64_t */
+#ifdef EOVERFLOW
+      SET_ERRNO(EOVERFLOW);
+#else
+      SET_ERRNO(ERANGE);
+#endif
+      goto Exit;
+   }
+
+   offset = utc_offset_of_zone(t, ptzi, NULL, NULL, NULL);
+
+   if(!new_gmtime_r(t + offset, &tm))
+      goto Exit; /* the year is out of the range of an int */
+
+   year = (int64_t) tm.tm_year + 1900;
+   p    = put_year(p, year);
+
+   *p++ = '-';
+   p    = put_digits(p, (uint32_t) (tm.tm_mon + 1), 2);
+   *p++ = '-';
+   p    = put_digits(p, (uint32_t) tm.tm_mday, 2);
+   *p++ = 'T';
+   p    = put_digits(p, (uint32_t) tm.tm_hour, 2);
+   *p++ = ':';
+   p    = put_digits(p, (uint32_t) tm.tm_min, 2);
+   *p++ = ':';
+   p    = put_digits(p, (uint32_t) tm.tm_sec, 2);
+
+   if(digits)
+   {
+      *p++ = '.';
+      p    = put_digits(p, (uint32_t) (nsec / fraction_divisors[digits]), digits);
+   }
+
+   if(!ptzi)
+   {
+      *p++ = 'Z';
+   }
+   else
+   {
+      uint32_t seconds = (uint32_t) (offset < 0 ? -offset : offset);
+
+      *p++ = offset < 0 ? '-' : '+';
+      p    = put_digits(p, seconds / 3600, 2);
+      *p++ = ':';
+      p    = put_digits(p, seconds / 60 % 60, 2);
+
+      if(seconds % 60)
+      {
+         *p++ = ':';
+         p    = put_digits(p, seconds % 60, 2);
+      }
+   }
+
+   len = (size_t) (p - str);
+
+   if(len >= size)
+   {
+      SET_ERRNO(ERANGE);
+      len = 0;
+      goto Exit;
+   }
+
+   memcpy(buf, str, len);
+   buf[len] = '\0';
+
+   Exit:;
+   return (len);
+} /* static size_t format_time(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   format_time_of_zone_ns writes a nanosecond time as RFC 3339 local time of
+   the time zone of ptzi with digits fractional digits into buf as
+   format_time does. The year of a nanosecond time has always 4 digits.
+\* ------------------------------------------------------------------------- */
+
+size_t format_time_of_zone_ns(int64_t ns, int digits, char * buf, size_t size, const TIME_ZONE_INFO * ptzi)
+{
+   int32_t  nsec;
+   time64_t t = split_time_ns(ns, &nsec);
+
+   return (format_time(t, nsec, digits, buf, size, ptzi));
+} /* size_t format_time_of_zone_ns(...) */
+
+
+/* ========================================================================= *\
+   Wide-range nanosecond times
+\* ========================================================================= */
+
+/* ------------------------------------------------------------------------- *\
+   make_time_ns stores t seconds and nsec nanoseconds in pts with the
+   nanoseconds normalized by a floor division. It returns nonzero in
+   success case and sets errno to EOVERFLOW if the seconds are out of the
+   range of a time64_t.
+\* ------------------------------------------------------------------------- */
+
+int make_time_ns(TIME_NS * pts, time64_t t, int64_t nsec)
+{
+   int     bRet = 0;
+   int64_t sec;
+   int32_t ns;
+
+   if(!pts)
+   {
+      SET_ERRNO(EINVAL);
+      goto Exit;
+   }
+
+   sec = split_time_ns(nsec, &ns);
+
+   if((sec > 0) ? (t > INT64_MAX - sec) : (t < INT64_MIN - sec))
+   {
+#ifdef EOVERFLOW
+      SET_ERRNO(EOVERFLOW);
+#else
+      SET_ERRNO(ERANGE);
+#endif
+      goto Exit;
+   }
+
+   pts->sec  = t + sec;
+   pts->nsec = ns;
+   bRet = 1;
+
+   Exit:;
+   return (bRet);
+} /* int make_time_ns(TIME_NS * pts, time64_t t, int64_t nsec) */
+
+
+/* ------------------------------------------------------------------------- *\
+   ns_of_time_ns returns the count of nanoseconds since 1/1/1970 UTC of a
+   wide-range time as join_time_ns does.
+\* ------------------------------------------------------------------------- */
+
+int64_t ns_of_time_ns(const TIME_NS * pts)
+{
+   if(!pts)
+   {
+      SET_ERRNO(EINVAL);
+      return (-1);
+   }
+
+   return (join_time_ns(pts->sec, pts->nsec));
+} /* int64_t ns_of_time_ns(const TIME_NS * pts) */
+
+
+/* ------------------------------------------------------------------------- *\
+   compare_time_ns returns -1, 0 or 1 if the time of pts1 is before, equal
+   or after the one of pts2.
+\* ------------------------------------------------------------------------- */
+
+int compare_time_ns(const TIME_NS * pts1, const TIME_NS * pts2)
+{
+   if(pts1->sec != pts2->sec)
+      return (pts1->sec < pts2->sec ? -1 : 1);
+
+   if(pts1->nsec != pts2->nsec)
+      return (pts1->nsec < pts2->nsec ? -1 : 1);
+
+   return (0);
+} /* int compare_time_ns(const TIME_NS * pts1, const TIME_NS * pts2) */
+
+
+/* ------------------------------------------------------------------------- *\
+   set_time_ns_sum stores the sum of the seconds and nanoseconds in pts with
+   a carry of the nanoseconds. The nanoseconds must be between -999999999
+   and 1999999999.
+\* ------------------------------------------------------------------------- */
+
+static int set_time_ns_sum(TIME_NS * pts, time64_t sec1, time64_t sec2, int32_t nsec)
+{
+   if(nsec >= 1000000000)
+   {
+      nsec -= 1000000000;
+
+      if(sec2 < INT64_MAX)
+         ++sec2;
+      else if(sec1 < INT64_MAX)
+         ++sec1;
+      else
+         goto Overflow;
+   }
+   else if(nsec < 0)
+   {
+      nsec += 1000000000;
+
+      if(sec2 > INT64_MIN)
+         --sec2;
+      else if(sec1 > INT64_MIN)
+         --sec1;
+      else
+         goto Overflow;
+   }
+
+   if((sec2 > 0) ? (sec1 > INT64_MAX - sec2) : (sec1 < INT64_MIN - sec2))
+      goto Overflow;
+
+   pts->sec  = sec1 + sec2;
+   pts->nsec = nsec;
+   return (1);
+
+   Overflow:;
+#ifdef EOVERFLOW
+   SET_ERRNO(EOVERFLOW);
+#else
+   SET_ERRNO(ERANGE);
+#endif
+   return (0);
+} /* static int set_time_ns_sum(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   valid_time_ns checks whether pts isn't NULL and the nanoseconds of the
+   wide-range time are normalized.
+\* ------------------------------------------------------------------------- */
+
+static int valid_time_ns(const TIME_NS * pts)
+{
+   return (pts && (pts->nsec >= 0) && (pts->nsec < 1000000000));
+} /* static int valid_time_ns(const TIME_NS * pts) */
+
+
+/* ------------------------------------------------------------------------- *\
+   add_time_ns stores the sum of the time of pts and the duration of pdur in
+   presult. sub_time_ns stores the duration from the time of pts2 until the
+   one of pts1 in presult. Both return nonzero in success case.
+\* ------------------------------------------------------------------------- */
+
+int add_time_ns(TIME_NS * presult, const TIME_NS * pts, const TIME_NS * pdur)
+{
+   if(!presult || !valid_time_ns(pts) || !valid_time_ns(pdur))
+   {
+      SET_ERRNO(EINVAL);
+      return (0);
+   }
+
+   return (set_time_ns_sum(presult, pts->sec, pdur->sec, pts->nsec + pdur->nsec));
+} /* int add_time_ns(TIME_NS * presult, const TIME_NS * pts, const TIME_NS * pdur) */
+
+
+int sub_time_ns(TIME_NS * presult, const TIME_NS * pts1, const TIME_NS * pts2)
+{
+   if(!presult || !valid_time_ns(pts1) || !valid_time_ns(pts2))
+   {
+      SET_ERRNO(EINVAL);
+      return (0);
+   }
+
+   if(pts2->sec == INT64_MIN) /* -INT64_MIN is INT64_MAX + 1 */
+      return (set_time_ns_sum(presult, pts1->sec, INT64_MAX, pts1->nsec - pts2->nsec + 1000000000));
+
+   return (set_time_ns_sum(presult, pts1->sec, -pts2->sec, pts1->nsec - pts2->nsec));
+} /* int sub_time_ns(TIME_NS * presult, const TIME_NS * pts1, const TIME_NS * pts2) */
+
+
+/* ------------------------------------------------------------------------- *\
+   format_time_ns_of_zone writes a wide-range time as RFC 3339 local time
+   of the time zone of ptzi with digits fractional digits into buf as
+   format_time does.
+\* ------------------------------------------------------------------------- */
+
+size_t format_time_ns_of_zone(const TIME_NS * pts, int digits, char * buf, size_t size, const TIME_ZONE_INFO * ptzi)
+{
+   if(!valid_time_ns(pts))
+   {
+      SET_ERRNO(EINVAL);
+      return (0);
+   }
+
+   return (format_time(pts->sec, pts->nsec, digits, buf, size, ptzi));
+} /* size_t format_time_ns_of_zone(...) */
+
+
+/* ========================================================================= *\
+   Conversions of one time into many time zones
+\* ========================================================================= */
+
+/* ------------------------------------------------------------------------- *\
+   LOCAL_DAY keeps the civil date of a day since 1/1/1970 for the time
+   zones whose local time is on that day.
+\* ------------------------------------------------------------------------- */
+
+typedef struct LOCAL_DAY_S LOCAL_DAY;
+struct LOCAL_DAY_S
+{
+   int64_t days;      /* days since 1/1/1970 */
+   int64_t year;      /* year of the day */
+   int32_t mon;       /* month of the year 0 .. 11 */
+   int32_t mday;      /* day of the month 1 .. 31 */
+   int32_t yday;      /* day of the year 0 .. 365 */
+   int32_t wday;      /* day of the week 0 = Sunday .. 6 = Saturday */
+   int32_t leap_year; /* nonzero for leap years */
+   int32_t valid;     /* nonzero if the date was calculated */
+};
+
+
+/* ------------------------------------------------------------------------- *\
+   get_local_day returns the civil date of the days since 1/1/1970 from
+   pday if it was calculated already for it and calculates it otherwise.
+\* ------------------------------------------------------------------------- */
+
+static const LOCAL_DAY * get_local_day(LOCAL_DAY * pday, int64_t days)
+{
+   if(!pday->valid || (pday->days != days))
+   {
+      pday->days  = days;
+      pday->year  = civil_of_days(days, &pday->mon, &pday->mday, &pday->yday, &pday->leap_year);
+      pday->wday  = (int32_t) ((days + 4) % 7); /* 1/1/1970 was a Thursday */
+      pday->valid = 1;
+
+      if(pday->wday < 0)
+         pday->wday += 7;
+   }
+
+   return (pday);
+} /* static const LOCAL_DAY * get_local_day(LOCAL_DAY * pday, int64_t days) */
+
+
+/* ------------------------------------------------------------------------- *\
+   localtime_of_zones converts one time into the local times of many time
+   zones as localtime_of_zone does. The UTC date, the day of the week the
+   UTC year starts with and the leap year flag are calculated once for all
+   zones and so are the civil dates of the local days before, at and after
+   the UTC day.
+\* ------------------------------------------------------------------------- */
+
+size_t localtime_of_zones(time64_t t, const TIME_ZONE_INFO * const * pzones, size_t count, struct tm * ptm, int32_t * poffset, int32_t * pisdst, uint8_t * perr)
+{
+   LOCAL_DAY local_days[3]; /* the local days before, at and after the UTC day */
+   size_t    errors = 0;
+   size_t    i;
+   int64_t   days;
+   int32_t   mon;
+   int32_t   mday;
+   int32_t   yday;
+   int32_t   leap_year;
+   int32_t   time_of_day;
+   int32_t   time_of_year;
+   int32_t   rule_index;
+
+   if(!pzones)
+      return (count);
+
+   if(perr)
+      memset(perr, 0, (count + 7) / 8);
+
+   days = split_time(t, &time_of_day);
+   civil_of_days(days, &mon, &mday, &yday, &leap_year);
+   time_of_year = (yday * 86400) + time_of_day;
+   rule_index   = get_rule_index(days, yday, leap_year);
+
+   local_days[0].valid = 0;
+   local_days[1].valid = 0;
+   local_days[2].valid = 0;
+
+   for(i = 0; i < count; ++i)
+   {
+      const TIME_ZONE_INFO * ptzi  = pzones[i];
+      const TIME_ZONE_RULE * ptz   = NULL;
+      int32_t                isdst = 0;
+      int32_t                offset;
+
+      if(ptzi)
+         ptz = get_rule_of_year(ptzi, time_of_year, rule_index, &isdst);
+
+      offset = ptz ? -ptz->bias : 0;
+
+      if(poffset)
+         poffset[i] = offset;
+
+      if(pisdst)
+         pisdst[i] = isdst;
+
+      if(ptm)
+      {
+         struct tm *       pt          = &ptm[i];
+         int32_t           local_time  = time_of_day + offset;
+         int64_t           local_date  = days;
+         const LOCAL_DAY * pday;
+
+         /* the offsets of the time zone rules are less than 2 days */
+         while(local_time < 0)
+         {
+            local_time += 86400;
+            --local_date;
+         }
+
+         while(local_time >= 86400)
+         {
+            local_time -= 86400;
+            ++local_date;
+         }
+
+         if((local_date >= days - 1) && (local_date <= days + 1))
+            pday = get_local_day(&local_days[local_date - days + 1], local_date);
+         else
+            pday = get_local_day(&local_days[1], local_date);
+
+         memset(pt, 0, sizeof(*pt));
+
+         if(pday->year - 1900 != (int) (pday->year - 1900))
+         {
+            if(perr)
+               perr[i / 8] |= (uint8_t) (1 << (i % 8));
+
+            ++errors;
+            continue;
+         }
+
+         pt->tm_year  = (int) (pday->year - 1900);
+         pt->tm_mon   = pday->mon;
+         pt->tm_mday  = pday->mday;
+         pt->tm_yday  = pday->yday;
+         pt->tm_wday  = pday->wday;
+         pt->tm_hour  = local_time / 3600;
+         pt->tm_min   = local_time / 60 % 60;
+         pt->tm_sec   = local_time % 60;
+         pt->tm_isdst = isdst;
+
+#if defined __TM_ZONE || (defined (_POSIX_VERSION) && (_POSIX_VERSION  >= 202405))
+         pt->tm_gmtoff = offset;
+         pt->tm_zone   = ptz ? ptz->zone_name : "UTC";
+#endif
+      }
+   }
+
+   return (errors);
+} /* size_t localtime_of_zones(...) */
+
+
+/* ========================================================================= *\
+   Conversions of local times between time zones
+\* ========================================================================= */
+
+/* ------------------------------------------------------------------------- *\
+   CONVERTED_TIME is the result of a conversion of a local time into another
+   time zone.
+\* ------------------------------------------------------------------------- */
+
+typedef struct CONVERTED_TIME_S CONVERTED_TIME;
+struct CONVERTED_TIME_S
+{
+   LOCAL_DAY              day;         /* local date in the target zone */
+   int32_t                time_of_day; /* seconds of the local day */
+   int32_t                offset;      /* offset of the target zone to UTC in seconds */
+   int32_t                isdst;       /* daylight saving flag of the target zone */
+   const TIME_ZONE_RULE * ptz;         /* rule of the target zone or NULL for UTC */
+   time64_t               t;           /* UTC time */
+};
+
+
+/* ------------------------------------------------------------------------- *\
+   convert_local_time converts a valid local date and time of the zone
+   pfrom into the one of the zone pto. The source offset is resolved once
+   as add_time_of_zone does it and the target offset is determined from the
+   UTC year as localtime_of_zone does it. The civil dates are only
+   calculated again if the UTC or the target day differs from the source
+   day. It stores the kind of the source time in pkind. The function returns
+   0 if the policy rejected the source time.
+\* ------------------------------------------------------------------------- */
+
+static int convert_local_time(int64_t year, int32_t mon, int32_t mday, int32_t time_of_day, const TIME_ZONE_INFO * pfrom, int policy, const TIME_ZONE_INFO * pto, CONVERTED_TIME * pres, int * pkind)
+{
+   int32_t leap_year;
+   int32_t rule_index;
+   int64_t days = days_of_civil_date(year, mon, mday, &leap_year, &rule_index);
+   int32_t yday = (leap_year ? startday_of_month_array_ly[mon] : startday_of_month_array[mon]) + mday - 1;
+   int32_t utc_yday = yday;
+   int64_t utc_days;
+   int32_t utc_time;
+   int64_t local_days;
+   int32_t local_time;
+
+   if(!resolve_local_time((days * 86400) + time_of_day, (yday * 86400) + time_of_day, rule_index, policy, pfrom, &pres->t, pkind))
+      return (0);
+
+   utc_time = time_of_day + (int32_t) (pres->t - ((days * 86400) + time_of_day));
+   utc_days = days;
+
+   /* the offsets of the time zone rules are less than 2 days */
+   for(; utc_time < 0; utc_time += 86400)
+      --utc_days;
+
+   for(; utc_time >= 86400; utc_time -= 86400)
+      ++utc_days;
+
+   pres->day.valid = 0;
+
+   if(utc_days != days)
+   {
+      get_local_day(&pres->day, utc_days);
+      utc_yday   = pres->day.yday;
+      rule_index = get_rule_index(utc_days, utc_yday, pres->day.leap_year);
+   }
+
+   pres->ptz    = pto ? get_rule_of_year(pto, (utc_yday * 86400) + utc_time, rule_index, &pres->isdst) : NULL;
+   pres->offset = pres->ptz ? -pres->ptz->bias : 0;
+
+   if(!pto)
+      pres->isdst = 0;
+
+   local_time = utc_time + pres->offset;
+   local_days = utc_days;
+
+   for(; local_time < 0; local_time += 86400)
+      --local_days;
+
+   for(; local_time >= 86400; local_time -= 86400)
+      ++local_days;
+
+   if(local_days == days)
+   { /* the target day is the source day */
+      pres->day.days      = days;
+      pres->day.year      = year;
+      pres->day.mon       = mon;
+      pres->day.mday      = mday;
+      pres->day.yday      = yday;
+      pres->day.wday      = (int32_t) ((days + 4) % 7); /* 1/1/1970 was a Thursday */
+      pres->day.leap_year = leap_year;
+      pres->day.valid     = 1;
+
+      if(pres->day.wday < 0)
+         pres->day.wday += 7;
+   }
+   else
+   {
+      get_local_day(&pres->day, local_days);
+   }
+
+   pres->time_of_day = local_time;
+   return (1);
+} /* static int convert_local_time(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   valid_local_date checks the fields of a local date and time as
+   mktime_columns_of_zone does. Leap seconds aren't allowed because the
+   time of the day needs to be a valid one of the target zone as well.
+\* ------------------------------------------------------------------------- */
+
+static int valid_local_date(int64_t year, int32_t mon, int32_t mday, int32_t hour, int32_t min, int32_t sec)
+{
+   int32_t leap_year = ((year & 3) == 0) && ((year % 100 != 0) || (year % 400 == 0));
+
+   if(((uint32_t) sec > 59) || ((uint32_t) min > 59) || ((uint32_t) hour > 23) || ((uint32_t) mon > 11) || (mday < 1))
+      return (0);
+
+   return (mday <= (leap_year ? days_of_month_array_ly[mon] : days_of_month_array[mon]));
+} /* static int valid_local_date(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   convert_time_of_zone converts a local time of the zone pfrom into the
+   local time of the zone pto as localtime_of_zone does it for the result of
+   mktime_of_zone but without the full conversions.
+\* ------------------------------------------------------------------------- */
+
+int convert_time_of_zone(const struct tm * ptm, const TIME_ZONE_INFO * pfrom, int policy, struct tm * presult, const TIME_ZONE_INFO * pto, time64_t * pt)
+{
+   CONVERTED_TIME res;
+   int64_t        year;
+   int            kind = -1;
+
+   if(!ptm || !presult || (policy < TIME_LOCAL_COMPATIBLE) || (policy > TIME_LOCAL_REJECT))
+   {
+      SET_ERRNO(EINVAL);
+      goto Exit;
+   }
+
+   year = (int64_t) ptm->tm_year + 1900;
+
+   if(!valid_local_date(year, ptm->tm_mon, ptm->tm_mday, ptm->tm_hour, ptm->tm_min, ptm->tm_sec))
+   {
+      SET_ERRNO(EINVAL);
+      goto Exit;
+   }
+
+   if(!convert_local_time(year, ptm->tm_mon, ptm->tm_mday, (ptm->tm_hour * 3600) + (ptm->tm_min * 60) + ptm->tm_sec, pfrom, policy, pto, &res, &kind))
+   {
+      SET_ERRNO(ERANGE);
+      kind = -1;
+      goto Exit;
+   }
+
+   if(res.day.year - 1900 != (int) (res.day.year - 1900))
+   {
+#ifdef EOVERFLOW
+      SET_ERRNO(EOVERFLOW);
+#else
+      SET_ERRNO(ERANGE);
+#endif
+      kind = -1;
+      goto Exit;
+   }
+
+   memset(presult, 0, sizeof(*presult));
+   presult->tm_year  = (int) (res.day.year - 1900);
+   presult->tm_mon   = res.day.mon;
+   presult->tm_mday  = res.day.mday;
+   presult->tm_yday  = res.day.yday;
+   presult->tm_wday  = res.day.wday;
+   presult->tm_hour  = res.time_of_day / 3600;
+   presult->tm_min   = res.time_of_day / 60 % 60;
+   presult->tm_sec   = res.time_of_day % 60;
+   presult->tm_isdst = res.isdst;
+
+#if defined __TM_ZONE || (defined (_POSIX_VERSION) && (_POSIX_VERSION  >= 202405))
+   presult->tm_gmtoff = res.offset;
+   presult->tm_zone   = res.ptz ? res.ptz->zone_name : "UTC";
+#endif
+
+   if(pt)
+      *pt = res.t;
+
+   Exit:;
+   return (kind);
+} /* int convert_time_of_zone(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   convert_columns_of_zone converts the columns of local times of the zone
+   pfrom into the columns of the local times of the zone pto as
+   convert_time_of_zone does.
+\* ------------------------------------------------------------------------- */
+
+size_t convert_columns_of_zone(const TIME_COLUMNS * pcols, size_t count, const TIME_ZONE_INFO * pfrom, int policy, const TIME_COLUMNS * presult, const TIME_ZONE_INFO * pto, int8_t * pkind, uint8_t * perr)
+{
+   size_t  errors = 0;
+   size_t  i;
+   uint8_t bits   = 0;
+
+   if(!pcols || !presult || !pcols->year || !pcols->mon || !pcols->mday || (policy < TIME_LOCAL_COMPATIBLE) || (policy > TIME_LOCAL_REJECT))
+      return (count);
+
+   for(i = 0; i < count; ++i)
+   {
+      CONVERTED_TIME res;
+      int64_t        year  = (int64_t) pcols->year[i] + 1900;
+      int32_t        hour  = pcols->hour ? pcols->hour[i] : 0;
+      int32_t        min   = pcols->min  ? pcols->min[i]  : 0;
+      int32_t        sec   = pcols->sec  ? pcols->sec[i]  : 0;
+      int            kind  = -1;
+      int32_t        bad   = 1;
+
+      if(   valid_local_date(year, pcols->mon[i], pcols->mday[i], hour, min, sec)
+         && convert_local_time(year, pcols->mon[i], pcols->mday[i], (hour * 3600) + (min * 60) + sec, pfrom, policy, pto, &res, &kind))
+      {
+         year = res.day.year - 1900;
+         bad  = (year != (int32_t) year);
+
+         if(presult->year)   presult->year[i]   = (int32_t) year;
+         if(presult->mon)    presult->mon[i]    = (int8_t)  res.day.mon;
+         if(presult->mday)   presult->mday[i]   = (int8_t)  res.day.mday;
+         if(presult->hour)   presult->hour[i]   = (int8_t)  (res.time_of_day / 3600);
+         if(presult->min)    presult->min[i]    = (int8_t)  ((res.time_of_day / 60) % 60);
+         if(presult->sec)    presult->sec[i]    = (int8_t)  (res.time_of_day % 60);
+         if(presult->wday)   presult->wday[i]   = (int8_t)  res.day.wday;
+         if(presult->yday)   presult->yday[i]   = (int16_t) res.day.yday;
+         if(presult->isdst)  presult->isdst[i]  = (int8_t)  res.isdst;
+         if(presult->gmtoff) presult->gmtoff[i] = res.offset;
+      }
+
+      if(pkind)
+         pkind[i] = (int8_t) kind;
+
+      errors += bad;
+      bits   |= (uint8_t) (bad << (i & 7));
+
+      if(((i & 7) == 7) || (i + 1 == count))
+      {
+         if(perr)
+            perr[i >> 3] = bits;
+         bits = 0;
+      }
+   }
+
+   return (errors);
+} /* size_t convert_columns_of_zone(...) */
+
+
+/* ========================================================================= *\
+   Parallel batch conversions
+\* ========================================================================= */
+
+/* ------------------------------------------------------------------------- *\
+   The worker threads of a TIME_POOL are compiled in only if time_api.c is
+   compiled with TIME_API_ENABLE_THREADS defined. They are Windows threads
+   in Windows and POSIX threads otherwise. Without them a pool has no
+   workers and its batch functions convert in the calling thread.
+   The arrays are split into chunks of TIME_POOL_CHUNK elements. The
+   threads are taking the next chunk from a shared counter until all of
+   them are converted, so a thread that is done early steals the chunks of
+   slower ones. The chunk size is a multiple of 8 for keeping the bytes of
+   the error bits separate.
+\* ------------------------------------------------------------------------- */
+
+#define TIME_POOL_CHUNK   4096
+
+#ifdef TIME_API_ENABLE_THREADS
+
+#if defined (_WIN32)
+
+typedef CRITICAL_SECTION   TA_MUTEX;
+typedef CONDITION_VARIABLE TA_COND;
+typedef HANDLE             TA_THREAD;
+
+#define ta_mutex_init(pm)       InitializeCriticalSection(pm)
+#define ta_mutex_destroy(pm)    DeleteCriticalSection(pm)
+#define ta_mutex_lock(pm)       EnterCriticalSection(pm)
+#define ta_mutex_unlock(pm)     LeaveCriticalSection(pm)
+#define ta_cond_init(pc)        InitializeConditionVariable(pc)
+#define ta_cond_destroy(pc)     ((void) 0)
+#define ta_cond_wait(pc, pm)    SleepConditionVariableCS(pc, pm, INFINITE)
+#define ta_cond_broadcast(pc)   WakeAllConditionVariable(pc)
+#define ta_next_chunk(pl)       (InterlockedIncrement(pl) - 1)
+
+#else
+
+#include <pthread.h>
+
+typedef pthread_mutex_t TA_MUTEX;
+typedef pthread_cond_t  TA_COND;
+typedef pthread_t       TA_THREAD;
+
+#define ta_mutex_init(pm)       pthread_mutex_init(pm, NULL)
+#define ta_mutex_destroy(pm)    pthread_mutex_destroy(pm)
+#define ta_mutex_lock(pm)       pthread_mutex_lock(pm)
+#define ta_mutex_unlock(pm)     pthread_mutex_unlock(pm)
+#define ta_cond_init(pc)        pthread_cond_init(pc, NULL)
+#define ta_cond_destroy(pc)     pthread_cond_destroy(pc)
+#define ta_cond_wait(pc, pm)    pthread_cond_wait(pc, pm)
+#define ta_cond_broadcast(pc)   pthread_cond_broadcast(pc)
+#define ta_next_chunk(pl)       __sync_fetch_and_add(pl, 1)
+
+#endif /* _WIN32 */
+
+#endif /* TIME_API_ENABLE_THREADS */
+
+
+typedef struct TIME_POOL_JOB_S TIME_POOL_JOB;
+
+/* ------------------------------------------------------------------------- *\
+   TIME_POOL_RUN converts count elements of a job that start at the element
+   first and returns the number of the invalid ones.
+\* ------------------------------------------------------------------------- */
+typedef size_t (*TIME_POOL_RUN)(const TIME_POOL_JOB * pjob, size_t first, size_t count);
+
+struct TIME_POOL_JOB_S
+{
+   TIME_POOL_RUN          pfn_run;    /* conversion of a chunk */
+   size_t                 count;      /* number of all elements */
+   const void *           pin;        /* input array */
+   void *                 pout;       /* output array */
+   const TIME_COLUMNS *   pcols;      /* columns of the input or the output */
+   uint8_t *              perr;       /* error bits or NULL */
+   const TIME_ZONE_INFO * ptzi;       /* time zone of the conversion */
+   volatile long          next_chunk; /* index of the next chunk that isn't taken yet */
+   size_t                 errors;     /* invalid elements of the worker threads */
+};
+
+struct TIME_POOL_S
+{
+   int             threads;    /* number of the worker threads beside of the calling one */
+#ifdef TIME_API_ENABLE_THREADS
+   TA_MUTEX        mutex;      /* guards the following members */
+   TA_COND         wake;       /* signals a new job or the end of the pool to the workers */
+   TA_COND         done;       /* signals that the last worker finished its part of the job */
+   TIME_POOL_JOB * pjob;       /* current job or NULL */
+   unsigned        generation; /* number of the current job */
+   int             busy;       /* number of workers that are still converting the job */
+   int             stop;       /* the workers need to terminate */
+   TA_THREAD *     pthreads;   /* handles of the worker threads */
+#endif
+};
+
+
+/* ------------------------------------------------------------------------- *\
+   run_chunks converts chunks of a job until all of them are taken and
+   returns the number of the invalid elements of those chunks.
+\* ------------------------------------------------------------------------- */
+
+static size_t run_chunks(TIME_POOL_JOB * pjob)
+{
+   size_t errors = 0;
+
+   for(;;)
+   {
+#ifdef TIME_API_ENABLE_THREADS
+      size_t first = (size_t) ta_next_chunk(&pjob->next_chunk) * TIME_POOL_CHUNK;
+#else
+      size_t first = (size_t) pjob->next_chunk++ * TIME_POOL_CHUNK;
+#endif
+
+      if(first >= pjob->count)
+         break;
+
+      errors += pjob->pfn_run(pjob, first, (pjob->count - first < TIME_POOL_CHUNK) ? pjob->count - first : TIME_POOL_CHUNK);
+   }
+
+   return (errors);
+} /* static size_t run_chunks(TIME_POOL_JOB * pjob) */
+
+
+#ifdef TIME_API_ENABLE_THREADS
+
+/* ------------------------------------------------------------------------- *\
+   pool_worker is the loop of a worker thread. It waits for the next job,
+   converts chunks of it and reports the end of its work.
+\* ------------------------------------------------------------------------- */
+
+static void pool_worker(TIME_POOL * pool)
+{
+   unsigned generation = 0;
+
+   ta_mutex_lock(&pool->mutex);
+
+   for(;;)
+   {
+      TIME_POOL_JOB * pjob;
+      size_t          errors;
+
+      while(!pool->stop && (pool->generation == generation))
+         ta_cond_wait(&pool->wake, &pool->mutex);
+
+      if(pool->stop)
+         break;
+
+      generation = pool->generation;
+      pjob       = pool->pjob;
+      ta_mutex_unlock(&pool->mutex);
+
+      errors = run_chunks(pjob);
+
+      ta_mutex_lock(&pool->mutex);
+      pjob->errors += errors;
+
+      if(!--pool->busy)
+         ta_cond_broadcast(&pool->done);
+   }
+
+   ta_mutex_unlock(&pool->mutex);
+} /* static void pool_worker(TIME_POOL * pool) */
+
+
+#if defined (_WIN32)
+static DWORD WINAPI pool_thread(LPVOID pv)
+{
+   pool_worker((TIME_POOL *) pv);
+   return (0);
+} /* static DWORD WINAPI pool_thread(LPVOID pv) */
+#else
+static void * pool_thread(void * pv)
+{
+   pool_worker((TIME_POOL *) pv);
+   return (NULL);
+} /* static void * pool_thread(void * pv) */
+#endif
+
+#endif /* TIME_API_ENABLE_THREADS */
+
+
+/* ------------------------------------------------------------------------- *\
+   run_job converts all elements of a job by the calling thread and the
+   workers of the pool if there are any and the pool isn't busy with the
+   job of another thread. It returns the number of the invalid elements.
+\* ------------------------------------------------------------------------- */
+
+static size_t run_job(TIME_POOL * pool, TIME_POOL_JOB * pjob)
+{
+   size_t errors;
+
+   pjob->next_chunk = 0;
+   pjob->errors     = 0;
+
+#ifdef TIME_API_ENABLE_THREADS
+   if(pool && pool->threads && (pjob->count > TIME_POOL_CHUNK))
+   {
+      ta_mutex_lock(&pool->mutex);
+
+      if(!pool->pjob)
+      {
+         pool->pjob = pjob;
+         pool->busy = pool->threads;
+         ++pool->generation;
+         ta_cond_broadcast(&pool->wake);
+         ta_mutex_unlock(&pool->mutex);
+
+         errors = run_chunks(pjob);
+
+         ta_mutex_lock(&pool->mutex);
+
+         while(pool->busy)
+            ta_cond_wait(&pool->done, &pool->mutex);
+
+         pool->pjob = NULL;
+         ta_mutex_unlock(&pool->mutex);
+
+         return (errors + pjob->errors);
+      }
+
+      ta_mutex_unlock(&pool->mutex); /* the pool is busy, so the calling thread converts alone */
+   }
+#else
+   (void) pool;
+#endif
+
+   errors = run_chunks(pjob);
+   return (errors);
+} /* static size_t run_job(TIME_POOL * pool, TIME_POOL_JOB * pjob) */
+
+
+/* ------------------------------------------------------------------------- *\
+   create_time_pool creates a pool with threads threads including the
+   calling one. A value of 0 or less means the number of the processors.
+   It returns NULL if the memory of the pool can't be allocated.
+\* ------------------------------------------------------------------------- */
+
+TIME_POOL * create_time_pool(int threads)
+{
+   TIME_POOL * pool = (TIME_POOL *) calloc(1, sizeof(*pool));
+
+   if(!pool)
+   {
+      SET_ERRNO(ENOMEM);
+      goto Exit;
+   }
+
+#ifdef TIME_API_ENABLE_THREADS
+   if(threads <= 0)
+   {
+#if defined (_WIN32)
+      SYSTEM_INFO si;
+      GetSystemInfo(&si);
+      threads = (int) si.dwNumberOfProcessors;
+#else
+      threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+   }
+
+   if(threads > 1)
+      pool->pthreads = (TA_THREAD *) calloc((size_t) threads - 1, sizeof(TA_THREAD));
+
+   ta_mutex_init(&pool->mutex);
+   ta_cond_init(&pool->wake);
+   ta_cond_init(&pool->done);
+
+   if(pool->pthreads)
+   {
+      for(pool->threads = 0; pool->threads < threads - 1; ++pool->threads)
+      { /* a pool with less workers is still working if a thread can't be created */
+#if defined (_WIN32)
+         pool->pthreads[pool->threads] = CreateThread(NULL, 0, pool_thread, pool, 0, NULL);
+
+         if(!pool->pthreads[pool->threads])
+            break;
+#else
+         if(pthread_create(&pool->pthreads[pool->threads], NULL, pool_thread, pool))
+            break;
+#endif
+      }
+   }
+#else
+   (void) threads;
+#endif
+
+   Exit:;
+   return (pool);
+} /* TIME_POOL * create_time_pool(int threads) */
+
+
+/* ------------------------------------------------------------------------- *\
+   destroy_time_pool terminates the worker threads of a pool and releases
+   it.
+\* ------------------------------------------------------------------------- */
+
+void destroy_time_pool(TIME_POOL * pool)
+{
+   if(!pool)
+      return;
+
+#ifdef TIME_API_ENABLE_THREADS
+   {
+      int i;
+
+      ta_mutex_lock(&pool->mutex);
+      pool->stop = 1;
+      ta_cond_broadcast(&pool->wake);
+      ta_mutex_unlock(&pool->mutex);
+
+      for(i = 0; i < pool->threads; ++i)
+      {
+#if defined (_WIN32)
+         WaitForSingleObject(pool->pthreads[i], INFINITE);
+         CloseHandle(pool->pthreads[i]);
+#else
+         pthread_join(pool->pthreads[i], NULL);
+#endif
+      }
+
+      ta_cond_destroy(&pool->done);
+      ta_cond_destroy(&pool->wake);
+      ta_mutex_destroy(&pool->mutex);
+      free(pool->pthreads);
+   }
+#endif
+
+   free(pool);
+} /* void destroy_time_pool(TIME_POOL * pool) */
+
+
+/* ------------------------------------------------------------------------- *\
+   get_time_pool_threads returns the number of threads of a pool including
+   the calling one.
+\* ------------------------------------------------------------------------- */
+
+int get_time_pool_threads(const TIME_POOL * pool)
+{
+   return (pool ? pool->threads + 1 : 1);
+} /* int get_time_pool_threads(const TIME_POOL * pool) */
+
+
+/* ------------------------------------------------------------------------- *\
+   get_chunk_columns stores the columns of pcols that start at the element
+   first in pchunk.
+\* ------------------------------------------------------------------------- */
+
+static const TIME_COLUMNS * get_chunk_columns(TIME_COLUMNS * pchunk, const TIME_COLUMNS * pcols, size_t first)
+{
+   pchunk->year   = pcols->year   ? pcols->year   + first : NULL;
+   pchunk->mon    = pcols->mon    ? pcols->mon    + first : NULL;
+   pchunk->mday   = pcols->mday   ? pcols->mday   + first : NULL;
+   pchunk->hour   = pcols->hour   ? pcols->hour   + first : NULL;
+   pchunk->min    = pcols->min    ? pcols->min    + first : NULL;
+   pchunk->sec    = pcols->sec    ? pcols->sec    + first : NULL;
+   pchunk->wday   = pcols->wday   ? pcols->wday   + first : NULL;
+   pchunk->yday   = pcols->yday   ? pcols->yday   + first : NULL;
+   pchunk->isdst  = pcols->isdst  ? pcols->isdst  + first : NULL;
+   pchunk->gmtoff = pcols->gmtoff ? pcols->gmtoff + first : NULL;
+
+   return (pchunk);
+} /* static const TIME_COLUMNS * get_chunk_columns(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   The conversions of the chunks of the batch functions.
+\* ------------------------------------------------------------------------- */
+
+static size_t run_timegm_chunk(const TIME_POOL_JOB * pjob, size_t first, size_t count)
+{
+   return (new_timegm_array((const struct tm *) pjob->pin + first, (time64_t *) pjob->pout + first,
+                            pjob->perr ? pjob->perr + (first / 8) : NULL, count));
+} /* static size_t run_timegm_chunk(...) */
+
+
+static size_t run_mktime_chunk(const TIME_POOL_JOB * pjob, size_t first, size_t count)
+{
+   return (mktime_of_zone_array((const struct tm *) pjob->pin + first, (time64_t *) pjob->pout + first,
+                                pjob->perr ? pjob->perr + (first / 8) : NULL, count, pjob->ptzi));
+} /* static size_t run_mktime_chunk(...) */
+
+
+static size_t run_localtime_columns_chunk(const TIME_POOL_JOB * pjob, size_t first, size_t count)
+{
+   TIME_COLUMNS cols;
+
+   return (localtime_columns_of_zone((const time64_t *) pjob->pin + first, count, get_chunk_columns(&cols, pjob->pcols, first),
+                                     pjob->perr ? pjob->perr + (first / 8) : NULL, pjob->ptzi));
+} /* static size_t run_localtime_columns_chunk(...) */
+
+
+static size_t run_mktime_columns_chunk(const TIME_POOL_JOB * pjob, size_t first, size_t count)
+{
+   TIME_COLUMNS cols;
+
+   return (mktime_columns_of_zone(get_chunk_columns(&cols, pjob->pcols, first), count, (time64_t *) pjob->pout + first,
+                                  pjob->perr ? pjob->perr + (first / 8) : NULL, pjob->ptzi));
+} /* static size_t run_mktime_columns_chunk(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   The batch functions of a pool convert as the functions without the _mt
+   suffix but split the arrays over the threads of the pool.
+\* ------------------------------------------------------------------------- */
+
+size_t new_timegm_array_mt(TIME_POOL * pool, const struct tm * ptm, time64_t * pt, uint8_t * perr, size_t count)
+{
+   TIME_POOL_JOB job;
+
+   if(!pool || !ptm || !pt)
+      return (new_timegm_array(ptm, pt, perr, count));
+
+   memset(&job, 0, sizeof(job));
+   job.pfn_run = run_timegm_chunk;
+   job.count   = count;
+   job.pin     = ptm;
+   job.pout    = pt;
+   job.perr    = perr;
+
+   return (run_job(pool, &job));
+} /* size_t new_timegm_array_mt(...) */
+
+
+size_t mktime_of_zone_array_mt(TIME_POOL * pool, const struct tm * ptm, time64_t * pt, uint8_t * perr, size_t count, const TIME_ZONE_INFO * ptzi)
+{
+   TIME_POOL_JOB job;
+
+   if(!pool || !ptm || !pt || !ptzi)
+      return (mktime_of_zone_array(ptm, pt, perr, count, ptzi));
+
+   memset(&job, 0, sizeof(job));
+   job.pfn_run = run_mktime_chunk;
+   job.count   = count;
+   job.pin     = ptm;
+   job.pout    = pt;
+   job.perr    = perr;
+   job.ptzi    = ptzi;
+
+   return (run_job(pool, &job));
+} /* size_t mktime_of_zone_array_mt(...) */
+
+
+size_t localtime_columns_of_zone_mt(TIME_POOL * pool, const time64_t * pt, size_t count, const TIME_COLUMNS * pcols, uint8_t * perr, const TIME_ZONE_INFO * ptzi)
+{
+   TIME_POOL_JOB job;
+
+   if(!pool || !pt || !pcols)
+      return (localtime_columns_of_zone(pt, count, pcols, perr, ptzi));
+
+   memset(&job, 0, sizeof(job));
+   job.pfn_run = run_localtime_columns_chunk;
+   job.count   = count;
+   job.pin     = pt;
+   job.pcols   = pcols;
+   job.perr    = perr;
+   job.ptzi    = ptzi;
+
+   return (run_job(pool, &job));
+} /* size_t localtime_columns_of_zone_mt(...) */
+
+
+size_t mktime_columns_of_zone_mt(TIME_POOL * pool, const TIME_COLUMNS * pcols, size_t count, time64_t * pt, uint8_t * perr, const TIME_ZONE_INFO * ptzi)
+{
+   TIME_POOL_JOB job;
+
+   if(!pool || !pcols || !pt || !pcols->year || !pcols->mon || !pcols->mday)
+      return (mktime_columns_of_zone(pcols, count, pt, perr, ptzi));
+
+   memset(&job, 0, sizeof(job));
+   job.pfn_run = run_mktime_columns_chunk;
+   job.count   = count;
+   job.pcols   = pcols;
+   job.pout    = pt;
+   job.perr    = perr;
+   job.ptzi    = ptzi;
+
+   return (run_job(pool, &job));
+} /* size_t mktime_columns_of_zone_mt(...) */
+
+
+/* ========================================================================= *\
+   Conversions of times in mixed time zones
+\* ========================================================================= */
+
+/* ------------------------------------------------------------------------- *\
+   ZONE_GROUP_BLOCK is the number of elements that are grouped by their
+   zones at once. The grouping of a block is a counting sort by the zone
+   ids in the order of their first occurrence, so its costs don't depend on
+   the number of the zones. The block size is a multiple of 8 for the error
+   bits and small enough for 16 bit indices.
+\* ------------------------------------------------------------------------- */
+
+#define ZONE_GROUP_BLOCK   4096
+
+
+/* ------------------------------------------------------------------------- *\
+   localtime_columns_of_zone_ids converts an array of times into the
+   columns of local broken-down times in the zones of their ids. The
+   elements of a block are converted grouped by their zones, so the rules
+   of a zone are in the cache for all of its elements. The elements are
+   converted in their order if the counters of the zones can't be
+   allocated.
+\* ------------------------------------------------------------------------- */
+
+size_t localtime_columns_of_zone_ids(const time64_t * pt, const uint16_t * pzone_ids, size_t count, const TIME_ZONE_INFO * pzones, size_t zone_count,
+                                     const TIME_COLUMNS * pcols, uint8_t * perr)
+{
+   uint16_t   order[ZONE_GROUP_BLOCK]; /* indices of the elements of a block grouped by the zones */
+   uint16_t   ids[ZONE_GROUP_BLOCK];   /* zone ids of a block in the order of their first occurrence */
+   uint16_t * pcounts;                 /* elements of each zone in the block and their positions afterwards */
+   size_t     errors = 0;
+   size_t     block;
+
+   if(!pt || !pzone_ids || !pzones || !pcols)
+      return (count);
+
+   pcounts = (uint16_t *) calloc(zone_count ? zone_count : 1, sizeof(uint16_t));
+
+   if(perr)
+      memset(perr, 0, (count + 7) / 8);
+
+   for(block = 0; block < count; block += ZONE_GROUP_BLOCK)
+   {
+      size_t size  = (count - block < ZONE_GROUP_BLOCK) ? count - block : ZONE_GROUP_BLOCK;
+      size_t zones = 0;
+      size_t pos   = 0;
+      size_t i;
+      size_t j;
+
+      if(!pcounts)
+      { /* ungrouped conversion */
+         for(i = block; i < block + size; ++i)
+         {
+            int32_t bad = (pzone_ids[i] >= zone_count) || set_local_columns(pcols, i, pt[i], &pzones[pzone_ids[i]]);
+
+            if(bad && perr)
+               perr[i >> 3] |= (uint8_t) (1 << (i & 7));
+
+            errors += bad;
+         }
+
+         continue;
+      }
+
+      /* count the elements of each zone */
+      for(i = 0; i < size; ++i)
+      {
+         uint16_t id = pzone_ids[block + i];
+
+         if(id >= zone_count)
+         {
+            if(perr)
+               perr[(block + i) >> 3] |= (uint8_t) (1 << ((block + i) & 7));
+
+            ++errors;
+            continue;
+         }
+
+         if(!pcounts[id]++)
+            ids[zones++] = id;
+      }
+
+      /* the counters become the positions of the groups */
+      for(j = 0; j < zones; ++j)
+      {
+         size_t n = pcounts[ids[j]];
+
+         pcounts[ids[j]] = (uint16_t) pos;
+         pos += n;
+      }
+
+      for(i = 0; i < size; ++i)
+      {
+         uint16_t id = pzone_ids[block + i];
+
+         if(id < zone_count)
+            order[pcounts[id]++] = (uint16_t) i;
+      }
+
+      /* convert the groups, the counters are reset for the next block */
+      for(i = 0, j = 0; j < zones; ++j)
+      {
+         const TIME_ZONE_INFO * ptzi = &pzones[ids[j]];
+
+         for(; i < pcounts[ids[j]]; ++i)
+         {
+            size_t k = block + order[i];
+
+            if(set_local_columns(pcols, k, pt[k], ptzi))
+            {
+               if(perr)
+                  perr[k >> 3] |= (uint8_t) (1 << (k & 7));
+
+               ++errors;
+            }
+         }
+
+         pcounts[ids[j]] = 0;
+      }
+   }
+
+   free(pcounts);
+   return (errors);
+} /* size_t localtime_columns_of_zone_ids(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   new_mktime is a mktime implementation that does not adjust any members of
+   the input struct as mktime does.
+\* ------------------------------------------------------------------------- */
+time64_t new_mktime(const struct tm * ptm)
+{
+   time64_t t_ret;
+
+   TA_STAT_INC(calls_new_mktime);
+   lock_time_api();
+   check_time_zone_info();
+
+   t_ret = mktime_of_zone(ptm, &ti);
+
+   unlock_time_api();
+
+   return(t_ret);
+} /* time64_t new_mktime(struct tm * ptm) */
+
+
+/* ------------------------------------------------------------------------- *\
+   std_mktime is a mktime implementation that adjust the members of the
+   input struct as the C standard requires.
+\* ------------------------------------------------------------------------- */
+time64_t std_mktime(struct tm * ptm)
+{
+   time64_t t_ret;
+
+   TA_STAT_INC(calls_std_mktime);
+   lock_time_api();
+   check_time_zone_info();
+
+   t_ret = mktime_of_zone(ptm, &ti);
+
+   if(t_ret != (time64_t) -1)
+   {
+      localtime_of_zone(t_ret, ptm, &ti);
+   }
+   else
+   { /* We must not call localtime_of_zoner after a conversion error and
+        preserve errno if there was no conversion error. */
+
+      int err = errno;
+      errno = 0;
+
+      t_ret = mktime_of_zone(ptm, &ti);
+
+      if(!errno)
+         localtime_of_zone(t_ret, ptm, &ti);
+      else
+         errno = err;
+   }
+
+   unlock_time_api();
+
+   return(t_ret);
+} /* time64_t std_mktime(struct tm * ptm) */
+
+
+/* ------------------------------------------------------------------------- *\
+   localtime_of_zone is just multithreading safe version of localtime
+   according to the time zone and daylight saving rules that are given
+   in a struct TIME_ZONE_INFO
+
+   Note: new_localtime_r returns the atronomical date that has a year 0.
+         If you need the historical date you can do this as following
+   ...
+   new_localtime_r(&t, ptm);
+   if(ptm->year <= -1900)
+      --ptm->year;
+   printf ( "The historical year was %s%i%s", ptm->year > -1900 ? "AD" : "",
+            ptm->year + 1900, ptm->year < -1900 ? " BC" : "");
+   ...
+
+   In Posix 2024 systems ptm->tm_zone points to storage in the TIME_ZONE_INFO
+   struct. It becomes invalid once the storage of ptzi is released or adjusted.
+\* ------------------------------------------------------------------------- */
+struct tm * localtime_of_zone(time64_t utc_time, struct tm * ptm, const TIME_ZONE_INFO * ptzi)
+{
+   const   TIME_ZONE_RULE * ptz;
+   int32_t isDaylightSaving = 0;
+
+   TA_STAT_INC(calls_localtime_of_zone);
+
+   if (ptzi->type > 1)
+   {
+      int32_t  daylight_start; /* begin of day light saving in seconds after begin of the year */
+      int32_t  standard_start; /* begin of standard time in seconds after begin of the year */
+      int32_t  time_of_day;
+      uint32_t day;
+      int32_t  time_of_year;
+      int32_t  wday_year_start;
+      int32_t  leap_year = 1;
+
+      int64_t  time = utc_time + ((int64_t) 719528 * 86400); /* add the time from 1/1/0000 to 1/1/1970 */
+      int64_t  year;
+
+      if (time < 0)
+         year = time / ((int64_t) 146097 * 86400) - 1; /* calculate the 400 year epoche before that time */
+      else
+         year = time / ((int64_t) 146097 * 86400); /* calculate the 400 year epoche before that time */
+
+      time -= year * ((int64_t) 146097 * 86400); /* time is between 0 an 400 AD now */
+      day  = (uint32_t) (time / 86400); /* number of days within the 400 year epoch */
+      time_of_day = (int32_t) (time - ((int64_t) day * 86400));
+
+      if (day >= 36525)
+      {  /* the time is more than 100 years after a full 400 year epoch */
+         day -= 36525;
+
+         if (day >= 36524)
+         {
+            day -= 36524;
+
+            if (day >= 36524)
+               day -= 36524;
+         }
+
+         /* handle the first non leap years at begin of the century and ensure all remaining 4 year epochs start with a leap year */
+         if (day >= 1460)
+         {
+            day -= 1460;
+         }
+         else
+         {
+            leap_year = 0; /* we have to ignore the leap year within the first four years of a century */
 
             while (day >= 365)
                day -= 365;
          }
       }
 
-      day %= 1461; /* days within 4 year epochs that start with a leap year */
+      day %= 1461; /* days within 4 year epochs that start with a leap year */
+
+      if (day >= 1096)
+      { /* last year of the remaining 4 year block */
+         day -= 1096;
+         leap_year = 0;
+      }
+      else if (day >= 731)
+      { /* 3rd year of the 4 year block */
+         day -= 731;
+         leap_year = 0;
+      }
+      else if (day >= 366)
+      { /* 2nd year of the 4 year block */
+         day -= 366;
+         leap_year = 0;
+      }
+
+      time_of_year = ((int32_t) day * 86400) /* time between the begin of the day and the begin of the year */
+                     + time_of_day;          /* time since begin of the day */
+
+      /* The day of week calculation works well for years before 0 as well because every 400 year epoch starts with the same day of week */
+      wday_year_start = (int32_t)((((time - time_of_year) / 86400) + 6 /* 6 is offset at 1/1/0000 */) % 7); /* day of the week the year starts with 0=Sunday 1= Monday ... */
+      daylight_start  = ptzi->daylight.start[wday_year_start + (leap_year * 7)] + ptzi->standard.bias; /* time offset of begin of the daylight saving within the year in seconds */
+      standard_start  = ptzi->standard.start[wday_year_start + (leap_year * 7)] + ptzi->daylight.bias; /* time offset of returning to the standard time in the year in seconds */
+
+      if (daylight_start > standard_start)
+      {  /* southern hemisphere */
+         if((time_of_year >= standard_start) && (time_of_year < daylight_start))
+         {
+            ptz = &ptzi->standard;
+         }
+         else
+         {
+            ptz = &ptzi->daylight;
+            isDaylightSaving = 1;
+         }
+      }
+      else
+      {  /* northern hemisphere */
+         if((time_of_year >= daylight_start) && (time_of_year < standard_start))
+         {
+            ptz = &ptzi->daylight;
+            isDaylightSaving = 1;
+         }
+         else
+         {
+            ptz = &ptzi->standard;
+         }
+      }
+   }
+   else
+   {
+      ptz = &ptzi->standard;
+   }
+
+   if(ptm)
+   {
+      struct tm * ptm_ret = new_gmtime_r(utc_time - ptz->bias, ptm);
+      ptm->tm_isdst = isDaylightSaving; /* set summer time flag */
+
+#if defined __TM_ZONE || (defined (_POSIX_VERSION) && (_POSIX_VERSION  >= 202405))
+      ptm->tm_gmtoff = -ptz->bias;
+      ptm->tm_zone   = ptz->zone_name;
+#endif
+
+      ptm = ptm_ret;
+   }
+
+   return (ptm);
+}/* struct tm * localtime_of_zone(time64_t t, struct tm * ptm, const TIME_ZONE_INFO * ptzi) */
+
+
+/* ------------------------------------------------------------------------- *\
+   new_localtime_r an own implementation of localtime_r
+
+   Note: new_localtime_r returns the atronomical date that has a year 0.
+         If you need the historical date you can do this as following
+   ...
+   new_localtime_r(&t, ptm);
+   if(ptm->year <= -1900)
+      --ptm->year;
+   printf ( "The historical year was %s%i%s", ptm->year > -1900 ? "AD" : "",
+            ptm->year + 1900, ptm->year < -1900 ? " BC" : "");
+   ...
+
+   In Posix 2024 systems ptm->tm_zone points to storage in a static
+   TIME_ZONE_INFO struct. It may change once TZ becomes adjusted after the
+   call of new_localtime_r.
+\* ------------------------------------------------------------------------- */
+struct tm * new_localtime_r(time64_t t, struct tm * ptm)
+{
+   struct tm * ptm_ret;
+
+   TA_STAT_INC(calls_new_localtime_r);
+   lock_time_api();
+   check_time_zone_info();
+
+   ptm_ret = localtime_of_zone(t, ptm, &ti);
+
+   unlock_time_api();
+
+   return (ptm_ret);
+} /* struct tm * new_localtime_r(time64_t t, struct tm * ptm) */
+
+
+/* ------------------------------------------------------------------------- *\
+   get_local_zone_info stores the local time zone information of the system
+   in a user provided struct TIME_ZONE_INFO. It returns nonzero in success
+   case.
+\* ------------------------------------------------------------------------- */
+int get_local_zone_info(TIME_ZONE_INFO * ptzi)
+{
+   int iret = 0;
+
+   TA_STAT_INC(calls_get_local_zone_info);
+
+   if(!ptzi)
+       goto Exit;
+
+   lock_time_api();
+   check_time_zone_info();
+
+   *ptzi = ti;
+
+   unlock_time_api();
+
+   iret = 1;
+   Exit:;
+
+   return (iret);
+} /* int get_local_zone_info(TIME_ZONE_INFO * ptzi) */
+
+
+/* ========================================================================= *\
+   Parsing of times
+\* ========================================================================= */
+
+/* ------------------------------------------------------------------------- *\
+   get_digits returns the value of count decimal digits at p or -1 if any
+   of them isn't a digit.
+\* ------------------------------------------------------------------------- */
+
+static int32_t get_digits(const char * p, int count)
+{
+   int32_t value = 0;
+
+   for(; count > 0; --count, ++p)
+   {
+      if((uint32_t) (*p - '0') > 9)
+         return (-1);
+
+      value = (value * 10) + (*p - '0');
+   }
+
+   return (value);
+} /* static int32_t get_digits(const char * p, int count) */
+
+
+/* ------------------------------------------------------------------------- *\
+   ISO_TIME contains the fields of a parsed ISO time.
+\* ------------------------------------------------------------------------- */
+
+typedef struct ISO_TIME_S ISO_TIME;
+struct ISO_TIME_S
+{
+   int64_t local;        /* local seconds since 1/1/1970 */
+   int32_t time_of_year; /* local seconds since the begin of the year */
+   int32_t rule_index;   /* index of the start times of the daylight saving rules of the year */
+   int32_t nsec;         /* nanoseconds of the fraction */
+   int32_t offset;       /* offset to UTC in seconds east of UTC */
+   int32_t offset_type;  /* ISO_NO_OFFSET, ISO_OFFSET_Z or ISO_OFFSET */
+};
+
+#define ISO_NO_OFFSET  0 /* a local time without an offset */
+#define ISO_OFFSET_Z   1 /* a UTC time with a "Z" */
+#define ISO_OFFSET     2 /* a time with a numeric offset */
+
+
+/* ------------------------------------------------------------------------- *\
+   parse_iso_time parses the fields of an RFC 3339 or ISO 8601 time with an
+   optional fraction and offset at the begin of str and returns the count
+   of the parsed characters or 0 if it is invalid. errno is not changed.
+\* ------------------------------------------------------------------------- */
+
+static size_t parse_iso_time(const char * str, size_t len, ISO_TIME * pit)
+{
+   const char * p    = str;
+   const char * pend = str + len;
+   int32_t      year;
+   int32_t      mon;
+   int32_t      mday;
+   int32_t      hour;
+   int32_t      min;
+   int32_t      sec;
+   int32_t      leap_year;
+   int64_t      days;
+
+   if(len < 19)
+      return (0);
+
+   /* YYYY-MM-DDThh:mm:ss */
+   year = get_digits(p, 4);
+   mon  = get_digits(p + 5, 2) - 1;
+   mday = get_digits(p + 8, 2);
+   hour = get_digits(p + 11, 2);
+   min  = get_digits(p + 14, 2);
+   sec  = get_digits(p + 17, 2);
+
+   if(   (year < 0) || (mon < 0) || (mday < 0) || (hour < 0) || (min < 0) || (sec < 0)
+      || (p[4] != '-') || (p[7] != '-') || (p[13] != ':') || (p[16] != ':')
+      || ((p[10] != 'T') && (p[10] != 't') && (p[10] != ' '))
+      || !valid_local_date(year, mon, mday, hour, min, (sec == 60) ? 59 : sec)) /* a leap second is the first second of the next minute */
+      return (0);
+
+   p += 19;
+   pit->nsec = 0;
+
+   if((p < pend) && ((*p == '.') || (*p == ',')))
+   { /* the fraction, digits after the nanoseconds are truncated */
+      int32_t digits = 0;
+
+      for(++p; (p < pend) && ((uint32_t) (*p - '0') <= 9); ++p, ++digits)
+      {
+         if(digits < 9)
+            pit->nsec = (pit->nsec * 10) + (*p - '0');
+      }
+
+      if(!digits)
+         return (0);
+
+      for(; digits < 9; ++digits)
+         pit->nsec *= 10;
+   }
+
+   days              = days_of_civil_date(year, mon, mday, &leap_year, &pit->rule_index);
+   pit->local        = (days * 86400) + (hour * 3600) + (min * 60) + sec;
+   pit->time_of_year = ((leap_year ? startday_of_month_array_ly[mon] : startday_of_month_array[mon]) + mday - 1) * 86400
+                     + (hour * 3600) + (min * 60) + sec;
+   pit->offset       = 0;
+   pit->offset_type  = ISO_NO_OFFSET;
+
+   if((p < pend) && ((*p == 'Z') || (*p == 'z')))
+   {
+      pit->offset_type = ISO_OFFSET_Z;
+      ++p;
+   }
+   else if((p + 3 <= pend) && ((*p == '+') || (*p == '-')))
+   { /* +hh, +hhmm or +hh:mm */
+      int32_t offset_hour = get_digits(p + 1, 2);
+      int32_t offset_min  = 0;
+      int32_t sign        = (*p == '-') ? -1 : 1;
+
+      p += 3;
+
+      if((p + 3 <= pend) && (*p == ':'))
+      {
+         offset_min = get_digits(p + 1, 2);
+         p += 3;
+      }
+      else if((p + 2 <= pend) && ((uint32_t) (*p - '0') <= 9))
+      {
+         offset_min = get_digits(p, 2);
+         p += 2;
+      }
+
+      if((offset_hour < 0) || (offset_hour > 23) || (offset_min < 0) || (offset_min > 59))
+         return (0);
+
+      pit->offset      = sign * ((offset_hour * 3600) + (offset_min * 60));
+      pit->offset_type = ISO_OFFSET;
+   }
+
+   return ((size_t) (p - str));
+} /* static size_t parse_iso_time(const char * str, size_t len, ISO_TIME * pit) */
+
+
+/* ------------------------------------------------------------------------- *\
+   join_iso_time stores the nanosecond time of a parsed ISO time in pns. A
+   time without an offset is a local time of the zone of ptzi. It returns
+   nonzero in success case and sets errno to EOVERFLOW otherwise.
+\* ------------------------------------------------------------------------- */
+
+static int join_iso_time(const ISO_TIME * pit, int64_t * pns, const TIME_ZONE_INFO * ptzi)
+{
+   int64_t  ns;
+   time64_t t   = pit->local - pit->offset;
+   int      err = errno;
+
+   if(pit->offset_type == ISO_NO_OFFSET)
+      resolve_local_time(pit->local, pit->time_of_year, pit->rule_index, TIME_LOCAL_COMPATIBLE, ptzi, &t, NULL);
+
+   errno = 0;
+   ns    = join_time_ns(t, pit->nsec);
+
+   if((ns == -1) && errno)
+      return (0); /* out of the range of a nanosecond time */
+
+   errno = err;
+   *pns  = ns;
+   return (1);
+} /* static int join_iso_time(const ISO_TIME * pit, int64_t * pns, const TIME_ZONE_INFO * ptzi) */
+
+
+/* ------------------------------------------------------------------------- *\
+   parse_time_of_zone_ns parses an RFC 3339 or ISO 8601 time with an
+   optional fraction and offset at the begin of str and returns the count
+   of the parsed characters or 0 in error case. A time without an offset is
+   a local time of the zone of ptzi that is resolved as mktime does it.
+\* ------------------------------------------------------------------------- */
+
+size_t parse_time_of_zone_ns(const char * str, size_t len, int64_t * pns, const TIME_ZONE_INFO * ptzi)
+{
+   ISO_TIME it;
+   size_t   used = 0;
+
+   if(!str || !pns || !(used = parse_iso_time(str, len, &it)))
+   {
+      SET_ERRNO(EINVAL);
+      return (0);
+   }
+
+   if(!join_iso_time(&it, pns, ptzi))
+      return (0);
+
+   return (used);
+} /* size_t parse_time_of_zone_ns(...) */
+
+
+/* ========================================================================= *\
+   Parsing of fixed layouts
+\* ========================================================================= */
+
+/* ------------------------------------------------------------------------- *\
+   TIME_LAYOUT is the compiled layout of parse_times_of_layout. The masks
+   of the vectors contain 0xFF for the digits and for the separators. The
+   first vector covers the characters 0 until 15 and the second one the
+   last 16 characters of the layout. Layouts that are shorter than 16
+   characters are checked by the second vector only, which starts in front
+   of the string then. The positions of missing fields are -1.
+\* ------------------------------------------------------------------------- */
+
+typedef struct TIME_LAYOUT_S TIME_LAYOUT;
+struct TIME_LAYOUT_S
+{
+   uint8_t digit_mask[2][16];   /* digits of the first and of the second vector */
+   uint8_t literal_mask[2][16]; /* separators of the first and of the second vector */
+   char    literal[2][16];      /* expected separators */
+   char    text[TIME_LAYOUT_MAX]; /* the layout */
+   int32_t len;                 /* length of the layout */
+   int32_t year;                /* positions of the fields */
+   int32_t mon;
+   int32_t mday;
+   int32_t hour;
+   int32_t min;
+   int32_t sec;
+   int32_t frac;
+   int32_t frac_digits;         /* number of the fractional digits */
+};
+
+
+/* ------------------------------------------------------------------------- *\
+   compile_layout compiles a layout of parse_times_of_layout and returns
+   nonzero if it is valid.
+\* ------------------------------------------------------------------------- */
+
+static int compile_layout(const char * layout, TIME_LAYOUT * pl)
+{
+   int32_t * pfield;
+   int32_t   digits;
+   int32_t   i;
+   int32_t   v;
+
+   memset(pl, 0, sizeof(*pl));
+   pl->year = pl->mon = pl->mday = pl->hour = pl->min = pl->sec = pl->frac = -1;
+
+   for(i = 0; layout[i]; i += digits)
+   {
+      char c = layout[i];
+
+      if(i + 1 > TIME_LAYOUT_MAX)
+         return (0);
+
+      pl->text[i] = c;
+
+      for(digits = 1; (layout[i + digits] == c) && (digits < 10); ++digits)
+         ;
+
+      switch(c)
+      {
+         case 'Y': pfield = &pl->year; v = (digits == 4); break;
+         case 'M': pfield = &pl->mon;  v = (digits == 2); break;
+         case 'D': pfield = &pl->mday; v = (digits == 2); break;
+         case 'h': pfield = &pl->hour; v = (digits == 2); break;
+         case 'm': pfield = &pl->min;  v = (digits == 2); break;
+         case 's': pfield = &pl->sec;  v = (digits == 2); break;
+         case 'f': pfield = &pl->frac; v = (digits <= 9); pl->frac_digits = digits; break;
+         default:  pfield = NULL;      v = 1; digits = 1; break;
+      }
+
+      if(!v || (i + digits > TIME_LAYOUT_MAX) || (pfield && (*pfield >= 0)))
+         return (0);
+
+      if(pfield)
+      {
+         *pfield = i;
+         memset(pl->text + i, 'f', (size_t) digits); /* any letter stands for a digit */
+      }
+   }
+
+   pl->len = i;
+
+   if((pl->year < 0) || (pl->mon < 0) || (pl->mday < 0))
+      return (0);
+
+   /* the masks of the vectors at 0 and at len - 16 */
+   for(v = 0; v < 2; ++v)
+   {
+      int32_t start = v ? (pl->len - 16) : 0;
+
+      for(i = 0; i < 16; ++i)
+      {
+         int32_t pos = start + i;
+
+         if((pos < 0) || (pos >= pl->len) || (!v && (pl->len < 16)))
+            continue;
+
+         if(pl->text[pos] == 'f')
+            pl->digit_mask[v][i] = 0xFF;
+         else
+         {
+            pl->literal_mask[v][i] = 0xFF;
+            pl->literal[v][i]      = pl->text[pos];
+         }
+      }
+   }
+
+   return (1);
+} /* static int compile_layout(const char * layout, TIME_LAYOUT * pl) */
+
+
+/* ------------------------------------------------------------------------- *\
+   valid_layout_chars checks the digits and separators of the string p
+   character by character.
+\* ------------------------------------------------------------------------- */
+
+static int valid_layout_chars(const TIME_LAYOUT * pl, const char * p)
+{
+   int32_t i;
+   int32_t bad = 0;
+
+   for(i = 0; i < pl->len; ++i)
+   {
+      if(pl->text[i] == 'f')
+         bad |= ((uint32_t) (p[i] - '0') > 9);
+      else
+         bad |= (p[i] != pl->text[i]);
+   }
+
+   return (!bad);
+} /* static int valid_layout_chars(const TIME_LAYOUT * pl, const char * p) */
+
+
+#ifdef TIME_API_SSE2
+/* ------------------------------------------------------------------------- *\
+   invalid_layout_vector returns the nonzero bit mask of the invalid
+   characters of a vector of 16 characters.
+\* ------------------------------------------------------------------------- */
+
+static int invalid_layout_vector(__m128i v, const TIME_LAYOUT * pl, int index)
+{
+   const __m128i nine  = _mm_set1_epi8(9);
+   __m128i       d     = _mm_sub_epi8(v, _mm_set1_epi8('0'));
+   __m128i       digit = _mm_cmpeq_epi8(_mm_max_epu8(d, nine), nine);
+   __m128i       sep   = _mm_cmpeq_epi8(v, _mm_loadu_si128((const __m128i *) pl->literal[index]));
+   __m128i       bad   = _mm_or_si128(_mm_andnot_si128(digit, _mm_loadu_si128((const __m128i *) pl->digit_mask[index])),
+                                      _mm_andnot_si128(sep,   _mm_loadu_si128((const __m128i *) pl->literal_mask[index])));
+
+   return (_mm_movemask_epi8(bad));
+} /* static int invalid_layout_vector(__m128i v, const TIME_LAYOUT * pl, int index) */
+#endif
+
+
+/* ------------------------------------------------------------------------- *\
+   parse_times_of_layout parses count UTC times of a fixed layout.
+\* ------------------------------------------------------------------------- */
+
+size_t parse_times_of_layout(const char * layout, const char * pstr, size_t stride, size_t count, time64_t * pt, int32_t * pnsec, uint8_t * perr)
+{
+   TIME_LAYOUT l;
+   size_t      errors = 0;
+   size_t      i;
+   uint8_t     bits   = 0;
+#ifdef TIME_API_SSE2
+   size_t      first_vector; /* first element that allows a load in front of the string */
+#endif
+
+   if(!layout || !pstr || !pt || !compile_layout(layout, &l))
+      return (count);
+
+#ifdef TIME_API_SSE2
+   first_vector = (l.len >= 16) ? 0 : (stride ? ((size_t) (16 - l.len) + stride - 1) / stride : count);
+#endif
+
+   for(i = 0; i < count; ++i)
+   {
+      const char * p = pstr + (i * stride);
+      int32_t      leap_year;
+      int32_t      rule_index;
+      int64_t      days;
+      int32_t      year;
+      int32_t      mon;
+      int32_t      mday;
+      int32_t      hour = 0;
+      int32_t      min  = 0;
+      int32_t      sec  = 0;
+      int32_t      nsec = 0;
+      int32_t      bad;
+
+#ifdef TIME_API_SSE2
+      if(i >= first_vector)
+      {
+         bad = invalid_layout_vector(_mm_loadu_si128((const __m128i *) (p + l.len - 16)), &l, 1);
+
+         if(l.len > 16)
+            bad |= invalid_layout_vector(_mm_loadu_si128((const __m128i *) p), &l, 0);
+
+         bad = (bad != 0);
+      }
+      else
+#endif
+         bad = !valid_layout_chars(&l, p);
+
+      /* the digits are valid or the element is invalid anyway */
+      year = (p[l.year] - '0') * 1000 + (p[l.year + 1] - '0') * 100 + (p[l.year + 2] - '0') * 10 + (p[l.year + 3] - '0');
+      mon  = (p[l.mon]  - '0') * 10 + (p[l.mon + 1]  - '0') - 1;
+      mday = (p[l.mday] - '0') * 10 + (p[l.mday + 1] - '0');
+
+      if(l.hour >= 0)
+         hour = (p[l.hour] - '0') * 10 + (p[l.hour + 1] - '0');
+
+      if(l.min >= 0)
+         min = (p[l.min] - '0') * 10 + (p[l.min + 1] - '0');
+
+      if(l.sec >= 0)
+         sec = (p[l.sec] - '0') * 10 + (p[l.sec + 1] - '0');
+
+      if((l.frac >= 0) && !bad)
+      {
+         int32_t k;
+
+         for(k = 0; k < l.frac_digits; ++k)
+            nsec = (nsec * 10) + (p[l.frac + k] - '0');
+
+         for(; k < 9; ++k)
+            nsec *= 10;
+      }
+
+      bad |= ((uint32_t) sec  > 60) /* allow specification of a positive leap second */
+          |  ((uint32_t) min  > 59)
+          |  ((uint32_t) hour > 23)
+          |  ((uint32_t) mon  > 11)
+          |  (((uint32_t) mday - 1u) > 30);
+
+      if(bad)
+      { /* keep the table lookups valid, the element is invalid anyway */
+         year = 1970;
+         mon  = 0;
+         mday = 1;
+         nsec = 0;
+      }
+
+      days = days_of_civil_date(year, mon, mday, &leap_year, &rule_index);
+
+      bad |= mday > (leap_year ? days_of_month_array_ly[mon] : days_of_month_array[mon]);
+
+      pt[i] = bad ? (time64_t) -1 : (time64_t) ((days * 86400) + (hour * 3600) + (min * 60) + sec);
+
+      if(pnsec)
+         pnsec[i] = nsec;
+
+      errors += bad;
+      bits   |= (uint8_t) (bad << (i & 7));
+
+      if(((i & 7) == 7) || (i + 1 == count))
+      {
+         if(perr)
+            perr[i >> 3] = bits;
+         bits = 0;
+      }
+   }
+
+   return (errors);
+} /* size_t parse_times_of_layout(...) */
+
+
+/* ========================================================================= *\
+   HTTP dates
+\* ========================================================================= */
+
+static const char http_day_names[7][4]    = { "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat" };
+static const char http_month_names[12][4] = { "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
+
+static const char * const http_long_day_names[7] = { "Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday" };
+
+
+/* ------------------------------------------------------------------------- *\
+   HTTP_DATE_CACHE is the per thread cache of format_http_date. A server
+   formats the same second again and again and the other times of the day
+   need the time of the day only.
+\* ------------------------------------------------------------------------- */
+
+typedef struct HTTP_DATE_CACHE_S HTTP_DATE_CACHE;
+struct HTTP_DATE_CACHE_S
+{
+   time64_t day;                       /* days since 1970 of the cached text or INT64_MIN */
+   time64_t t;                         /* time of the cached text */
+   char     text[TIME_HTTP_DATE_SIZE]; /* the IMF-fixdate of t */
+};
+
+static TA_THREAD_LOCAL HTTP_DATE_CACHE http_date_cache = { INT64_MIN, 0, "" };
+
+
+/* ------------------------------------------------------------------------- *\
+   format_http_date writes the time t as IMF-fixdate into buf.
+\* ------------------------------------------------------------------------- */
+
+size_t format_http_date(time64_t t, char * buf, size_t size)
+{
+   HTTP_DATE_CACHE * pc   = &http_date_cache;
+   time64_t          day  = (t >= 0) ? (t / 86400) : ((t + 1) / 86400 - 1);
+   int32_t           secs = (int32_t) (t - (day * 86400));
+   size_t            len  = 0;
+   struct tm         tm;
+   char *            p;
+
+   if(!buf)
+   {
+      SET_ERRNO(EINVAL);
+      goto Exit;
+   }
+
+   if(size < TIME_HTTP_DATE_SIZE)
+   {
+      SET_ERRNO(ERANGE);
+      goto Exit;
+   }
+
+   if((day != pc->day) || (t != pc->t))
+   {
+      if(day != pc->day)
+      {
+         if(!new_gmtime_r(t, &tm) || (tm.tm_year < -1900) || (tm.tm_year > 9999 - 1900))
+         {
+#ifdef EOVERFLOW
+            SET_ERRNO(EOVERFLOW);
+#else
+            SET_ERRNO(ERANGE);
+#endif
+            goto Exit;
+         }
+
+         p = pc->text;
+         memcpy(p, http_day_names[tm.tm_wday], 3);
+         p[3] = ',';
+         p[4] = ' ';
+         p    = put_digits(p + 5, (uint32_t) tm.tm_mday, 2);
+         *p++ = ' ';
+         memcpy(p, http_month_names[tm.tm_mon], 3);
+         p[3] = ' ';
+         p    = put_digits(p + 4, (uint32_t) (tm.tm_year + 1900), 4);
+         memcpy(p, " 00:00:00 GMT", 14);
+
+         pc->day = day;
+      }
+
+      put_digits(pc->text + 17, (uint32_t) (secs / 3600), 2);
+      put_digits(pc->text + 20, (uint32_t) (secs / 60 % 60), 2);
+      put_digits(pc->text + 23, (uint32_t) (secs % 60), 2);
+      pc->t = t;
+   }
+
+   memcpy(buf, pc->text, TIME_HTTP_DATE_SIZE);
+   len = TIME_HTTP_DATE_SIZE - 1;
+
+   Exit:;
+   return (len);
+} /* size_t format_http_date(time64_t t, char * buf, size_t size) */
+
+
+/* ------------------------------------------------------------------------- *\
+   find_http_name returns the index of the name of 3 characters at p in the
+   array names or -1 if it isn't one of them.
+\* ------------------------------------------------------------------------- */
+
+static int32_t find_http_name(const char * p, const char (* names)[4], int32_t count)
+{
+   int32_t i;
+
+   for(i = 0; i < count; ++i)
+   {
+      if((p[0] == names[i][0]) && (p[1] == names[i][1]) && (p[2] == names[i][2]))
+         return (i);
+   }
+
+   return (-1);
+} /* static int32_t find_http_name(const char * p, const char (* names)[4], int32_t count) */
+
+
+/* ------------------------------------------------------------------------- *\
+   parse_http_time parses "hh:mm:ss" at p and returns the seconds of the
+   day or -1 if it is invalid. The second 60 is allowed.
+\* ------------------------------------------------------------------------- */
+
+static int32_t parse_http_time(const char * p)
+{
+   int32_t hour = get_digits(p, 2);
+   int32_t min  = get_digits(p + 3, 2);
+   int32_t sec  = get_digits(p + 6, 2);
+
+   if((p[2] != ':') || (p[5] != ':') || ((uint32_t) hour > 23) || ((uint32_t) min > 59) || ((uint32_t) sec > 60))
+      return (-1);
+
+   return ((hour * 3600) + (min * 60) + sec);
+} /* static int32_t parse_http_time(const char * p) */
+
+
+/* ------------------------------------------------------------------------- *\
+   parse_http_date parses an HTTP-date as IMF-fixdate, RFC 850 or asctime
+   date.
+\* ------------------------------------------------------------------------- */
+
+size_t parse_http_date(const char * str, size_t len, time64_t * pt)
+{
+   const char * p    = str;
+   size_t       used = 0;
+   int32_t      year;
+   int32_t      mon;
+   int32_t      mday;
+   int32_t      secs;
+   int32_t      leap_year;
+   int32_t      rule_index;
+   int32_t      i;
+
+   if(!str || !pt || (len < 24))
+      goto Invalid;
+
+   if(p[3] == ',')
+   { /* IMF-fixdate "Sun, 06 Nov 1994 08:49:37 GMT" */
+      if(   (len < 29) || (find_http_name(p, http_day_names, 7) < 0)
+         || (p[4] != ' ') || (p[7] != ' ') || (p[11] != ' ') || (p[16] != ' ') || (p[25] != ' ') || memcmp(p + 26, "GMT", 3))
+         goto Invalid;
+
+      mday = get_digits(p + 5, 2);
+      mon  = find_http_name(p + 8, http_month_names, 12);
+      year = get_digits(p + 12, 4);
+      secs = parse_http_time(p + 17);
+      used = 29;
+   }
+   else if(p[3] == ' ')
+   { /* asctime "Sun Nov  6 08:49:37 1994" */
+      if((find_http_name(p, http_day_names, 7) < 0) || (p[7] != ' ') || (p[10] != ' ') || (p[19] != ' '))
+         goto Invalid;
+
+      mon  = find_http_name(p + 4, http_month_names, 12);
+      mday = (p[8] == ' ') ? get_digits(p + 9, 1) : get_digits(p + 8, 2);
+      secs = parse_http_time(p + 11);
+      year = get_digits(p + 20, 4);
+      used = 24;
+   }
+   else
+   { /* RFC 850 "Sunday, 06-Nov-94 08:49:37 GMT" */
+      size_t name_len = 0;
+
+      for(i = 0; i < 7; ++i)
+      {
+         name_len = strlen(http_long_day_names[i]);
+
+         if((len > name_len) && !memcmp(p, http_long_day_names[i], name_len))
+            break;
+      }
+
+      if(i == 7)
+         goto Invalid;
+
+      p += name_len;
+      len -= name_len;
+
+      if((len < 24) || (p[0] != ',') || (p[1] != ' ') || (p[4] != '-') || (p[8] != '-') || (p[11] != ' ') || (p[20] != ' ') || memcmp(p + 21, "GMT", 3))
+         goto Invalid;
+
+      mday = get_digits(p + 2, 2);
+      mon  = find_http_name(p + 5, http_month_names, 12);
+      year = get_digits(p + 9, 2);
+      secs = parse_http_time(p + 12);
+      used = name_len + 24;
+
+      if(year >= 0)
+      { /* a two digit year more than 50 years in the future is one of the past century (RFC 9110) */
+         int64_t now  = unix_time() / 1000000;
+         int32_t current_year;
+         struct tm tm;
+
+         new_gmtime_r(now, &tm);
+         current_year = tm.tm_year + 1900;
+
+         year += current_year - (current_year % 100);
+
+         if(year > current_year + 50)
+            year -= 100;
+      }
+   }
+
+   if((year < 0) || (mon < 0) || (mday < 0) || (secs < 0) || !valid_local_date(year, mon, mday, 0, 0, 0))
+      goto Invalid;
+
+   *pt = (days_of_civil_date(year, mon, mday, &leap_year, &rule_index) * 86400) + secs;
+   goto Exit;
+
+   Invalid:;
+   used = 0;
+   SET_ERRNO(EINVAL);
+
+   Exit:;
+   return (used);
+} /* size_t parse_http_date(const char * str, size_t len, time64_t * pt) */
+
+
+/* ========================================================================= *\
+   Timestamps of log files
+\* ========================================================================= */
+
+/* ------------------------------------------------------------------------- *\
+   parse_log_fraction parses an optional fraction of the seconds at p and
+   stores its nanoseconds in pnsec. It returns the number of the parsed
+   characters.
+\* ------------------------------------------------------------------------- */
+
+static size_t parse_log_fraction(const char * p, const char * pend, int32_t * pnsec)
+{
+   const char * pstart = p;
+   int32_t      nsec   = 0;
+   int32_t      digits = 0;
+
+   if((p + 1 < pend) && (*p == '.') && ((uint32_t) (p[1] - '0') <= 9))
+   { /* digits after the nanoseconds are truncated */
+      for(++p; (p < pend) && ((uint32_t) (*p - '0') <= 9); ++p, ++digits)
+      {
+         if(digits < 9)
+            nsec = (nsec * 10) + (*p - '0');
+      }
+
+      for(; digits < 9; ++digits)
+         nsec *= 10;
+   }
+
+   if(pnsec)
+      *pnsec = nsec;
+
+   return ((size_t) (p - pstart));
+} /* static size_t parse_log_fraction(const char * p, const char * pend, int32_t * pnsec) */
+
+
+/* ------------------------------------------------------------------------- *\
+   SYSLOG_FUTURE is the time that a syslog time may be after the reference
+   time of parse_syslog_time for clocks that are slightly ahead, otherwise
+   it is a time of the year before.
+\* ------------------------------------------------------------------------- */
+
+#define SYSLOG_FUTURE  (7 * 86400)
+
+
+/* ------------------------------------------------------------------------- *\
+   parse_syslog_time parses a BSD syslog time "Oct 17 04:01:02" and infers
+   the year from the reference time.
+\* ------------------------------------------------------------------------- */
+
+size_t parse_syslog_time(const char * str, size_t len, time64_t reference, time64_t * pt, int32_t * pnsec, const TIME_ZONE_INFO * ptzi)
+{
+   size_t    used = 0;
+   int32_t   mon;
+   int32_t   mday;
+   int32_t   secs;
+   int32_t   leap_year;
+   int32_t   rule_index;
+   int64_t   local_ref;
+   int64_t   year;
+   struct tm tm;
+   time64_t  t;
+   int       err;
+
+   if(!str || !pt || (len < 15) || (str[3] != ' ') || (str[6] != ' '))
+      goto Invalid;
+
+   mon  = find_http_name(str, http_month_names, 12);
+   mday = (str[4] == ' ') ? get_digits(str + 5, 1) : get_digits(str + 4, 2);
+   secs = parse_http_time(str + 7);
+
+   if((mon < 0) || (mday < 1) || (secs < 0))
+      goto Invalid;
+
+   /* the latest of the three years around the local reference time that isn't too far in the future */
+   if(!(ptzi ? localtime_of_zone(reference, &tm, ptzi) : new_gmtime_r(reference, &tm)))
+      goto Invalid;
+
+   local_ref = (days_of_civil_date((int64_t) tm.tm_year + 1900, tm.tm_mon, tm.tm_mday, &leap_year, &rule_index) * 86400)
+             + (tm.tm_hour * 3600) + (tm.tm_min * 60) + tm.tm_sec;
+
+   for(year = (int64_t) tm.tm_year + 1900 + 1; year >= (int64_t) tm.tm_year + 1900 - 1; --year)
+   {
+      if(   valid_local_date(year, mon, mday, 0, 0, 0) /* February 29 needs a leap year */
+         && ((days_of_civil_date(year, mon, mday, &leap_year, &rule_index) * 86400) + secs - local_ref <= SYSLOG_FUTURE))
+         break;
+   }
+
+   if((year < (int64_t) tm.tm_year + 1900 - 1) || (year - 1900 != (int) (year - 1900)))
+      goto Invalid;
+
+   memset(&tm, 0, sizeof(tm));
+   tm.tm_year  = (int) (year - 1900);
+   tm.tm_mon   = mon;
+   tm.tm_mday  = mday;
+   tm.tm_hour  = secs / 3600;
+   tm.tm_min   = secs / 60 % 60;
+   tm.tm_sec   = secs % 60;
+   tm.tm_isdst = -1;
+
+   err   = errno;
+   errno = 0;
+   t     = ptzi ? mktime_of_zone(&tm, ptzi) : new_timegm(&tm);
+
+   if((t == (time64_t) -1) && errno)
+      goto Exit;
+
+   errno = err;
+   *pt   = t;
+   used  = 15 + parse_log_fraction(str + 15, str + len, pnsec);
+   goto Exit;
+
+   Invalid:;
+   SET_ERRNO(EINVAL);
+
+   Exit:;
+   return (used);
+} /* size_t parse_syslog_time(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   parse_clf_time parses a time of the Common Log Format with or without
+   the brackets, e.g. "[10/Oct/2000:13:55:36 -0700]".
+\* ------------------------------------------------------------------------- */
+
+size_t parse_clf_time(const char * str, size_t len, time64_t * pt, int32_t * pnsec)
+{
+   const char * p    = str;
+   size_t       used = 0;
+   int32_t      mon;
+   int32_t      mday;
+   int32_t      year;
+   int32_t      secs;
+   int32_t      offset_hour;
+   int32_t      offset_min;
+   int32_t      leap_year;
+   int32_t      rule_index;
+   int32_t      bracket;
+
+   if(!str || !pt || (len < 26))
+      goto Invalid;
+
+   bracket = (*p == '[');
+   p      += bracket;
+
+   if(   ((size_t) bracket * 2 + 26 > len) || (p[2] != '/') || (p[6] != '/') || (p[11] != ':') || (p[20] != ' ')
+      || ((p[21] != '+') && (p[21] != '-')) || (bracket && (p[26] != ']')))
+      goto Invalid;
+
+   mday        = get_digits(p, 2);
+   mon         = find_http_name(p + 3, http_month_names, 12);
+   year        = get_digits(p + 7, 4);
+   secs        = parse_http_time(p + 12);
+   offset_hour = get_digits(p + 22, 2);
+   offset_min  = get_digits(p + 24, 2);
+
+   if(   (year < 0) || (mon < 0) || (mday < 0) || (secs < 0) || !valid_local_date(year, mon, mday, 0, 0, 0)
+      || ((uint32_t) offset_hour > 23) || ((uint32_t) offset_min > 59))
+      goto Invalid;
+
+   *pt = (days_of_civil_date(year, mon, mday, &leap_year, &rule_index) * 86400) + secs
+       - ((p[21] == '-') ? -1 : 1) * ((offset_hour * 3600) + (offset_min * 60));
+
+   if(pnsec)
+      *pnsec = 0;
+
+   used = (size_t) bracket * 2 + 26;
+   goto Exit;
+
+   Invalid:;
+   SET_ERRNO(EINVAL);
+
+   Exit:;
+   return (used);
+} /* size_t parse_clf_time(const char * str, size_t len, time64_t * pt, int32_t * pnsec) */
+
+
+/* ------------------------------------------------------------------------- *\
+   parse_journal_time parses the microseconds since 1970 of a journald
+   timestamp as __REALTIME_TIMESTAMP.
+\* ------------------------------------------------------------------------- */
+
+size_t parse_journal_time(const char * str, size_t len, time64_t * pt, int32_t * pnsec)
+{
+   const char * p     = str;
+   const char * pend  = str + len;
+   uint64_t     value = 0;
+   size_t       used  = 0;
+
+   if(!str || !pt || !len || ((uint32_t) (*p - '0') > 9))
+   {
+      SET_ERRNO(EINVAL);
+      goto Exit;
+   }
+
+   for(; (p < pend) && ((uint32_t) (*p - '0') <= 9); ++p)
+   {
+      if(value > (((uint64_t) INT64_MAX) - (uint64_t) (*p - '0')) / 10)
+      {
+#ifdef EOVERFLOW
+         SET_ERRNO(EOVERFLOW);
+#else
+         SET_ERRNO(ERANGE);
+#endif
+         goto Exit;
+      }
+
+      value = (value * 10) + (uint64_t) (*p - '0');
+   }
+
+   *pt = (time64_t) (value / 1000000);
+
+   if(pnsec)
+      *pnsec = (int32_t) (value % 1000000) * 1000;
+
+   used = (size_t) (p - str);
+
+   Exit:;
+   return (used);
+} /* size_t parse_journal_time(const char * str, size_t len, time64_t * pt, int32_t * pnsec) */
+
+
+/* ========================================================================= *\
+   Times with time zone names
+\* ========================================================================= */
+
+/* ------------------------------------------------------------------------- *\
+   A TIME_ZONE_CACHE is an open addressing hash table of pointers to the
+   compiled zones with at least twice the slots of the used ones. Every
+   zone has an allocation of its own that stays until the cache is
+   destroyed, so a returned zone never changes. The table doubles its
+   slots for more known zones, which are limited by the zone names of the
+   lookup and the fixed offsets. Unknown names are kept with a zone type of
+   0 as long as fewer names than the capacity are used, so they don't
+   search the lookup again, but arbitrary words can't fill the memory.
+\* ------------------------------------------------------------------------- */
+
+typedef struct TIME_ZONE_CACHE_ENTRY_S TIME_ZONE_CACHE_ENTRY;
+struct TIME_ZONE_CACHE_ENTRY_S
+{
+   uint32_t       hash;                     /* hash of the name */
+   char           name[TIME_ZONE_NAME_MAX]; /* the terminated name */
+   TIME_ZONE_INFO tzi;                      /* the compiled zone */
+};
+
+struct TIME_ZONE_CACHE_S
+{
+   TIME_ZONE_LOOKUP         pfn_lookup; /* returns the TZ value of a name */
+   size_t                   mask;       /* number of the slots - 1 */
+   size_t                   capacity;   /* maximum number of the used slots with unknown names */
+   size_t                   used;       /* number of the used slots */
+   TIME_ZONE_CACHE_ENTRY ** ppentries;  /* the slots, NULL for a free one */
+};
+
+
+/* ------------------------------------------------------------------------- *\
+   create_time_zone_cache creates a cache for capacity zone names.
+\* ------------------------------------------------------------------------- */
+
+TIME_ZONE_CACHE * create_time_zone_cache(size_t capacity, TIME_ZONE_LOOKUP pfn_lookup)
+{
+   TIME_ZONE_CACHE * pcache = NULL;
+   size_t            slots  = 16;
+
+   if(!pfn_lookup)
+   {
+      SET_ERRNO(EINVAL);
+      goto Exit;
+   }
+
+   if(!capacity)
+      capacity = 64;
+
+   while((slots < capacity * 2) && (slots < ((size_t) -1 >> 2)))
+      slots *= 2;
+
+   pcache = (TIME_ZONE_CACHE *) calloc(1, sizeof(*pcache));
+   if(pcache)
+      pcache->ppentries = (TIME_ZONE_CACHE_ENTRY **) calloc(slots, sizeof(TIME_ZONE_CACHE_ENTRY *));
+
+   if(!pcache || !pcache->ppentries)
+   {
+      free(pcache);
+      pcache = NULL;
+      SET_ERRNO(ENOMEM);
+      goto Exit;
+   }
+
+   pcache->pfn_lookup = pfn_lookup;
+   pcache->mask       = slots - 1;
+   pcache->capacity   = (capacity < slots) ? capacity : slots / 2;
+
+   Exit:;
+   return (pcache);
+} /* TIME_ZONE_CACHE * create_time_zone_cache(size_t capacity, TIME_ZONE_LOOKUP pfn_lookup) */
+
+
+/* ------------------------------------------------------------------------- *\
+   destroy_time_zone_cache releases a cache.
+\* ------------------------------------------------------------------------- */
+
+void destroy_time_zone_cache(TIME_ZONE_CACHE * pcache)
+{
+   size_t i;
+
+   if(pcache)
+   {
+      for(i = 0; i <= pcache->mask; ++i)
+         free(pcache->ppentries[i]);
+
+      free(pcache->ppentries);
+      free(pcache);
+   }
+} /* void destroy_time_zone_cache(TIME_ZONE_CACHE * pcache) */
+
+
+/* ------------------------------------------------------------------------- *\
+   read_offset_zone compiles a zone of a fixed offset "+hh:mm" or "-hh:mm"
+   of RFC 9557 and returns nonzero in success case.
+\* ------------------------------------------------------------------------- */
+
+static int read_offset_zone(TIME_ZONE_INFO * ptzi, const char * name, size_t len)
+{
+   char    tz[16];
+   int32_t hour;
+   int32_t min;
+
+   if((len != 6) || (name[3] != ':'))
+      return (0);
+
+   hour = get_digits(name + 1, 2);
+   min  = get_digits(name + 4, 2);
+
+   if(((uint32_t) hour > 23) || ((uint32_t) min > 59))
+      return (0);
+
+   /* the sign of a TZ value is the one of the offset west of UTC */
+   sprintf(tz, "<%c%02d%02d>%c%02d:%02d", name[0], (int) hour, (int) min, (name[0] == '+') ? '-' : '+', (int) hour, (int) min);
+
+   return (read_TZ(ptzi, tz));
+} /* static int read_offset_zone(TIME_ZONE_INFO * ptzi, const char * name, size_t len) */
+
+
+/* ------------------------------------------------------------------------- *\
+   grow_time_zone_cache doubles the slots of a cache and returns nonzero in
+   success case. The entries keep their allocations.
+\* ------------------------------------------------------------------------- */
+
+static int grow_time_zone_cache(TIME_ZONE_CACHE * pcache)
+{
+   TIME_ZONE_CACHE_ENTRY ** ppentries;
+   size_t                   mask = (pcache->mask * 2) + 1;
+   size_t                   i;
+   size_t                   j;
+
+   if(mask >= ((size_t) -1 >> 2))
+      return (0);
+
+   ppentries = (TIME_ZONE_CACHE_ENTRY **) calloc(mask + 1, sizeof(TIME_ZONE_CACHE_ENTRY *));
+   if(!ppentries)
+      return (0);
+
+   for(i = 0; i <= pcache->mask; ++i)
+   {
+      if(pcache->ppentries[i])
+      {
+         for(j = pcache->ppentries[i]->hash & mask; ppentries[j]; j = (j + 1) & mask)
+            ;
+
+         ppentries[j] = pcache->ppentries[i];
+      }
+   }
+
+   free(pcache->ppentries);
+   pcache->ppentries = ppentries;
+   pcache->mask      = mask;
+   return (1);
+} /* static int grow_time_zone_cache(TIME_ZONE_CACHE * pcache) */
 
-      if (day >= 1096)
-      { /* last year of the remaining 4 year block */
-         day -= 1096;
-         leap_year = 0;
+
+/* ------------------------------------------------------------------------- *\
+   get_cached_zone returns the compiled zone of a name of len characters.
+\* ------------------------------------------------------------------------- */
+
+const TIME_ZONE_INFO * get_cached_zone(TIME_ZONE_CACHE * pcache, const char * name, size_t len)
+{
+   TIME_ZONE_CACHE_ENTRY * pe;
+   const char *            pTZ;
+   uint32_t                hash = 2166136261u; /* FNV-1a */
+   size_t                  i;
+   int                     known;
+
+   if(!pcache || !name || !len || (len >= TIME_ZONE_NAME_MAX))
+      goto Invalid;
+
+   for(i = 0; i < len; ++i)
+      hash = (hash ^ (uint8_t) name[i]) * 16777619u;
+
+   for(i = hash & pcache->mask; (pe = pcache->ppentries[i]) != NULL; i = (i + 1) & pcache->mask)
+   {
+      if((pe->hash == hash) && !memcmp(pe->name, name, len) && !pe->name[len])
+      {
+         if(!pe->tzi.type)
+            goto Invalid; /* an unknown name */
+
+         return (&pe->tzi);
       }
-      else if (day >= 731)
-      { /* 3rd year of the 4 year block */
-         day -= 731;
-         leap_year = 0;
+   }
+
+   pe = (TIME_ZONE_CACHE_ENTRY *) malloc(sizeof(*pe));
+   if(!pe)
+   {
+      SET_ERRNO(ENOMEM);
+      return (NULL);
+   }
+
+   memcpy(pe->name, name, len);
+   pe->name[len] = '\0';
+   pe->hash      = hash;
+
+   if((name[0] == '+') || (name[0] == '-'))
+   {
+      known = read_offset_zone(&pe->tzi, name, len);
+   }
+   else
+   {
+      pTZ   = pcache->pfn_lookup(pe->name);
+      known = pTZ && read_TZ(&pe->tzi, pTZ);
+   }
+
+   if(!known)
+   {
+      pe->tzi.type = 0;
+
+      if(pcache->used >= pcache->capacity)
+      { /* the unknown name isn't kept in a full cache */
+         free(pe);
+         goto Invalid;
       }
-      else if (day >= 366)
-      { /* 2nd year of the 4 year block */
-         day -= 366;
-         leap_year = 0;
+   }
+
+   if((pcache->used + 1) * 2 > pcache->mask + 1)
+   {
+      if(!grow_time_zone_cache(pcache))
+      {
+         free(pe);
+         SET_ERRNO(ENOMEM);
+         return (NULL);
       }
 
-      time_of_year = ((int32_t) day * 86400) /* time between the begin of the day and the begin of the year */
-                     + time_of_day;          /* time since begin of the day */
+      for(i = hash & pcache->mask; pcache->ppentries[i]; i = (i + 1) & pcache->mask)
+         ;
+   }
 
-      /* The day of week calculation works well for years before 0 as well because every 400 year epoch starts with the same day of week */
-      wday_year_start = (int32_t)((((time - time_of_year) / 86400) + 6 /* 6 is offset at 1/1/0000 */) % 7); /* day of the week the year starts with 0=Sunday 1= Monday ... */
-      daylight_start  = ptzi->daylight.start[wday_year_start + (leap_year * 7)] + ptzi->standard.bias; /* time offset of begin of the daylight saving within the year in seconds */
-      standard_start  = ptzi->standard.start[wday_year_start + (leap_year * 7)] + ptzi->daylight.bias; /* time offset of returning to the standard time in the year in seconds */
+   pcache->ppentries[i] = pe;
+   ++pcache->used;
 
-      if (daylight_start > standard_start)
-      {  /* southern hemisphere */
-         if((time_of_year >= standard_start) && (time_of_year < daylight_start))
-         {
-            ptz = &ptzi->standard;
+   if(known)
+      return (&pe->tzi);
+
+   Invalid:;
+   SET_ERRNO(EINVAL);
+   return (NULL);
+} /* const TIME_ZONE_INFO * get_cached_zone(TIME_ZONE_CACHE * pcache, const char * name, size_t len) */
+
+
+/* ------------------------------------------------------------------------- *\
+   zone_name_length returns the length of a time zone name at p, which
+   consists of letters, digits and the characters "/_+-".
+\* ------------------------------------------------------------------------- */
+
+static size_t zone_name_length(const char * p, const char * pend)
+{
+   const char * pstart = p;
+
+   for(; p < pend; ++p)
+   {
+      if(   ((uint32_t) ((*p | 0x20) - 'a') >= 26) && ((uint32_t) (*p - '0') > 9)
+         && (*p != '/') && (*p != '_') && (*p != '+') && (*p != '-'))
+         break;
+   }
+
+   return ((size_t) (p - pstart));
+} /* static size_t zone_name_length(const char * p, const char * pend) */
+
+
+/* ------------------------------------------------------------------------- *\
+   parse_zoned_time_ns parses an ISO time with an optional zone name suffix.
+\* ------------------------------------------------------------------------- */
+
+size_t parse_zoned_time_ns(const char * str, size_t len, int64_t * pns, const TIME_ZONE_INFO * ptzi, TIME_ZONE_CACHE * pcache, const TIME_ZONE_INFO ** ppzone)
+{
+   const char *           p;
+   const char *           pend  = str + len;
+   const TIME_ZONE_INFO * pzone = NULL;
+   ISO_TIME               it;
+   size_t                 used;
+
+   if(!str || !pns || !pcache || !(used = parse_iso_time(str, len, &it)))
+      goto Invalid;
+
+   p = str + used;
+
+   if((p < pend) && (*p == '['))
+   { /* RFC 9557 suffixes "[Europe/Paris]", "[!Europe/Paris]" or "[key=value]" */
+      while((p < pend) && (*p == '['))
+      {
+         const char * pclose   = (const char *) memchr(p, ']', (size_t) (pend - p));
+         int          critical = (p + 1 < pend) && (p[1] == '!');
+         const char * pname    = p + 1 + critical;
+
+         if(!pclose || (pclose == pname))
+            goto Invalid;
+
+         if(memchr(pname, '=', (size_t) (pclose - pname)))
+         { /* the only calendar is the Gregorian one and other keys are ignored unless they are critical */
+            size_t key_len = (size_t) (pclose - pname);
+
+            if(   critical
+               && ((key_len != 12) || (memcmp(pname, "u-ca=iso8601", 12) && memcmp(pname, "u-ca=gregory", 12))))
+               goto Invalid;
          }
          else
          {
-            ptz = &ptzi->daylight;
-            isDaylightSaving = 1;
+            if(   pzone
+               || ((*pname != '+') && (*pname != '-') && (zone_name_length(pname, pclose) != (size_t) (pclose - pname))))
+               goto Invalid; /* a second zone or an invalid name, offsets are checked by get_cached_zone */
+
+            pzone = get_cached_zone(pcache, pname, (size_t) (pclose - pname));
+
+            if(!pzone)
+               goto Exit; /* errno is set by get_cached_zone already */
          }
+
+         p = pclose + 1;
       }
-      else
-      {  /* northern hemisphere */
-         if((time_of_year >= daylight_start) && (time_of_year < standard_start))
-         {
-            ptz = &ptzi->daylight;
-            isDaylightSaving = 1;
-         }
-         else
-         {
-            ptz = &ptzi->standard;
-         }
+   }
+   else if((p + 1 < pend) && (*p == ' ') && ((uint32_t) ((p[1] | 0x20) - 'a') < 26))
+   { /* a plain name of an area "Europe/Paris" or "UTC", any other word is no part of the time */
+      size_t name_len = zone_name_length(p + 1, pend);
+      int    err      = errno;
+
+      if(memchr(p + 1, '/', name_len) || ((name_len == 3) && !memcmp(p + 1, "UTC", 3)))
+      {
+         pzone = get_cached_zone(pcache, p + 1, name_len);
+         errno = err;
+
+         if(pzone)
+            p += 1 + name_len;
       }
    }
-   else
+
+   if(!join_iso_time(&it, pns, pzone ? pzone : ptzi))
+      goto Exit;
+
+   if(pzone && (it.offset_type == ISO_OFFSET) && (utc_offset_of_zone(split_time_ns(*pns, NULL), pzone, NULL, NULL, NULL) != it.offset))
+      goto Invalid; /* the offset doesn't match the zone */
+
+   if(ppzone)
+      *ppzone = pzone;
+
+   return ((size_t) (p - str));
+
+   Invalid:;
+   SET_ERRNO(EINVAL);
+
+   Exit:;
+   return (0);
+} /* size_t parse_zoned_time_ns(...) */
+
+
+/* ========================================================================= *\
+   ISO 8601 week dates in time zones
+\* ========================================================================= */
+
+/* ------------------------------------------------------------------------- *\
+   The week date state keeps the offset interval of the last time and the
+   local days of the last week together with its year and number.
+\* ------------------------------------------------------------------------- */
+
+typedef struct WEEK_DATE_STATE_S WEEK_DATE_STATE;
+struct WEEK_DATE_STATE_S
+{
+   ZONE_OFFSET_CACHE offset;     /* offset interval of the converted times */
+   int64_t           last;       /* last converted time */
+   int64_t           week_begin; /* local day of the Monday of the last week */
+   int64_t           week_end;   /* local day after the last week */
+   int64_t           year;       /* week-numbering year of the last week */
+   int32_t           week;       /* number of the last week 1 .. 53 */
+};
+
+
+/* ------------------------------------------------------------------------- *\
+   week_date_of_time is the common implementation of week_date_of_zone and
+   week_date_array_of_zone. The interval of the offset is determined only
+   if t is less than a year after or before the last time, since it is
+   more expensive than the rule of the UTC year and pays off for sorted
+   times only. A week belongs to the year of its Thursday, so its number
+   follows from the day of the year of that Thursday that may be in the
+   year before or after the local day. The function returns the
+   week-numbering year and stores the week and the day of the week in
+   pweek and pwday. The local time of t needs to be in the range of a
+   time64_t.
+\* ------------------------------------------------------------------------- */
+
+static int64_t week_date_of_time(time64_t t, const TIME_ZONE_INFO * ptzi, WEEK_DATE_STATE * pstate, int32_t * pweek, int32_t * pwday)
+{
+   int32_t mon;
+   int32_t mday;
+   int32_t yday;
+   int32_t leap_year;
+   int32_t time_of_day;
+   int64_t days   = split_time(t, &time_of_day);
+   int64_t year   = 0;
+   int32_t civil  = 0; /* year, yday and leap_year are the ones of days */
+   int32_t offset = 0;
+
+   if((t >= pstate->offset.begin) && (t < pstate->offset.end))
    {
-      ptz = &ptzi->standard;
+      offset = pstate->offset.offset;
+   }
+   else if(((uint64_t) t - (uint64_t) pstate->last + (uint64_t) 86400 * 366) <= (uint64_t) 86400 * 366 * 2)
+   {
+      offset = get_cached_offset(ptzi, t, &pstate->offset);
+   }
+   else if(ptzi)
+   {
+      int32_t isdst;
+
+      year   = civil_of_days(days, &mon, &mday, &yday, &leap_year);
+      civil  = 1;
+      offset = -get_utc_rule(ptzi, days, yday, time_of_day, leap_year, &isdst)->bias;
    }
 
-   if(ptm)
+   pstate->last = t;
+   time_of_day += offset;
+
+   if((uint32_t) time_of_day >= 86400)
+   { /* the local time is at another day than the UTC time */
+      days  = split_time((days * 86400) + time_of_day, &time_of_day);
+      civil = 0;
+   }
+
+   if((days < pstate->week_begin) || (days >= pstate->week_end))
    {
-      struct tm * ptm_ret = new_gmtime_r(utc_time - ptz->bias, ptm);
-      ptm->tm_isdst = isDaylightSaving; /* set summer time flag */
+      int32_t wday = (int32_t) ((days + 3 /* 1/1/1970 was a Thursday */) % 7); /* 0 = Monday */
+      int32_t thursday;
 
-#if defined __TM_ZONE || (defined (_POSIX_VERSION) && (_POSIX_VERSION  >= 202405))
-      ptm->tm_gmtoff = -ptz->bias;
-      ptm->tm_zone   = ptz->zone_name;
-#endif
+      if(wday < 0)
+         wday += 7;
 
-      ptm = ptm_ret;
+      if(!civil)
+         year = civil_of_days(days, &mon, &mday, &yday, &leap_year);
+
+      thursday = yday - wday + 3; /* day of the year of the Thursday of the week */
+
+      if(thursday < 0)
+      { /* the week belongs to the previous year */
+         int64_t prev_year = year - 1;
+
+         thursday += 365 + (((prev_year & 3) == 0) & ((prev_year % 100 != 0) | (prev_year % 400 == 0)));
+         year      = prev_year;
+      }
+      else if(thursday >= 365 + leap_year)
+      { /* the week belongs to the next year */
+         thursday -= 365 + leap_year;
+         ++year;
+      }
+
+      pstate->week_begin = days - wday;
+      pstate->week_end   = pstate->week_begin + 7;
+      pstate->year       = year;
+      pstate->week       = (thursday / 7) + 1;
    }
 
-   return (ptm);
-}/* struct tm * localtime_of_zone(time64_t t, struct tm * ptm, const TIME_ZONE_INFO * ptzi) */
+   *pweek = pstate->week;
+   *pwday = (int32_t) (days - pstate->week_begin) + 1;
+
+   return (pstate->year);
+} /* int64_t week_date_of_time(...) */
 
 
 /* ------------------------------------------------------------------------- *\
-   new_localtime_r an own implementation of localtime_r
+   week_date_of_zone returns the ISO 8601 week date of a time in the time
+   zone of ptzi.
+\* ------------------------------------------------------------------------- */
 
-   Note: new_localtime_r returns the atronomical date that has a year 0.
-         If you need the historical date you can do this as following
-   ...
-   new_localtime_r(&t, ptm);
-   if(ptm->year <= -1900)
-      --ptm->year;
-   printf ( "The historical year was %s%i%s", ptm->year > -1900 ? "AD" : "",
-            ptm->year + 1900, ptm->year < -1900 ? " BC" : "");
-   ...
+int week_date_of_zone(time64_t t, TIME_WEEK_DATE * pdate, const TIME_ZONE_INFO * ptzi)
+{
+   WEEK_DATE_STATE state;
+   int64_t         year;
+   int32_t         week;
+   int32_t         wday;
 
-   In Posix 2024 systems ptm->tm_zone points to storage in a static
-   TIME_ZONE_INFO struct. It may change once TZ becomes adjusted after the
-   call of new_localtime_r.
+   if(!pdate)
+   {
+      SET_ERRNO(EINVAL);
+      return (0);
+   }
+
+   memset(&state, 0, sizeof(state));
+
+   if((t >= INT64_MIN + 86400) && (t <= INT64_MAX - 86400))
+   { /* the local time is in the range of a time64_t */
+      year = week_date_of_time(t, ptzi, &state, &week, &wday);
+
+      if(year == (int32_t) year)
+      {
+         pdate->year = (int32_t) year;
+         pdate->week = week;
+         pdate->wday = wday;
+         return (1);
+      }
+   }
+
+#ifdef EOVERFLOW
+   SET_ERRNO(EOVERFLOW);
+#else
+   SET_ERRNO(ERANGE);
+#endif
+   return (0);
+} /* int week_date_of_zone(time64_t t, TIME_WEEK_DATE * pdate, const TIME_ZONE_INFO * ptzi) */
+
+
+/* ------------------------------------------------------------------------- *\
+   week_date_array_of_zone converts an array of times into the columns of
+   ISO 8601 week dates as week_date_of_zone does.
 \* ------------------------------------------------------------------------- */
-struct tm * new_localtime_r(time64_t t, struct tm * ptm)
+
+size_t week_date_array_of_zone(const time64_t * pt, size_t count, int32_t * pyear, int8_t * pweek, int8_t * pwday, uint8_t * perr, const TIME_ZONE_INFO * ptzi)
 {
-   struct tm * ptm_ret;
+   WEEK_DATE_STATE state;
+   size_t          errors = 0;
+   size_t          i;
+   uint8_t         bits   = 0;
 
-   if(pta_lock)
-      pta_lock(pv_lock_context);
+   if(!pt)
+      return (count);
 
-   if(!ti.type)
-      update_time_zone_info();
+   memset(&state, 0, sizeof(state));
 
-   ptm_ret = localtime_of_zone(t, ptm, &ti);
+   for(i = 0; i < count; ++i)
+   {
+      int32_t  week;
+      int32_t  wday;
+      time64_t t    = pt[i];
+      int32_t  bad  = (t < INT64_MIN + 86400) | (t > INT64_MAX - 86400);
+      int64_t  year = week_date_of_time(bad ? 0 : t, ptzi, &state, &week, &wday);
 
-   if(pta_unlock)
-      pta_unlock(pv_lock_context);
+      bad |= (year != (int32_t) year);
 
-   return (ptm_ret);
-} /* struct tm * new_localtime_r(time64_t t, struct tm * ptm) */
+      if(pyear) pyear[i] = (int32_t) year;
+      if(pweek) pweek[i] = (int8_t)  week;
+      if(pwday) pwday[i] = (int8_t)  wday;
+
+      errors += bad;
+      bits   |= (uint8_t) (bad << (i & 7));
+
+      if(((i & 7) == 7) || (i + 1 == count))
+      {
+         if(perr)
+            perr[i >> 3] = bits;
+         bits = 0;
+      }
+   }
+
+   return (errors);
+} /* size_t week_date_array_of_zone(...) */
 
 
 /* ------------------------------------------------------------------------- *\
-   get_local_zone_info stores the local time zone information of the system
-   in a user provided struct TIME_ZONE_INFO. It returns nonzero in success
-   case.
+   format_week_date_of_zone writes the ISO 8601 week date of a time in the
+   time zone of ptzi as YYYY-Www-d into buf.
 \* ------------------------------------------------------------------------- */
-int get_local_zone_info(TIME_ZONE_INFO * ptzi)
+
+size_t format_week_date_of_zone(time64_t t, char * buf, size_t size, const TIME_ZONE_INFO * ptzi)
 {
-   int iret = 0;
+   char           str[TIME_WEEK_DATE_SIZE];
+   char *         p   = str;
+   size_t         len = 0;
+   TIME_WEEK_DATE date;
 
-   if(!ptzi)
-       goto Exit;
+   if(!buf)
+   {
+      SET_ERRNO(EINVAL);
+      goto Exit;
+   }
 
-   if(pta_lock)
-      pta_lock(pv_lock_context);
+   if(!week_date_of_zone(t, &date, ptzi))
+      goto Exit; /* errno is set by week_date_of_zone already */
 
-   if(!ti.type)
-      update_time_zone_info();
+   p    = put_year(p, date.year);
+   *p++ = '-';
+   *p++ = 'W';
+   p    = put_digits(p, (uint32_t) date.week, 2);
+   *p++ = '-';
+   *p++ = (char) ('0' + date.wday);
 
-   *ptzi = ti;
+   len = (size_t) (p - str);
 
-   if(pta_unlock)
-      pta_unlock(pv_lock_context);
+   if(len >= size)
+   {
+      SET_ERRNO(ERANGE);
+      len = 0;
+      goto Exit;
+   }
+
+   memcpy(buf, str, len);
+   buf[len] = '\0';
 
-   iret = 1;
    Exit:;
+   return (len);
+} /* size_t format_week_date_of_zone(...) */
 
-   return (iret);
-} /* int get_local_zone_info(TIME_ZONE_INFO * ptzi) */
 
 /* ========================================================================= *\
    E N D   O F   F I L E
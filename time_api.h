@@ -112,6 +112,8 @@ int calendar_week_of_year(const struct tm * ptm);
 
 /* ------------------------------------------------------------------------- *\
    calendar_week_of_time returns the calender week of the year for a time_t
+   in the local time zone of the system. week_date_of_zone returns the week
+   together with its year for any zone without the lock of new_localtime_r.
 \* ------------------------------------------------------------------------- */
 int calendar_week_of_time(time64_t tt);
 
@@ -268,6 +270,673 @@ int read_TZ (TIME_ZONE_INFO * ptzi, const char * pTZ);
 time64_t mktime_of_zone(const struct tm * ptm, const TIME_ZONE_INFO * ptzi);
 
 
+/* ------------------------------------------------------------------------- *\
+   new_timegm_array and mktime_of_zone_array convert arrays of struct tm
+   as new_timegm and mktime_of_zone do but without any branches of the
+   range checks in the hot loop. The results are stored in the array that
+   pt points to. Bit (i % 8) of perr[i / 8] is set if the element i is
+   invalid and its result is -1 and it is cleared otherwise. perr may be
+   NULL, otherwise it needs to provide (count + 7) / 8 bytes. errno is not
+   changed. The functions return the number of the invalid elements.
+\* ------------------------------------------------------------------------- */
+size_t new_timegm_array(const struct tm * ptm, time64_t * pt, uint8_t * perr, size_t count);
+
+size_t mktime_of_zone_array(const struct tm * ptm, time64_t * pt, uint8_t * perr, size_t count, const TIME_ZONE_INFO * ptzi);
+
+
+/* ------------------------------------------------------------------------- *\
+   Columnar broken-down times for query engines that are storing the fields
+   of dates in separate arrays. The members have the same meaning as the
+   ones of a struct tm, e.g. year contains the years since 1900 and mon the
+   month between 0 and 11. gmtoff is the offset of the local time to UTC in
+   seconds as tm_gmtoff. Columns that aren't required can be NULL.
+\* ------------------------------------------------------------------------- */
+typedef struct TIME_COLUMNS_S TIME_COLUMNS;
+struct TIME_COLUMNS_S
+{
+   int32_t * year;   /* years since 1900 */
+   int8_t *  mon;    /* month of the year 0 .. 11 */
+   int8_t *  mday;   /* day of the month 1 .. 31 */
+   int8_t *  hour;   /* hours 0 .. 23 */
+   int8_t *  min;    /* minutes 0 .. 59 */
+   int8_t *  sec;    /* seconds 0 .. 60 */
+   int8_t *  wday;   /* day of the week 0 = Sunday .. 6 = Saturday */
+   int16_t * yday;   /* day of the year 0 .. 365 */
+   int8_t *  isdst;  /* daylight saving flag */
+   int32_t * gmtoff; /* seconds east of UTC */
+};
+
+/* ------------------------------------------------------------------------- *\
+   localtime_columns_of_zone converts count times of the array pt into the
+   columns of pcols as localtime_of_zone does. Only the columns that aren't
+   NULL are filled. A ptzi of NULL means UTC as new_gmtime_r does.
+   Bit (i % 8) of perr[i / 8] is set if the year of the element i is out of
+   the range of an int32_t and cleared otherwise. perr may be NULL. errno is
+   not changed. The function returns the number of the invalid elements.
+\* ------------------------------------------------------------------------- */
+size_t localtime_columns_of_zone(const time64_t * pt, size_t count, const TIME_COLUMNS * pcols, uint8_t * perr, const TIME_ZONE_INFO * ptzi);
+
+/* ------------------------------------------------------------------------- *\
+   mktime_columns_of_zone converts count elements of the columns of pcols
+   into the times of the array pt as mktime_of_zone does. The columns year,
+   mon and mday are required, missing hour, min or sec columns are meaning
+   0 and a missing isdst column means -1. A ptzi of NULL means UTC as
+   new_timegm does. Bit (i % 8) of perr[i / 8] is set if the element i is
+   invalid and its result is -1 and it is cleared otherwise. perr may be
+   NULL. errno is not changed. The function returns the number of the
+   invalid elements.
+\* ------------------------------------------------------------------------- */
+size_t mktime_columns_of_zone(const TIME_COLUMNS * pcols, size_t count, time64_t * pt, uint8_t * perr, const TIME_ZONE_INFO * ptzi);
+
+
+/* ------------------------------------------------------------------------- *\
+   Calendar units of the time functions that are working in local times
+\* ------------------------------------------------------------------------- */
+#define TIME_UNIT_SECOND   0
+#define TIME_UNIT_MINUTE   1
+#define TIME_UNIT_HOUR     2
+#define TIME_UNIT_DAY      3
+#define TIME_UNIT_WEEK     4 /* ISO week that starts at Monday */
+#define TIME_UNIT_MONTH    5
+#define TIME_UNIT_QUARTER  6
+#define TIME_UNIT_YEAR     7
+
+/* ------------------------------------------------------------------------- *\
+   trunc_time_of_zone returns the UTC time of the begin of the local minute,
+   hour, day, week, month, quarter or year that contains the time t in the
+   time zone of ptzi as SQL date_trunc does. A ptzi of NULL means UTC.
+   The begin is the first moment of the period, even on days with 23 or 25
+   hours: If the local begin of the period is skipped by a daylight saving
+   change, then it is the time of that change, and if the local time is
+   ambiguous then it is the latest one that is not later than t.
+   The function returns -1 and sets errno to EINVAL for an invalid unit.
+\* ------------------------------------------------------------------------- */
+time64_t trunc_time_of_zone(time64_t t, int unit, const TIME_ZONE_INFO * ptzi);
+
+/* ------------------------------------------------------------------------- *\
+   trunc_time_array_of_zone truncates count times of the array pt as
+   trunc_time_of_zone does and stores the results in the array presult that
+   may be the same as pt. The time zone offsets and the calendar periods of
+   the previous element are reused if they apply, which makes grouping of
+   sorted or clustered times cheap. The function returns nonzero in success
+   case and sets errno to EINVAL otherwise.
+\* ------------------------------------------------------------------------- */
+int trunc_time_array_of_zone(const time64_t * pt, time64_t * presult, size_t count, int unit, const TIME_ZONE_INFO * ptzi);
+
+
+/* ------------------------------------------------------------------------- *\
+   TIME_BOUNDARIES is the state of an iterator over the UTC times of the
+   local boundaries of a unit in a time zone, e.g. of the begins of all
+   local days of a range. The members are private to the iterator.
+\* ------------------------------------------------------------------------- */
+typedef struct TIME_BOUNDARIES_S TIME_BOUNDARIES;
+struct TIME_BOUNDARIES_S
+{
+   const TIME_ZONE_INFO * ptzi;  /* time zone of the boundaries or NULL for UTC */
+   time64_t next;                /* UTC time of the next boundary */
+   time64_t end;                 /* end of the range of the boundaries */
+   int64_t  local;               /* local begin of the period at next in seconds since 1/1/1970 */
+   int64_t  offset_begin;        /* first UTC time with the offset of next */
+   int64_t  offset_end;          /* UTC time of the next change of the offset */
+   int64_t  year;                /* local year of the period at next */
+   int32_t  mon;                 /* local month of the period at next 0 .. 11 */
+   int32_t  offset;              /* offset of the local time to UTC at next in seconds */
+   int32_t  unit;                /* TIME_UNIT_... of the boundaries */
+};
+
+/* ------------------------------------------------------------------------- *\
+   init_time_boundaries initializes an iterator over the boundaries of the
+   local periods of a unit in the time zone of ptzi that are at or after
+   begin and before end. The boundaries are the times that
+   trunc_time_of_zone returns for the times of that range. A ptzi of NULL
+   means UTC. The iterator steps from boundary to boundary in local time
+   and uses the rules of the zone only at the daylight saving changes.
+   The function returns nonzero in success case and sets errno to EINVAL
+   otherwise.
+\* ------------------------------------------------------------------------- */
+int init_time_boundaries(TIME_BOUNDARIES * pit, time64_t begin, time64_t end, int unit, const TIME_ZONE_INFO * ptzi);
+
+/* ------------------------------------------------------------------------- *\
+   next_time_boundary stores the next boundary of an iterator in pt and
+   returns nonzero. It returns 0 at the end of the range.
+\* ------------------------------------------------------------------------- */
+int next_time_boundary(TIME_BOUNDARIES * pit, time64_t * pt);
+
+/* ------------------------------------------------------------------------- *\
+   get_time_boundaries stores up to count next boundaries of an iterator in
+   the array pt and returns the number of the stored boundaries. It returns
+   less than count at the end of the range only.
+\* ------------------------------------------------------------------------- */
+size_t get_time_boundaries(TIME_BOUNDARIES * pit, time64_t * pt, size_t count);
+
+
+/* ------------------------------------------------------------------------- *\
+   TIME_ZONE_TRANSITION describes a change between the standard time and
+   the daylight saving time of a zone. The zone names point to storage in
+   the TIME_ZONE_INFO struct and become invalid with it.
+\* ------------------------------------------------------------------------- */
+typedef struct TIME_ZONE_TRANSITION_S TIME_ZONE_TRANSITION;
+struct TIME_ZONE_TRANSITION_S
+{
+   time64_t     time;          /* UTC time of the change */
+   int32_t      gmtoff_before; /* seconds east of UTC before the change */
+   int32_t      gmtoff_after;  /* seconds east of UTC at and after the change */
+   int32_t      isdst_before;  /* daylight saving flag before the change */
+   int32_t      isdst_after;   /* daylight saving flag at and after the change */
+   const char * zone_before;   /* name of the zone before the change */
+   const char * zone_after;    /* name of the zone at and after the change */
+};
+
+/* ------------------------------------------------------------------------- *\
+   next_transition stores the first change of the offset of the zone of
+   ptzi after the time t in ptr and prev_transition the last change at or
+   before t. All times from the result of prev_transition until the one of
+   next_transition have the same offset, which allows the conversion of
+   runs of times without evaluating the daylight saving rules for each.
+   The functions return nonzero in success case and 0 if the zone has no
+   daylight saving time. errno is set to EINVAL if ptr or ptzi are NULL.
+\* ------------------------------------------------------------------------- */
+int next_transition(time64_t t, TIME_ZONE_TRANSITION * ptr, const TIME_ZONE_INFO * ptzi);
+
+int prev_transition(time64_t t, TIME_ZONE_TRANSITION * ptr, const TIME_ZONE_INFO * ptzi);
+
+
+/* ------------------------------------------------------------------------- *\
+   utc_offset_of_zone returns the offset of the local time of the zone of
+   ptzi to UTC in seconds east of UTC at the time t without building a
+   struct tm. A ptzi of NULL means UTC. If pisdst isn't NULL it receives
+   the daylight saving flag, and if pbegin and pend aren't NULL they
+   receive the half-open interval of UTC times around t that have the same
+   offset and flag. The result can be cached until a time leaves it.
+\* ------------------------------------------------------------------------- */
+int32_t utc_offset_of_zone(time64_t t, const TIME_ZONE_INFO * ptzi, int32_t * pisdst, time64_t * pbegin, time64_t * pend);
+
+
+/* ------------------------------------------------------------------------- *\
+   Policies for local times that a daylight saving change skips or repeats.
+   TIME_LOCAL_COMPATIBLE takes the earlier time of a repeated local time and
+   moves a skipped one forward by the length of the gap as mktime does.
+   TIME_LOCAL_EARLIER and TIME_LOCAL_LATER take the earlier or the later of
+   the two possible UTC times in both cases and TIME_LOCAL_REJECT fails.
+\* ------------------------------------------------------------------------- */
+#define TIME_LOCAL_COMPATIBLE  0
+#define TIME_LOCAL_EARLIER     1
+#define TIME_LOCAL_LATER       2
+#define TIME_LOCAL_REJECT      3
+
+/* ------------------------------------------------------------------------- *\
+   Kinds of local times as the conversions of local times report them.
+   TIME_LOCAL_UNIQUE local times exist once, TIME_LOCAL_SKIPPED ones are in
+   the gap of a daylight saving change and TIME_LOCAL_REPEATED ones are in
+   its overlap.
+\* ------------------------------------------------------------------------- */
+#define TIME_LOCAL_UNIQUE      0
+#define TIME_LOCAL_SKIPPED     1
+#define TIME_LOCAL_REPEATED    2
+
+/* ------------------------------------------------------------------------- *\
+   add_time_of_zone adds calendar years, months and days to the local date
+   of the time t in the time zone of ptzi and keeps the local time of the
+   day. Years and months are added first and a day of the month that
+   doesn't exist in the resulting month is clamped to its last day, e.g.
+   1/31 plus one month becomes 2/28 or 2/29. The days are added after that.
+   The policy decides about local times that are skipped or repeated by a
+   daylight saving change. A ptzi of NULL means UTC. The function returns
+   -1 and sets errno to ERANGE if the policy rejects the local time and to
+   EINVAL for an invalid policy.
+\* ------------------------------------------------------------------------- */
+time64_t add_time_of_zone(time64_t t, int32_t years, int32_t months, int32_t days, int policy, const TIME_ZONE_INFO * ptzi);
+
+/* ------------------------------------------------------------------------- *\
+   add_time_array_of_zone adds the same calendar years, months and days to
+   count times of the array pt as add_time_of_zone does and stores the
+   results in the array presult that may be the same as pt. Bit (i % 8) of
+   perr[i / 8] is set if the policy rejected the element i and its result
+   is -1 and it is cleared otherwise. perr may be NULL. errno is not
+   changed. The function returns the number of the rejected elements or
+   count for invalid arguments.
+\* ------------------------------------------------------------------------- */
+size_t add_time_array_of_zone(const time64_t * pt, time64_t * presult, uint8_t * perr, size_t count, int32_t years, int32_t months, int32_t days, int policy, const TIME_ZONE_INFO * ptzi);
+
+
+/* ------------------------------------------------------------------------- *\
+   TIME_DIFF is a difference of two times in calendar units
+\* ------------------------------------------------------------------------- */
+typedef struct TIME_DIFF_S TIME_DIFF;
+struct TIME_DIFF_S
+{
+   int64_t years;
+   int64_t months;
+   int64_t days;
+   int64_t hours;
+   int64_t minutes;
+   int64_t seconds;
+};
+
+/* ------------------------------------------------------------------------- *\
+   diff_time_of_zone stores the difference from t1 until t2 in whole units
+   up to the largest unit TIME_UNIT_YEAR, TIME_UNIT_MONTH, TIME_UNIT_DAY,
+   TIME_UNIT_HOUR, TIME_UNIT_MINUTE or TIME_UNIT_SECOND in pdiff.
+   The years, months and days are the whole calendar units between the
+   local dates and times of both in the time zone of ptzi as
+   add_time_of_zone adds them. The hours, minutes and seconds are the
+   elapsed time after those, so a day with a daylight saving change counts
+   as one day but 23 or 25 hours. If t2 is before t1 the difference is the
+   one from t2 until t1 with negative members. A ptzi of NULL means UTC.
+   The function returns nonzero in success case and sets errno to EINVAL
+   for an invalid unit.
+\* ------------------------------------------------------------------------- */
+int diff_time_of_zone(time64_t t1, time64_t t2, int largest_unit, TIME_DIFF * pdiff, const TIME_ZONE_INFO * ptzi);
+
+/* ------------------------------------------------------------------------- *\
+   diff_time_array_of_zone stores the differences of count pairs of times of
+   the arrays pt1 and pt2 in the array pdiff as diff_time_of_zone does.
+   The function returns nonzero in success case and sets errno to EINVAL
+   otherwise.
+\* ------------------------------------------------------------------------- */
+int diff_time_array_of_zone(const time64_t * pt1, const time64_t * pt2, TIME_DIFF * pdiff, size_t count, int largest_unit, const TIME_ZONE_INFO * ptzi);
+
+
+/* ------------------------------------------------------------------------- *\
+   Nanosecond times are counting the nanoseconds since 1/1/1970 UTC in an
+   int64_t as unix_time_ns returns them. They are covering the years 1677
+   until 2262.
+
+   split_time_ns returns the seconds of a nanosecond time by a floor
+   division and stores the nanoseconds of that second between 0 and
+   999999999 in pnsec if it isn't NULL, e.g. -1 ns are -1 s and 999999999 ns.
+   join_time_ns returns the nanosecond time of t seconds and nsec
+   nanoseconds. nsec may be out of the range of a second. It returns -1
+   and sets errno to EOVERFLOW (ERANGE if EOVERFLOW is not defined) if the
+   result is out of the range of an int64_t. Because -1 is a valid result
+   as well errno needs to be checked in that case.
+\* ------------------------------------------------------------------------- */
+time64_t split_time_ns(int64_t ns, int32_t * pnsec);
+
+int64_t join_time_ns(time64_t t, int32_t nsec);
+
+/* ------------------------------------------------------------------------- *\
+   new_gmtime_ns_r and localtime_of_zone_ns convert a nanosecond time as
+   new_gmtime_r and localtime_of_zone do and store the nanoseconds of the
+   second in pnsec if it isn't NULL. new_timegm_ns and mktime_of_zone_ns
+   are the inverse functions of them as new_timegm and mktime_of_zone.
+   They return -1 and set errno in error case.
+\* ------------------------------------------------------------------------- */
+struct tm * new_gmtime_ns_r(int64_t ns, struct tm * ptm, int32_t * pnsec);
+
+struct tm * localtime_of_zone_ns(int64_t ns, struct tm * ptm, int32_t * pnsec, const TIME_ZONE_INFO * ptzi);
+
+int64_t new_timegm_ns(const struct tm * ptm, int32_t nsec);
+
+int64_t mktime_of_zone_ns(const struct tm * ptm, int32_t nsec, const TIME_ZONE_INFO * ptzi);
+
+/* ------------------------------------------------------------------------- *\
+   format_time_of_zone_ns writes a nanosecond time as RFC 3339 local time
+   with digits (0 .. 9) fractional digits of the second and the offset to
+   UTC into buf, e.g. 2024-03-31T03:00:00.120+02:00. The fraction is
+   truncated and omitted for 0 digits. A ptzi of NULL means UTC and writes
+   the offset as Z. Offsets with seconds are written as +hh:mm:ss.
+   The function returns the length of the string without the terminating
+   zero. It returns 0 and sets errno to EINVAL for invalid arguments and to
+   ERANGE if size is too small. TIME_FORMAT_NS_SIZE is always sufficient.
+\* ------------------------------------------------------------------------- */
+#define TIME_FORMAT_NS_SIZE   48
+
+size_t format_time_of_zone_ns(int64_t ns, int digits, char * buf, size_t size, const TIME_ZONE_INFO * ptzi);
+
+
+/* ------------------------------------------------------------------------- *\
+   TIME_NS is a wide-range time with nanoseconds that covers the whole range
+   of a time64_t. sec are the seconds since 1/1/1970 UTC and nsec are the
+   nanoseconds of that second between 0 and 999999999, so 0.5 s before 1970
+   are -1 s and 500000000 ns. The members can be used with the conversions
+   of whole seconds directly. Durations are stored in the same way.
+   None of the functions needs any division of 128 bit values.
+\* ------------------------------------------------------------------------- */
+typedef struct TIME_NS_S TIME_NS;
+struct TIME_NS_S
+{
+   time64_t sec;  /* seconds since 1/1/1970 UTC */
+   int32_t  nsec; /* nanoseconds of the second 0 .. 999999999 */
+};
+
+/* ------------------------------------------------------------------------- *\
+   make_time_ns stores t seconds and nsec nanoseconds with the nanoseconds
+   normalized by a floor division in pts, e.g. make_time_ns(&ts, 0, ns)
+   converts a nanosecond time. It returns nonzero in success case and sets
+   errno to EOVERFLOW if the time is out of the range of TIME_NS.
+   ns_of_time_ns returns the nanosecond time as join_time_ns does.
+\* ------------------------------------------------------------------------- */
+int make_time_ns(TIME_NS * pts, time64_t t, int64_t nsec);
+
+int64_t ns_of_time_ns(const TIME_NS * pts);
+
+/* ------------------------------------------------------------------------- *\
+   compare_time_ns returns -1, 0 or 1 if the time of pts1 is before, equal
+   to or after the one of pts2.
+\* ------------------------------------------------------------------------- */
+int compare_time_ns(const TIME_NS * pts1, const TIME_NS * pts2);
+
+/* ------------------------------------------------------------------------- *\
+   add_time_ns stores the time of pts plus the duration of pdur in presult.
+   sub_time_ns stores the duration from the time of pts2 until the one of
+   pts1 in presult. They return nonzero in success case and set errno to
+   EINVAL for unnormalized arguments or to EOVERFLOW if the result is out
+   of the range of TIME_NS.
+\* ------------------------------------------------------------------------- */
+int add_time_ns(TIME_NS * presult, const TIME_NS * pts, const TIME_NS * pdur);
+
+int sub_time_ns(TIME_NS * presult, const TIME_NS * pts1, const TIME_NS * pts2);
+
+/* ------------------------------------------------------------------------- *\
+   format_time_ns_of_zone writes a wide-range time as format_time_of_zone_ns
+   does. Years before 0 and after 9999 are written with a sign and at least
+   4 digits as the expanded representation of ISO 8601, e.g. -0001 for
+   2 BC or +12024. It fails with EOVERFLOW if the year is out of the range
+   of an int.
+\* ------------------------------------------------------------------------- */
+size_t format_time_ns_of_zone(const TIME_NS * pts, int digits, char * buf, size_t size, const TIME_ZONE_INFO * ptzi);
+
+
+/* ------------------------------------------------------------------------- *\
+   localtime_of_zones converts the time t into the local times of count time
+   zones of the array pzones as localtime_of_zone does for each of them.
+   A zone of NULL means UTC as new_gmtime_r does. The broken-down times are
+   stored in the array ptm, the offsets to UTC in seconds in the array
+   poffset and the daylight saving flags in the array pisdst. Each of the
+   arrays may be NULL if it isn't required. The work that doesn't depend on
+   the zone is done only once. Bit (i % 8) of perr[i / 8] is set if the
+   local year of the zone i is out of the range of an int and cleared
+   otherwise. perr may be NULL. errno is not changed. The function returns
+   the number of the invalid elements.
+\* ------------------------------------------------------------------------- */
+size_t localtime_of_zones(time64_t t, const TIME_ZONE_INFO * const * pzones, size_t count, struct tm * ptm, int32_t * poffset, int32_t * pisdst, uint8_t * perr);
+
+
+/* ------------------------------------------------------------------------- *\
+   convert_time_of_zone converts the local time of ptm in the zone pfrom
+   into the local time of the same instant in the zone pto and stores it in
+   presult as localtime_of_zone does. The offset of the source time is
+   resolved by the policy as add_time_of_zone does it and tm_isdst of ptm
+   is ignored. The UTC time is stored in pt if it isn't NULL. A zone of
+   NULL means UTC. The members of ptm need to be in their normal ranges
+   without leap seconds. The function returns TIME_LOCAL_UNIQUE,
+   TIME_LOCAL_SKIPPED or TIME_LOCAL_REPEATED for the source time in success
+   case. It returns -1 and sets errno to EINVAL for invalid arguments, to
+   ERANGE if the policy TIME_LOCAL_REJECT rejected the source time and to
+   EOVERFLOW if the year of the result is out of the range of an int.
+\* ------------------------------------------------------------------------- */
+int convert_time_of_zone(const struct tm * ptm, const TIME_ZONE_INFO * pfrom, int policy, struct tm * presult, const TIME_ZONE_INFO * pto, time64_t * pt);
+
+/* ------------------------------------------------------------------------- *\
+   convert_columns_of_zone converts count local times of the columns of
+   pcols in the zone pfrom into the columns of presult in the zone pto as
+   convert_time_of_zone does. The columns year, mon and mday are required,
+   missing hour, min or sec columns are meaning 0. Only the result columns
+   that aren't NULL are filled. The kind of each source time is stored in
+   the array pkind if it isn't NULL, -1 for invalid fields. Bit (i % 8) of
+   perr[i / 8] is set if the element i is invalid, rejected or if its year
+   is out of the range of an int32_t and cleared otherwise. perr may be
+   NULL. errno is not changed. The function returns the number of the
+   invalid elements.
+\* ------------------------------------------------------------------------- */
+size_t convert_columns_of_zone(const TIME_COLUMNS * pcols, size_t count, const TIME_ZONE_INFO * pfrom, int policy, const TIME_COLUMNS * presult, const TIME_ZONE_INFO * pto, int8_t * pkind, uint8_t * perr);
+
+
+/* ------------------------------------------------------------------------- *\
+   TIME_POOL is a fixed pool of worker threads for converting very large
+   arrays in parallel. The workers are compiled in only if time_api.c is
+   compiled with TIME_API_ENABLE_THREADS defined, POSIX systems need to be
+   linked with -pthread then. Otherwise a pool has no workers and the
+   functions convert in the calling thread.
+
+   create_time_pool creates a pool for threads threads including the
+   calling one. A value of 0 or less means the number of the processors.
+   It returns NULL and sets errno to ENOMEM if the pool can't be allocated.
+   get_time_pool_threads returns the number of threads that convert the
+   arrays of a pool including the calling one. destroy_time_pool
+   terminates the workers and releases the pool.
+\* ------------------------------------------------------------------------- */
+typedef struct TIME_POOL_S TIME_POOL;
+
+TIME_POOL * create_time_pool(int threads);
+
+int get_time_pool_threads(const TIME_POOL * pool);
+
+void destroy_time_pool(TIME_POOL * pool);
+
+/* ------------------------------------------------------------------------- *\
+   The batch functions with the _mt suffix convert as the ones without it
+   but split arrays of more than 4096 elements into chunks that the threads
+   of the pool convert. The calling thread converts chunks as well and
+   returns after all of them are converted. If the pool is NULL or busy
+   with the arrays of another thread the calling thread converts alone.
+\* ------------------------------------------------------------------------- */
+size_t new_timegm_array_mt(TIME_POOL * pool, const struct tm * ptm, time64_t * pt, uint8_t * perr, size_t count);
+
+size_t mktime_of_zone_array_mt(TIME_POOL * pool, const struct tm * ptm, time64_t * pt, uint8_t * perr, size_t count, const TIME_ZONE_INFO * ptzi);
+
+size_t localtime_columns_of_zone_mt(TIME_POOL * pool, const time64_t * pt, size_t count, const TIME_COLUMNS * pcols, uint8_t * perr, const TIME_ZONE_INFO * ptzi);
+
+size_t mktime_columns_of_zone_mt(TIME_POOL * pool, const TIME_COLUMNS * pcols, size_t count, time64_t * pt, uint8_t * perr, const TIME_ZONE_INFO * ptzi);
+
+
+/* ------------------------------------------------------------------------- *\
+   localtime_columns_of_zone_ids converts count times of the array pt into
+   the columns of pcols as localtime_of_zone does, each element i in the
+   zone pzones[pzone_ids[i]] of the registry pzones of zone_count compiled
+   zones. The elements are grouped by their zones internally, so the rules
+   of a zone stay in the cache while its elements are converted. Only the
+   columns that aren't NULL are filled. Bit (i % 8) of perr[i / 8] is set if
+   the zone id of the element i is out of the range of the registry or its
+   year is out of the range of an int32_t and cleared otherwise. The
+   columns of elements with invalid zone ids are unchanged. perr may be
+   NULL. errno is not changed. The function returns the number of the
+   invalid elements.
+\* ------------------------------------------------------------------------- */
+size_t localtime_columns_of_zone_ids(const time64_t * pt, const uint16_t * pzone_ids, size_t count, const TIME_ZONE_INFO * pzones, size_t zone_count,
+                                     const TIME_COLUMNS * pcols, uint8_t * perr);
+
+
+/* ------------------------------------------------------------------------- *\
+   parse_time_of_zone_ns parses a time "YYYY-MM-DDThh:mm:ss" at the begin of
+   the len characters of str with an optional fraction of up to 9 digits
+   after a '.' or ',' and an optional offset "Z", "+hh:mm", "+hhmm" or
+   "+hh". The 'T' may be a 't' or a space as well and further fractional
+   digits are truncated. A time without an offset is a local time of the
+   zone of ptzi that is resolved by TIME_LOCAL_COMPATIBLE. ptzi may be NULL
+   for UTC. A leap second 60 is the first second of the next minute.
+   The function stores the nanosecond time in pns and returns the number of
+   the parsed characters in success case. It returns 0 and sets errno to
+   EINVAL if str doesn't start with a valid time and to EOVERFLOW if the
+   time is out of the range of a nanosecond time.
+\* ------------------------------------------------------------------------- */
+size_t parse_time_of_zone_ns(const char * str, size_t len, int64_t * pns, const TIME_ZONE_INFO * ptzi);
+
+/* ------------------------------------------------------------------------- *\
+   parse_times_of_layout parses count UTC times of the fixed layout, e.g.
+   "YYYY-MM-DDThh:mm:ss.fffZ" or "YYYYMMDDhhmmss". YYYY, MM, DD, hh, mm and
+   ss are the digits of the fields and 1 to 9 f the fractional digits of
+   the seconds. Any other character is a separator that needs to match.
+   The year, month and day are required. The layout may have up to
+   TIME_LAYOUT_MAX characters. The element i starts at pstr + i * stride
+   and needs to provide the length of the layout, it doesn't need to be
+   terminated. The times are stored in pt and the nanoseconds in pnsec if
+   pnsec isn't NULL. Bit (i % 8) of perr[i / 8] is set if the element i is
+   invalid and its result is -1 and it is cleared otherwise. perr may be
+   NULL. errno is not changed. The function returns the number of the
+   invalid elements or count if the layout is invalid.
+   The characters are checked by SSE2 vectors of 16 characters if the
+   compiler supports it.
+\* ------------------------------------------------------------------------- */
+#define TIME_LAYOUT_MAX  32
+
+size_t parse_times_of_layout(const char * layout, const char * pstr, size_t stride, size_t count, time64_t * pt, int32_t * pnsec, uint8_t * perr);
+
+
+/* ------------------------------------------------------------------------- *\
+   format_http_date writes the time t as HTTP-date in the IMF-fixdate format
+   of RFC 9110, e.g. "Sun, 06 Nov 1994 08:49:37 GMT", with a terminating 0
+   into buf. It keeps the text of the last formatted second of each thread,
+   so further calls of the same second copy it and calls of the same day
+   write the time of the day only. The function returns the length of the
+   text or 0 in error case and sets errno to EINVAL for a NULL buf, to
+   ERANGE if size is smaller than TIME_HTTP_DATE_SIZE and to EOVERFLOW if
+   the year is out of the range 0 until 9999.
+\* ------------------------------------------------------------------------- */
+#define TIME_HTTP_DATE_SIZE  30
+
+size_t format_http_date(time64_t t, char * buf, size_t size);
+
+/* ------------------------------------------------------------------------- *\
+   parse_http_date parses an HTTP-date at the begin of the len characters of
+   str in the IMF-fixdate format or in the obsolete RFC 850 or asctime
+   formats, e.g. "Sunday, 06-Nov-94 08:49:37 GMT" or
+   "Sun Nov  6 08:49:37 1994". The names are case-sensitive as required by
+   RFC 9110 and the day of the week isn't checked against the date. A two
+   digit year of RFC 850 that is more than 50 years in the future is one of
+   the past century. The function stores the time in pt and returns the
+   number of the parsed characters in success case or 0 and sets errno to
+   EINVAL if str doesn't start with a valid HTTP-date.
+\* ------------------------------------------------------------------------- */
+size_t parse_http_date(const char * str, size_t len, time64_t * pt);
+
+
+/* ------------------------------------------------------------------------- *\
+   Parsers of the timestamps of log files. They parse a timestamp at the
+   begin of the len characters of str, store the time in pt and the
+   nanoseconds in pnsec if pnsec isn't NULL and return the number of the
+   parsed characters in success case. They return 0 and set errno to EINVAL
+   if str doesn't start with a valid timestamp and to EOVERFLOW if the time
+   is out of the range of the result.
+
+   parse_syslog_time parses the local time of a BSD syslog message
+   "Oct 17 04:01:02" or "Oct  7 04:01:02" with an optional fraction of the
+   seconds of the zone of ptzi as mktime_of_zone does. ptzi may be NULL for
+   UTC. The year is the latest one of the year of the reference time, e.g.
+   the time of the receipt, the year before and the year after, for which
+   the time is at most a week after the reference. So December messages
+   that are read in January are ones of the previous year and January
+   messages of clocks that are ahead are ones of the next year.
+
+   parse_clf_time parses a time of the Common Log Format of Apache or nginx
+   "[10/Oct/2000:13:55:36 -0700]". The brackets are optional.
+
+   parse_journal_time parses the microseconds since 1970 of journald, e.g.
+   the value of __REALTIME_TIMESTAMP.
+\* ------------------------------------------------------------------------- */
+size_t parse_syslog_time(const char * str, size_t len, time64_t reference, time64_t * pt, int32_t * pnsec, const TIME_ZONE_INFO * ptzi);
+
+size_t parse_clf_time(const char * str, size_t len, time64_t * pt, int32_t * pnsec);
+
+size_t parse_journal_time(const char * str, size_t len, time64_t * pt, int32_t * pnsec);
+
+
+/* ------------------------------------------------------------------------- *\
+   TIME_ZONE_CACHE keeps the compiled zones of time zone names, so repeated
+   names don't need read_TZ again. A cache isn't thread safe, every thread
+   needs its own one.
+
+   create_time_zone_cache creates a cache for capacity names, 0 means 64.
+   The cache grows for more known zones, while unknown names are kept only
+   up to the capacity. pfn_lookup returns the TZ value of a name or NULL if
+   it is unknown, e.g. pc_find_TZ of tz_value.c. The function returns NULL
+   and sets errno to EINVAL for a missing lookup or to ENOMEM if the cache
+   can't be allocated. destroy_time_zone_cache releases a cache.
+
+   get_cached_zone returns the compiled zone of the name of len characters
+   that doesn't need to be terminated. Names of fixed offsets "+hh:mm" and
+   "-hh:mm" are compiled without the lookup. The zone is valid and
+   unchanged until the cache is destroyed. The function returns NULL and
+   sets errno to EINVAL if the name is unknown or longer than
+   TIME_ZONE_NAME_MAX - 1 and to ENOMEM if the cache can't grow.
+\* ------------------------------------------------------------------------- */
+#define TIME_ZONE_NAME_MAX  64
+
+typedef const char * (* TIME_ZONE_LOOKUP) (const char * name); /* returns the TZ value of a time zone name */
+
+typedef struct TIME_ZONE_CACHE_S TIME_ZONE_CACHE;
+
+TIME_ZONE_CACHE * create_time_zone_cache(size_t capacity, TIME_ZONE_LOOKUP pfn_lookup);
+
+void destroy_time_zone_cache(TIME_ZONE_CACHE * pcache);
+
+const TIME_ZONE_INFO * get_cached_zone(TIME_ZONE_CACHE * pcache, const char * name, size_t len);
+
+/* ------------------------------------------------------------------------- *\
+   parse_zoned_time_ns parses a time as parse_time_of_zone_ns does with an
+   optional time zone name as RFC 9557 suffix in brackets, e.g.
+   "2026-10-17T04:01:02+02:00[Europe/Paris]", or after a space, e.g.
+   "2026-10-17T04:01:02 Europe/Paris". The zones are taken from pcache.
+   A critical suffix "[!Europe/Paris]" is the same as a normal one and any
+   other suffixes with a key are ignored unless they are critical ones of
+   another calendar than "u-ca=iso8601" or "u-ca=gregory". A word after a
+   space is a zone name only if it contains a '/' or is "UTC" and if it is
+   a known zone, any other word isn't part of the time.
+   A time without an offset is a local time of the named zone or of ptzi
+   if there is no zone name. ptzi may be NULL for UTC. A numeric offset
+   needs to be the one of the named zone at that time, while "Z" is an
+   offset of the zone that isn't known as RFC 9557 defines it.
+   The function stores the nanosecond time in pns and the named zone or
+   NULL in ppzone if ppzone isn't NULL and returns the number of the parsed
+   characters in success case. It returns 0 and sets errno to EINVAL if str
+   doesn't start with a valid time, if a zone in brackets is unknown or if
+   the offset doesn't match the zone and to EOVERFLOW if the time is out of
+   the range of a nanosecond time.
+\* ------------------------------------------------------------------------- */
+size_t parse_zoned_time_ns(const char * str, size_t len, int64_t * pns, const TIME_ZONE_INFO * ptzi, TIME_ZONE_CACHE * pcache, const TIME_ZONE_INFO ** ppzone);
+
+
+/* ------------------------------------------------------------------------- *\
+   ISO 8601 week dates "YYYY-Www-d" of local times. The weeks start at
+   Monday and the first week of a year is the one with its first Thursday,
+   so the week-numbering year differs from the calendar year for some days
+   around New Year, e.g. Sunday 1/3/2021 is 2020-W53-7. A ptzi of NULL means
+   UTC. The dates are calculated from the local days directly without a
+   struct tm and without any lock.
+\* ------------------------------------------------------------------------- */
+typedef struct TIME_WEEK_DATE_S TIME_WEEK_DATE;
+struct TIME_WEEK_DATE_S
+{
+   int32_t year; /* week-numbering year */
+   int32_t week; /* week of the year 1 .. 53 */
+   int32_t wday; /* day of the week 1 = Monday .. 7 = Sunday */
+};
+
+/* ------------------------------------------------------------------------- *\
+   week_date_of_zone stores the week date of the time t in the time zone of
+   ptzi in pdate. It returns nonzero in success case. It returns 0 and sets
+   errno to EINVAL if pdate is NULL and to EOVERFLOW if the year is out of
+   the range of an int32_t.
+\* ------------------------------------------------------------------------- */
+int week_date_of_zone(time64_t t, TIME_WEEK_DATE * pdate, const TIME_ZONE_INFO * ptzi);
+
+/* ------------------------------------------------------------------------- *\
+   week_date_array_of_zone converts count times of the array pt into the
+   week-numbering years, the weeks and the days of the week of the arrays
+   pyear, pweek and pwday as week_date_of_zone does. Each of the arrays may
+   be NULL if it isn't required. The offset interval and the week of the
+   last element are reused, so sorted times are cheapest. Bit (i % 8) of
+   perr[i / 8] is set if the year of the element i is out of the range of
+   an int32_t and cleared otherwise. perr may be NULL. errno is not changed.
+   The function returns the number of the invalid elements.
+\* ------------------------------------------------------------------------- */
+size_t week_date_array_of_zone(const time64_t * pt, size_t count, int32_t * pyear, int8_t * pweek, int8_t * pwday, uint8_t * perr, const TIME_ZONE_INFO * ptzi);
+
+/* ------------------------------------------------------------------------- *\
+   format_week_date_of_zone writes the week date of the time t in the time
+   zone of ptzi into buf, e.g. 2026-W42-6. Years before 0 or after 9999 are
+   written with a sign and at least 4 digits as format_time_of_zone_ns does.
+   The function returns the length of the string without the terminating
+   zero. It returns 0 and sets errno to EINVAL for invalid arguments, to
+   ERANGE if size is too small and to EOVERFLOW if the year is out of the
+   range of an int32_t. TIME_WEEK_DATE_SIZE is always sufficient.
+\* ------------------------------------------------------------------------- */
+#define TIME_WEEK_DATE_SIZE  20
+
+size_t format_week_date_of_zone(time64_t t, char * buf, size_t size, const TIME_ZONE_INFO * ptzi);
+
+
 /* ------------------------------------------------------------------------- *\
    localtime_of_zone is just multithreading safe version of localtime
    according to the time zone and daylight saving rules that are given
@@ -324,6 +993,49 @@ void init_time_api_lock(TIME_API_LOCK pfn_lock,     /* pointer to a user provide
                         TIME_API_LOCK pfn_unlock,   /* pointer to a user provided mutex unlock callback function */
                         void *        pv_context);  /* user provided context, e.g. pointer to the mutex. */
 
+/* ------------------------------------------------------------------------- *\
+   Optional runtime statistics of the time API for finding out how often the
+   library reads the file system or takes locks. The counters are compiled
+   in only if time_api.c is compiled with TIME_API_ENABLE_STATS defined.
+   They are counted per thread without any locks or atomic operations and
+   get_time_api_stats sums up the counters of all threads that ever called a
+   function of the time API. The numbers of threads that are still running
+   may be slightly behind in that sum. The calls of the conversion functions
+   include their internal calls by other functions of the API, e.g. the ones
+   of new_gmtime_r by localtime_of_zone.
+   get_time_api_stats returns nonzero if the statistics are compiled in and
+   zero with all counters set to 0 otherwise.
+\* ------------------------------------------------------------------------- */
+typedef struct TIME_API_STATS_S TIME_API_STATS;
+struct TIME_API_STATS_S
+{
+   uint64_t calls_new_gmtime_r;            /* calls of new_gmtime_r */
+   uint64_t calls_new_timegm;              /* calls of new_timegm */
+   uint64_t calls_std_timegm;              /* calls of std_timegm */
+   uint64_t calls_new_localtime_r;         /* calls of new_localtime_r */
+   uint64_t calls_new_mktime;              /* calls of new_mktime */
+   uint64_t calls_std_mktime;              /* calls of std_mktime */
+   uint64_t calls_localtime_of_zone;       /* calls of localtime_of_zone */
+   uint64_t calls_mktime_of_zone;          /* calls of mktime_of_zone */
+   uint64_t calls_read_TZ;                 /* calls of read_TZ */
+   uint64_t calls_update_time_zone_info;   /* calls of update_time_zone_info */
+   uint64_t calls_get_local_zone_info;     /* calls of get_local_zone_info */
+
+   uint64_t tz_reloads;                    /* update_time_zone_info reloaded the time zone information */
+   uint64_t tz_unchanged;                  /* update_time_zone_info found TZ unchanged */
+   uint64_t zone_file_reads;               /* reads of /etc/localtime or of the time zone database */
+   uint64_t lock_acquisitions;             /* calls of the lock callback of init_time_api_lock */
+   uint64_t cache_hits;                    /* cached time zone information was used */
+   uint64_t cache_misses;                  /* time zone information had to be initialized before usage */
+
+   uint64_t errors_einval;                 /* errno set to EINVAL */
+   uint64_t errors_erange;                 /* errno set to ERANGE */
+   uint64_t errors_eoverflow;              /* errno set to EOVERFLOW */
+   uint64_t errors_other;                  /* errno set to any other value */
+};
+
+int get_time_api_stats(TIME_API_STATS * pstats);
+
 #ifdef __cplusplus
 }/* extern "C" */
 #endif
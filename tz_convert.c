@@ -0,0 +1,835 @@
+/*****************************************************************************\
+*                                                                             *
+*  FILENAME:     tz_convert.c                                                 *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  DESCRIPTION:  conversion of the timestamps of text files                   *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  COPYRIGHT:    (c) 2026 Dipl.-Ing. Klaus Lux (Aachen, Germany)              *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  ORIGIN:       https://github.com/klux21/limitless_times                    *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+* Civil Usage Public License, Version 1.2, June 2026                          *
+*                                                                             *
+* Redistribution and use in source and binary forms, with or without          *
+* modification, are permitted provided that the following conditions are met: *
+*                                                                             *
+* 1. Redistributions of source code must retain the above copyright           *
+*    notice, this list of conditions, the explanation of terms                *
+*    and the following disclaimer.                                            *
+*                                                                             *
+* 2. Redistributions in binary form must reproduce the above copyright        *
+*    notice, this list of conditions and the following disclaimer in the      *
+*    documentation or other materials provided with the distribution.         *
+*                                                                             *
+* 3. All modified files must carry prominent notices stating that the         *
+*    files have been changed.                                                 *
+*                                                                             *
+* 4. The source code and binary forms and any derivative works are not        *
+*    stored or executed in systems or devices which are designed or           *
+*    intended to harm, to kill or to forcibly immobilize people.              *
+*                                                                             *
+* 5. The source code and binary forms and any derivative works are not        *
+*    stored or executed in systems or devices which are intended to           *
+*    monitor, to track, to change or to control the behavior, the             *
+*    constitution, the location or the communication of any people or         *
+*    their property without the explicit and prior agreement of those         *
+*    people except those devices and systems are solely designed for          *
+*    saving or protecting peoples life or health.                             *
+*                                                                             *
+* 6. The source code and binary forms and any derivative works are not        *
+*    stored or executed in any systems or devices that are intended           *
+*    for the production of any of the systems or devices that                 *
+*    have been stated before except the ones for saving or protecting         *
+*    peoples life or health only.                                             *
+*                                                                             *
+* The term 'systems' in all clauses shall include all types and combinations  *
+* of physical, virtualized or simulated hardware and software and any kind    *
+* of data storage.                                                            *
+*                                                                             *
+* The term 'devices' shall include any kind of local or non-local control     *
+* system of the stated devices as part of that device as well. Any assembly   *
+* of more than one device is one and the same device regarding this license.  *
+*                                                                             *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" *
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE   *
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE  *
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE   *
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR         *
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF        *
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    *
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     *
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)     *
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE  *
+* POSSIBILITY OF SUCH DAMAGE.                                                 *
+*                                                                             *
+\*****************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stddef.h>
+#include <time.h>      /* struct tm */
+#include <sys/types.h>
+
+#ifdef _WIN32
+#include <io.h>        /* _setmode */
+#include <fcntl.h>     /* _O_BINARY */
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#define CONVERT_MMAP 1 /* regular files are mapped into the memory */
+#endif
+
+#include <time_api.h>
+#include <tz_value.h>
+
+
+#define CONVERT_READ_SIZE   0x100000 /* size of the reads of stdin and of files that aren't mapped */
+#define CONVERT_WRITE_SIZE  0x100000 /* size of the buffered writes */
+#define CONVERT_LINE_SPACE  256      /* space that the output of a single timestamp may need at most */
+
+/* formats of the converted timestamps */
+#define FORMAT_ISO       0 /* RFC 3339 local time of the target zone */
+#define FORMAT_EPOCH     1 /* seconds since 1970 */
+#define FORMAT_EPOCH_MS  2 /* milliseconds since 1970 */
+#define FORMAT_EPOCH_US  3 /* microseconds since 1970 */
+#define FORMAT_EPOCH_NS  4 /* nanoseconds since 1970 */
+
+
+/* ------------------------------------------------------------------------- *\
+   CONVERT_CONTEXT contains the settings and the output buffer of the
+   conversion and the cached text of the last formatted second. Log files
+   contain many timestamps of the same second usually and those need to
+   write the fraction only.
+\* ------------------------------------------------------------------------- */
+
+typedef struct CONVERT_CONTEXT_S CONVERT_CONTEXT;
+struct CONVERT_CONTEXT_S
+{
+   const TIME_ZONE_INFO * pfrom;       /* zone of ISO times without an offset, NULL for UTC */
+   const TIME_ZONE_INFO * pto;         /* target zone, NULL for UTC */
+   int                    format;      /* FORMAT_ISO ... FORMAT_EPOCH_NS */
+   int                    digits;      /* fractional digits of FORMAT_ISO or -1 for the ones of the input */
+   int                    column;      /* 1 based whitespace separated column of the timestamps or 0 */
+   const char *           marker;      /* text in front of the timestamps or NULL */
+   size_t                 marker_len;  /* length of marker */
+
+   char *                 out;         /* output buffer of CONVERT_WRITE_SIZE bytes */
+   size_t                 out_len;     /* used bytes of the output buffer */
+   int                    write_error; /* nonzero after a failed write */
+
+   int                    cached;      /* nonzero if the cached second is valid */
+   time64_t               cached_sec;  /* the last formatted second */
+   char                   cached_prefix[24]; /* "YYYY-MM-DDThh:mm:ss" of cached_sec */
+   char                   cached_suffix[16]; /* offset of cached_sec, e.g. "Z" or "+01:00" */
+   size_t                 suffix_len;  /* length of cached_suffix */
+
+   uint64_t               lines;       /* lines that were read */
+   uint64_t               converted;   /* timestamps that were converted */
+};
+
+
+/* ------------------------------------------------------------------------- *\
+   flush_output writes the output buffer to stdout.
+\* ------------------------------------------------------------------------- */
+
+static void flush_output(CONVERT_CONTEXT * pctx)
+{
+   if(pctx->out_len && !pctx->write_error && (fwrite(pctx->out, 1, pctx->out_len, stdout) != pctx->out_len))
+   {
+      fprintf(stderr, "Writing the output has failed! (errno=%d)\n", errno);
+      pctx->write_error = 1;
+   }
+
+   pctx->out_len = 0;
+} /* static void flush_output(CONVERT_CONTEXT * pctx) */
+
+
+/* ------------------------------------------------------------------------- *\
+   put_output appends len bytes of data to the output buffer. Larger blocks
+   than the buffer are written directly.
+\* ------------------------------------------------------------------------- */
+
+static void put_output(CONVERT_CONTEXT * pctx, const char * data, size_t len)
+{
+   if(pctx->out_len + len > CONVERT_WRITE_SIZE)
+   {
+      flush_output(pctx);
+
+      if(len > CONVERT_WRITE_SIZE - CONVERT_LINE_SPACE)
+      {
+         if(!pctx->write_error && (fwrite(data, 1, len, stdout) != len))
+         {
+            fprintf(stderr, "Writing the output has failed! (errno=%d)\n", errno);
+            pctx->write_error = 1;
+         }
+         return;
+      }
+   }
+
+   memcpy(pctx->out + pctx->out_len, data, len);
+   pctx->out_len += len;
+} /* static void put_output(CONVERT_CONTEXT * pctx, const char * data, size_t len) */
+
+
+/* ------------------------------------------------------------------------- *\
+   parse_epoch parses an epoch time of 10, 13, 16 or 19 digits as seconds,
+   milliseconds, microseconds or nanoseconds since 1970. Seconds may have a
+   fraction. It returns the length of the timestamp and stores the
+   nanosecond time in pns and the count of its fractional digits in pdigits
+   or returns 0 if p doesn't start with an epoch time.
+\* ------------------------------------------------------------------------- */
+
+static size_t parse_epoch(const char * p, const char * pend, int64_t * pns, int * pdigits)
+{
+   const char * pstart = p;
+   uint64_t     value  = 0;
+   int32_t      nsec   = 0;
+   int          count;
+   int          digits = 0;
+   int64_t      ns;
+   int          err;
+
+   for(count = 0; (p < pend) && ((uint32_t) (*p - '0') <= 9); ++p, ++count)
+   {
+      if(count < 19)
+         value = (value * 10) + (uint64_t) (*p - '0');
+   }
+
+   if(count == 10)
+   {
+      if((p + 1 < pend) && (*p == '.') && ((uint32_t) (p[1] - '0') <= 9))
+      { /* seconds with a fraction, further digits than the nanoseconds are truncated */
+         for(++p; (p < pend) && ((uint32_t) (*p - '0') <= 9); ++p, ++digits)
+         {
+            if(digits < 9)
+               nsec = (nsec * 10) + (*p - '0');
+         }
+
+         if(digits > 9)
+            digits = 9;
+
+         for(count = digits; count < 9; ++count)
+            nsec *= 10;
+      }
+   }
+   else if(count == 13)
+   {
+      nsec   = (int32_t) (value % 1000) * 1000000;
+      value /= 1000;
+      digits = 3;
+   }
+   else if(count == 16)
+   {
+      nsec   = (int32_t) (value % 1000000) * 1000;
+      value /= 1000000;
+      digits = 6;
+   }
+   else if(count == 19)
+   {
+      nsec   = (int32_t) (value % 1000000000);
+      value /= 1000000000;
+      digits = 9;
+   }
+   else
+      return (0);
+
+   /* a timestamp is a word of its own */
+   if((p < pend) && (((uint32_t) (*p - '0') <= 9) || ((uint32_t) ((*p | 0x20) - 'a') < 26) || (*p == '_')))
+      return (0);
+
+   err   = errno;
+   errno = 0;
+   ns    = join_time_ns((time64_t) value, nsec);
+
+   if((ns == -1) && errno)
+   {
+      errno = err;
+      return (0);
+   }
+
+   errno    = err;
+   *pns     = ns;
+   *pdigits = digits;
+   return ((size_t) (p - pstart));
+} /* static size_t parse_epoch(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   parse_timestamp parses an ISO time or an epoch time at p and returns its
+   length or 0 if there is none.
+\* ------------------------------------------------------------------------- */
+
+static size_t parse_timestamp(const CONVERT_CONTEXT * pctx, const char * p, const char * pend, int64_t * pns, int * pdigits)
+{
+   size_t len;
+   int    err;
+
+   if((pend - p < 10) || ((uint32_t) (*p - '0') > 9))
+      return (0);
+
+   if(p[4] != '-')
+      return (parse_epoch(p, pend, pns, pdigits));
+
+   err = errno;
+   len = parse_time_of_zone_ns(p, (size_t) (pend - p), pns, pctx->pfrom);
+   errno = err;
+
+   if(len)
+   { /* the count of the fractional digits */
+      const char * pf = p + 19;
+
+      *pdigits = 0;
+
+      if((pf < p + len) && ((*pf == '.') || (*pf == ',')))
+      {
+         for(++pf; (pf < p + len) && ((uint32_t) (*pf - '0') <= 9); ++pf)
+            ++*pdigits;
+
+         if(*pdigits > 9)
+            *pdigits = 9;
+      }
+   }
+
+   return (len);
+} /* static size_t parse_timestamp(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   put_fraction writes '.' and the first digits digits of nsec at p and
+   returns the pointer behind them.
+\* ------------------------------------------------------------------------- */
+
+static char * put_fraction(char * p, int32_t nsec, int digits)
+{
+   int i;
+
+   if(digits > 0)
+   {
+      *p++ = '.';
+
+      for(i = digits; i < 9; ++i)
+         nsec /= 10;
+
+      for(i = digits; i > 0; --i)
+      {
+         p[i - 1] = (char) ('0' + nsec % 10);
+         nsec /= 10;
+      }
+
+      p += digits;
+   }
+
+   return (p);
+} /* static char * put_fraction(char * p, int32_t nsec, int digits) */
+
+
+/* ------------------------------------------------------------------------- *\
+   put_timestamp appends the converted nanosecond time ns to the output
+   buffer. The seconds of ISO times are formatted once only and the cached
+   text is reused by the following timestamps of the same second.
+\* ------------------------------------------------------------------------- */
+
+static void put_timestamp(CONVERT_CONTEXT * pctx, int64_t ns, int input_digits)
+{
+   char     buf[TIME_FORMAT_NS_SIZE];
+   char *   p;
+   int32_t  nsec;
+   time64_t t = split_time_ns(ns, &nsec);
+   int      digits;
+   uint64_t value;
+   int      negative;
+
+   if(pctx->out_len + CONVERT_LINE_SPACE > CONVERT_WRITE_SIZE)
+      flush_output(pctx);
+
+   p = pctx->out + pctx->out_len;
+
+   if(pctx->format == FORMAT_ISO)
+   {
+      if(!pctx->cached || (t != pctx->cached_sec))
+      {
+         size_t len = format_time_of_zone_ns(ns - nsec, 0, buf, sizeof(buf), pctx->pto);
+
+         memcpy(pctx->cached_prefix, buf, 19);
+         pctx->suffix_len = len - 19;
+         memcpy(pctx->cached_suffix, buf + 19, pctx->suffix_len);
+         pctx->cached_sec = t;
+         pctx->cached     = 1;
+      }
+
+      digits = (pctx->digits < 0) ? input_digits : pctx->digits;
+
+      memcpy(p, pctx->cached_prefix, 19);
+      p = put_fraction(p + 19, nsec, digits);
+      memcpy(p, pctx->cached_suffix, pctx->suffix_len);
+      p += pctx->suffix_len;
+   }
+   else
+   { /* the epoch times are rounded down as the nanosecond times are split */
+      int64_t v = ns;
+
+      if(pctx->format == FORMAT_EPOCH)
+         v = t;
+      else if(pctx->format == FORMAT_EPOCH_MS)
+         v = ns / 1000000 - ((ns % 1000000) < 0);
+      else if(pctx->format == FORMAT_EPOCH_US)
+         v = ns / 1000 - ((ns % 1000) < 0);
+
+      negative = (v < 0);
+      value    = negative ? (uint64_t) 0 - (uint64_t) v : (uint64_t) v;
+
+      digits = 0;
+      do
+      {
+         buf[digits++] = (char) ('0' + value % 10);
+         value /= 10;
+      }
+      while(value);
+
+      if(negative)
+         *p++ = '-';
+
+      while(digits)
+         *p++ = buf[--digits];
+   }
+
+   pctx->out_len = (size_t) (p - pctx->out);
+   ++pctx->converted;
+} /* static void put_timestamp(CONVERT_CONTEXT * pctx, int64_t ns, int input_digits) */
+
+
+/* ------------------------------------------------------------------------- *\
+   convert_line writes the line from p until pend including its line feed
+   with the converted timestamp. The timestamp is searched after the first
+   marker, at the begin of the column or as first word of the line that is
+   a timestamp. Lines without a timestamp are written unchanged.
+\* ------------------------------------------------------------------------- */
+
+static void convert_line(CONVERT_CONTEXT * pctx, const char * p, const char * pend)
+{
+   const char * pline = p;
+   const char * plast = pend;
+   size_t       len   = 0;
+   int64_t      ns;
+   int          digits;
+
+   ++pctx->lines;
+
+   if((plast > p) && (plast[-1] == '\n'))
+      --plast; /* the line feed is never part of a timestamp */
+
+   if(pctx->marker)
+   {
+      const char * pm = p;
+
+      for(;;)
+      {
+         pm = (const char *) memchr(pm, pctx->marker[0], (size_t) (plast - pm));
+
+         if(!pm || ((size_t) (plast - pm) < pctx->marker_len))
+         {
+            p = plast;
+            break;
+         }
+
+         if(!memcmp(pm, pctx->marker, pctx->marker_len))
+         {
+            p   = pm + pctx->marker_len;
+            len = parse_timestamp(pctx, p, plast, &ns, &digits);
+            break;
+         }
+
+         ++pm;
+      }
+   }
+   else if(pctx->column)
+   {
+      int column;
+
+      for(column = 1; ; ++column)
+      {
+         while((p < plast) && ((*p == ' ') || (*p == '\t')))
+            ++p;
+
+         if((column == pctx->column) || (p >= plast))
+            break;
+
+         while((p < plast) && (*p != ' ') && (*p != '\t'))
+            ++p;
+      }
+
+      len = parse_timestamp(pctx, p, plast, &ns, &digits);
+   }
+   else
+   {
+      for(; p < plast; ++p)
+      {
+         if(   ((uint32_t) (*p - '0') <= 9)
+            && ((p == pline) || (((uint32_t) (p[-1] - '0') > 9) && ((uint32_t) ((p[-1] | 0x20) - 'a') >= 26) && (p[-1] != '_')))
+            && ((len = parse_timestamp(pctx, p, plast, &ns, &digits)) != 0))
+            break;
+      }
+   }
+
+   if(!len)
+   {
+      put_output(pctx, pline, (size_t) (pend - pline));
+      return;
+   }
+
+   put_output(pctx, pline, (size_t) (p - pline));
+   put_timestamp(pctx, ns, digits);
+   put_output(pctx, p + len, (size_t) (pend - (p + len)));
+} /* static void convert_line(CONVERT_CONTEXT * pctx, const char * p, const char * pend) */
+
+
+/* ------------------------------------------------------------------------- *\
+   convert_data converts all lines of the len bytes of data. If last is zero
+   then the function leaves an incomplete line at the end of the data and
+   returns the number of the converted bytes.
+\* ------------------------------------------------------------------------- */
+
+static size_t convert_data(CONVERT_CONTEXT * pctx, const char * data, size_t len, int last)
+{
+   const char * p    = data;
+   const char * pend = data + len;
+   const char * peol;
+
+   while(p < pend)
+   {
+      peol = (const char *) memchr(p, '\n', (size_t) (pend - p));
+
+      if(!peol)
+      {
+         if(!last)
+            break;
+
+         peol = pend - 1;
+      }
+
+      convert_line(pctx, p, peol + 1);
+      p = peol + 1;
+   }
+
+   return ((size_t) (p - data));
+} /* static size_t convert_data(CONVERT_CONTEXT * pctx, const char * data, size_t len, int last) */
+
+
+/* ------------------------------------------------------------------------- *\
+   convert_stream converts the data of an open stream that is read in blocks
+   of CONVERT_READ_SIZE bytes. The buffer grows for longer lines.
+   It returns nonzero in success case.
+\* ------------------------------------------------------------------------- */
+
+static int convert_stream(CONVERT_CONTEXT * pctx, FILE * pf, const char * name)
+{
+   int    bRet = 0;
+   size_t size = 2 * CONVERT_READ_SIZE;
+   char * buf  = (char *) malloc(size);
+   size_t used = 0;
+   size_t got;
+   size_t done;
+
+   if(!buf)
+   {
+      fprintf(stderr, "Out of memory!\n");
+      goto Exit;
+   }
+
+   for(;;)
+   {
+      if(size - used < CONVERT_READ_SIZE)
+      { /* a line that is longer than the buffer */
+         char * pnew = (char *) realloc(buf, 2 * size);
+
+         if(!pnew)
+         {
+            fprintf(stderr, "Out of memory!\n");
+            goto Exit;
+         }
+
+         buf   = pnew;
+         size *= 2;
+      }
+
+      got = fread(buf + used, 1, size - used, pf);
+
+      if(!got)
+         break;
+
+      used += got;
+      done  = convert_data(pctx, buf, used, 0);
+      used -= done;
+
+      if(used)
+         memmove(buf, buf + done, used);
+   }
+
+   if(ferror(pf))
+   {
+      fprintf(stderr, "Reading %s has failed! (errno=%d)\n", name, errno);
+      goto Exit;
+   }
+
+   convert_data(pctx, buf, used, 1);
+   bRet = 1;
+
+   Exit:;
+   free(buf);
+   return (bRet);
+} /* static int convert_stream(CONVERT_CONTEXT * pctx, FILE * pf, const char * name) */
+
+
+/* ------------------------------------------------------------------------- *\
+   convert_file converts the file of name. Regular files are mapped into the
+   memory if possible and all others are read as stream.
+   It returns nonzero in success case.
+\* ------------------------------------------------------------------------- */
+
+static int convert_file(CONVERT_CONTEXT * pctx, const char * name)
+{
+   int    bRet = 0;
+   FILE * pf;
+
+#ifdef CONVERT_MMAP
+   int         fd = open(name, O_RDONLY);
+   struct stat st;
+
+   if(fd < 0)
+   {
+      fprintf(stderr, "Opening %s has failed! (errno=%d)\n", name, errno);
+      goto Exit;
+   }
+
+   if(!fstat(fd, &st) && S_ISREG(st.st_mode) && (st.st_size > 0) && ((uint64_t) st.st_size <= (size_t) -1))
+   {
+      void * pv = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+      if(pv != MAP_FAILED)
+      {
+#ifdef MADV_SEQUENTIAL
+         madvise(pv, (size_t) st.st_size, MADV_SEQUENTIAL);
+#endif
+         convert_data(pctx, (const char *) pv, (size_t) st.st_size, 1);
+         munmap(pv, (size_t) st.st_size);
+         close(fd);
+         bRet = 1;
+         goto Exit;
+      }
+   }
+
+   pf = fdopen(fd, "rb");
+   if(!pf)
+   {
+      close(fd);
+      fprintf(stderr, "Opening %s has failed! (errno=%d)\n", name, errno);
+      goto Exit;
+   }
+#else
+   pf = fopen(name, "rb");
+   if(!pf)
+   {
+      fprintf(stderr, "Opening %s has failed! (errno=%d)\n", name, errno);
+      goto Exit;
+   }
+#endif
+
+   bRet = convert_stream(pctx, pf, name);
+   fclose(pf);
+
+   Exit:;
+   return (bRet);
+} /* static int convert_file(CONVERT_CONTEXT * pctx, const char * name) */
+
+
+/* ------------------------------------------------------------------------- *\
+   read_zone reads the time zone of a location, a TZ value or "local".
+   The zone "UTC" is stored as NULL pointer, so its times end with a 'Z'.
+   It returns nonzero in success case.
+\* ------------------------------------------------------------------------- */
+
+static int read_zone(const char * name, TIME_ZONE_INFO * ptzi, const TIME_ZONE_INFO ** ppzone)
+{
+   const char * pTZ;
+
+   if(!strcmp(name, "UTC"))
+   {
+      *ppzone = NULL;
+      return (1);
+   }
+
+   *ppzone = ptzi;
+
+   if(!strcmp(name, "local"))
+      return (get_local_zone_info(ptzi));
+
+   pTZ = pc_find_TZ(name);
+   if(!pTZ)
+      pTZ = name;
+
+   return (read_TZ(ptzi, pTZ));
+} /* static int read_zone(const char * name, TIME_ZONE_INFO * ptzi, const TIME_ZONE_INFO ** ppzone) */
+
+
+/* ------------------------------------------------------------------------- *\
+   usage prints the options of the program.
+\* ------------------------------------------------------------------------- */
+
+static void usage()
+{
+   fprintf(stderr,
+           "Usage: tz_convert [options] [file ...]\n"
+           "Converts the timestamps of text files or of stdin into another time zone or format.\n"
+           "Timestamps are ISO times like 2024-03-31T02:30:00.123+01:00 or epoch times of\n"
+           "10, 13, 16 or 19 digits in seconds, milliseconds, microseconds or nanoseconds.\n"
+           "  -zone <zone>      target zone as location, TZ value, 'local' or 'UTC' (default)\n"
+           "  -from <zone>      zone of ISO times without an offset (default UTC)\n"
+           "  -format <format>  iso (default), epoch, epoch_ms, epoch_us or epoch_ns\n"
+           "  -digits <digits>  fractional digits of iso times (default as the input)\n"
+           "  -column <column>  1 based column of the timestamps separated by blanks or tabs\n"
+           "  -after <text>     the timestamps follow the first occurrence of this text\n"
+           "Without -column and -after the first timestamp of every line is converted.\n");
+} /* static void usage() */
+
+
+/* ========================================================================= *\
+   main function
+\* ========================================================================= */
+
+int main(int argc, char * argv[])
+{
+   int             iRet = 1;
+   CONVERT_CONTEXT ctx;
+   TIME_ZONE_INFO  from_zone;
+   TIME_ZONE_INFO  to_zone;
+   int             files = 0;
+   int             i;
+
+   memset(&ctx, 0, sizeof(ctx));
+   ctx.digits = -1;
+
+   for(i = 1; i < argc; ++i)
+   {
+      if((argv[i][0] != '-') || !argv[i][1])
+      {
+         ++files;
+      }
+      else if(!strcmp(argv[i], "-zone") && (i + 1 < argc))
+      {
+         if(!read_zone(argv[++i], &to_zone, &ctx.pto))
+         {
+            fprintf(stderr, "Invalid time zone '%s'!\n", argv[i]);
+            goto Exit;
+         }
+      }
+      else if(!strcmp(argv[i], "-from") && (i + 1 < argc))
+      {
+         if(!read_zone(argv[++i], &from_zone, &ctx.pfrom))
+         {
+            fprintf(stderr, "Invalid time zone '%s'!\n", argv[i]);
+            goto Exit;
+         }
+      }
+      else if(!strcmp(argv[i], "-format") && (i + 1 < argc))
+      {
+         static const char * const formats[] = { "iso", "epoch", "epoch_ms", "epoch_us", "epoch_ns", NULL };
+
+         ++i;
+         for(ctx.format = 0; formats[ctx.format] && strcmp(argv[i], formats[ctx.format]); ++ctx.format)
+            ;
+
+         if(!formats[ctx.format])
+         {
+            fprintf(stderr, "Invalid format '%s'!\n", argv[i]);
+            goto Exit;
+         }
+      }
+      else if(!strcmp(argv[i], "-digits") && (i + 1 < argc))
+      {
+         ctx.digits = atoi(argv[++i]);
+         if((ctx.digits < 0) || (ctx.digits > 9))
+         {
+            fprintf(stderr, "Invalid number of digits '%s'!\n", argv[i]);
+            goto Exit;
+         }
+      }
+      else if(!strcmp(argv[i], "-column") && (i + 1 < argc))
+      {
+         ctx.column = atoi(argv[++i]);
+         if(ctx.column < 1)
+         {
+            fprintf(stderr, "Invalid column '%s'!\n", argv[i]);
+            goto Exit;
+         }
+      }
+      else if(!strcmp(argv[i], "-after") && (i + 1 < argc) && argv[i + 1][0])
+      {
+         ctx.marker     = argv[++i];
+         ctx.marker_len = strlen(ctx.marker);
+      }
+      else
+      {
+         usage();
+         goto Exit;
+      }
+   }
+
+   ctx.out = (char *) malloc(CONVERT_WRITE_SIZE);
+   if(!ctx.out)
+   {
+      fprintf(stderr, "Out of memory!\n");
+      goto Exit;
+   }
+
+#ifdef _WIN32
+   _setmode(_fileno(stdin),  _O_BINARY);
+   _setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+   iRet = 0;
+
+   if(!files)
+   {
+      if(!convert_stream(&ctx, stdin, "stdin"))
+         iRet = 1;
+   }
+
+   for(i = 1; i < argc; ++i)
+   {
+      if((argv[i][0] != '-') || !argv[i][1])
+      {
+         if(!strcmp(argv[i], "-") ? !convert_stream(&ctx, stdin, "stdin") : !convert_file(&ctx, argv[i]))
+            iRet = 1;
+      }
+      else
+      {
+         ++i; /* the value of the option */
+      }
+   }
+
+   flush_output(&ctx);
+
+   if(ctx.write_error || fflush(stdout))
+      iRet = 1;
+
+   Exit:;
+   free(ctx.out);
+   return (iRet);
+} /* main() */
+
+/* ========================================================================= *\
+   E N D   O F   F I L E
+\* ========================================================================= */